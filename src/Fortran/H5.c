@@ -110,6 +110,29 @@ h5_setprop_file_corevfd (
         H5_API_RETURN ((h5_int64_t)h5_set_prop_file_core_vfd (prop, *increment));
 }
 
+#define h5_setprop_file_core_staging FC_GLOBAL (	\
+                h5_setprop_file_core_staging,		\
+                H5_SETPROP_FILE_CORE_STAGING)
+h5_int64_t
+h5_setprop_file_core_staging (
+        h5_int64_t* _prop,
+	h5_int64_t* increment,
+	h5_int64_t* mem_cap,
+	const char* _local_path,
+	const int _len_local_path
+        ) {
+        H5_API_ENTER (h5_int64_t,
+                      "prop=%lld, increment=%lld, mem_cap=%lld, local_path='%*s'",
+                      (long long int)*_prop, (long long int)*increment,
+		      (long long int)*mem_cap, _len_local_path, _local_path);
+        h5_prop_t prop = (h5_prop_t)*_prop;
+        char* local_path = h5_strdupfor2c (_local_path, _len_local_path);
+        h5_int64_t herr = h5_set_prop_file_core_staging (
+		prop, *increment, *mem_cap, local_path);
+        free (local_path);
+        H5_API_RETURN (herr);
+}
+
 #define h5_setprop_file_align FC_GLOBAL (  \
                 h5_setprop_file_align,	     \
                 H5_SETPROP_FILE_ALIGN)
@@ -142,6 +165,143 @@ h5_setprop_file_throttle (
         H5_API_RETURN (h5_set_prop_file_throttle (prop, *throttle));
 }
 
+#define h5_setprop_file_fs_tuning FC_GLOBAL (	\
+                h5_setprop_file_fs_tuning,		\
+                H5_SETPROP_FILE_FS_TUNING)
+h5_int64_t
+h5_setprop_file_fs_tuning (
+        h5_int64_t* _prop
+        ) {
+        H5_API_ENTER (h5_err_t,
+                      "prop=%lld",
+                      (long long int)*_prop);
+        h5_prop_t prop = (h5_prop_t)*_prop;
+        H5_API_RETURN (h5_set_prop_file_fs_tuning (prop));
+}
+
+#define h5_setprop_file_collective_metadata FC_GLOBAL (	\
+                h5_setprop_file_collective_metadata,		\
+                H5_SETPROP_FILE_COLLECTIVE_METADATA)
+h5_int64_t
+h5_setprop_file_collective_metadata (
+        h5_int64_t* _prop
+        ) {
+        H5_API_ENTER (h5_err_t,
+                      "prop=%lld",
+                      (long long int)*_prop);
+        h5_prop_t prop = (h5_prop_t)*_prop;
+        H5_API_RETURN (h5_set_prop_file_collective_metadata (prop));
+}
+
+#define h5_setprop_file_page_buffer FC_GLOBAL (	\
+                h5_setprop_file_page_buffer,		\
+                H5_SETPROP_FILE_PAGE_BUFFER)
+h5_int64_t
+h5_setprop_file_page_buffer (
+        h5_int64_t* _prop,
+        h5_int64_t* page_size,
+        h5_int64_t* buf_size
+        ) {
+        H5_API_ENTER (h5_err_t,
+                      "prop=%lld, page_size=%lld, buf_size=%lld",
+                      (long long int)*_prop,
+                      (long long int)*page_size, (long long int)*buf_size);
+        h5_prop_t prop = (h5_prop_t)*_prop;
+        H5_API_RETURN (h5_set_prop_file_page_buffer (prop, *page_size, *buf_size));
+}
+
+#define h5_setprop_file_mdc_size FC_GLOBAL (	\
+                h5_setprop_file_mdc_size,	\
+                H5_SETPROP_FILE_MDC_SIZE)
+h5_int64_t
+h5_setprop_file_mdc_size (
+        h5_int64_t* _prop,
+        h5_int64_t* size
+        ) {
+        H5_API_ENTER (h5_err_t,
+                      "prop=%lld, size=%lld",
+                      (long long int)*_prop, (long long int)*size);
+        h5_prop_t prop = (h5_prop_t)*_prop;
+        H5_API_RETURN (h5_set_prop_file_mdc_size (prop, *size));
+}
+
+#define h5_setprop_file_prefetch FC_GLOBAL (	\
+                h5_setprop_file_prefetch,	\
+                H5_SETPROP_FILE_PREFETCH)
+h5_int64_t
+h5_setprop_file_prefetch (
+        h5_int64_t* _prop,
+        h5_int64_t* mem_cap
+        ) {
+        H5_API_ENTER (h5_err_t,
+                      "prop=%lld, mem_cap=%lld",
+                      (long long int)*_prop, (long long int)*mem_cap);
+        h5_prop_t prop = (h5_prop_t)*_prop;
+        H5_API_RETURN (h5_set_prop_file_prefetch (prop, *mem_cap));
+}
+
+#define h5_setprop_file_attachment_compression FC_GLOBAL (	\
+                h5_setprop_file_attachment_compression,		\
+                H5_SETPROP_FILE_ATTACHMENT_COMPRESSION)
+h5_int64_t
+h5_setprop_file_attachment_compression (
+        h5_int64_t* _prop,
+        h5_int64_t* level
+        ) {
+        H5_API_ENTER (h5_err_t,
+                      "prop=%lld, level=%lld",
+                      (long long int)*_prop, (long long int)*level);
+        h5_prop_t prop = (h5_prop_t)*_prop;
+        H5_API_RETURN (h5_set_prop_file_attachment_compression (prop, *level));
+}
+
+#define h5_setprop_file_attachment_striping FC_GLOBAL (	\
+                h5_setprop_file_attachment_striping,		\
+                H5_SETPROP_FILE_ATTACHMENT_STRIPING)
+h5_int64_t
+h5_setprop_file_attachment_striping (
+        h5_int64_t* _prop
+        ) {
+        H5_API_ENTER (h5_err_t,
+                      "prop=%lld",
+                      (long long int)*_prop);
+        h5_prop_t prop = (h5_prop_t)*_prop;
+        H5_API_RETURN (h5_set_prop_file_attachment_striping (prop));
+}
+
+#define h5_setprop_file_attrib_cache FC_GLOBAL (	\
+                h5_setprop_file_attrib_cache,		\
+                H5_SETPROP_FILE_ATTRIB_CACHE)
+h5_int64_t
+h5_setprop_file_attrib_cache (
+        h5_int64_t* _prop
+        ) {
+        H5_API_ENTER (h5_err_t,
+                      "prop=%lld",
+                      (long long int)*_prop);
+        h5_prop_t prop = (h5_prop_t)*_prop;
+        H5_API_RETURN (h5_set_prop_file_attrib_cache (prop));
+}
+
+#define h5_setprop_file_io_trace FC_GLOBAL (	\
+                h5_setprop_file_io_trace,		\
+                H5_SETPROP_FILE_IO_TRACE)
+h5_int64_t
+h5_setprop_file_io_trace (
+        h5_int64_t* _prop,
+	const char* _path,
+	const int _len_path
+        ) {
+        H5_API_ENTER (h5_int64_t,
+                      "prop=%lld, path='%*s'",
+                      (long long int)*_prop, _len_path, _path);
+        h5_prop_t prop = (h5_prop_t)*_prop;
+        char* path = h5_strdupfor2c (_path, _len_path);
+        h5_int64_t herr = h5_set_prop_file_io_trace (prop, path);
+        free (path);
+        H5_API_RETURN (herr);
+}
+
 #define h5_closeprop FC_GLOBAL (		\
                 h5_closeprop,                   \
                 H5_CLOSEPROP)
@@ -118,6 +118,27 @@
        INTEGER*8, INTENT(IN) :: prop               !< property
      END FUNCTION h5_setprop_file_corevfd
 
+     !>
+     !! Modifies the file property list to use the \c H5FD_CORE driver with
+     !! asynchronous write-back. Each time an iteration has been completed and
+     !! on closing the file, a copy of the in-memory file image is written to
+     !! disk by a background thread. If \c local_path is not empty, the image
+     !! is first written to this path and then copied to the target file.
+     !! \c mem_cap limits the memory used for staged images, set it to 0 for
+     !! no limit.
+     !!
+     !! \return \c H5_SUCCESS on success
+     !! \return \c H5_FAILURE on error
+     !!
+     !! \see h5_setprop_file_corevfd()
+
+     INTEGER*8 FUNCTION h5_setprop_file_core_staging (prop, increment, mem_cap, local_path)
+       INTEGER*8, INTENT(IN) :: prop               !< property
+       INTEGER*8, INTENT(IN) :: increment          !< size of memory increments
+       INTEGER*8, INTENT(IN) :: mem_cap            !< memory cap for staged images
+       CHARACTER(LEN=*), INTENT(IN) :: local_path  !< node-local intermediate file
+     END FUNCTION h5_setprop_file_core_staging
+
      !>
      !! Sets alignment properties of a file property list so that any file
      !! object greater than or equal in size to threshold bytes will be
@@ -163,6 +184,136 @@
        INTEGER*8, INTENT(IN) :: throttle           !< throttle factor
      END FUNCTION h5_setprop_file_throttle
 
+     !>
+     !! Enable file system specific tuning. For Lustre, GPFS and BeeGFS the
+     !! stripe or block size is queried on opening the file and used to set
+     !! alignment, B-tree K and MPI-IO hints. An alignment set with
+     !! h5_setprop_file_align() takes precedence.
+     !!
+     !! \return \c H5_SUCCESS on success
+     !! \return \c H5_FAILURE on error
+     !!
+     !! \see h5_setprop_file_align()
+
+     INTEGER*8 FUNCTION h5_setprop_file_fs_tuning (prop)
+       INTEGER*8, INTENT(IN) :: prop               !< property
+     END FUNCTION h5_setprop_file_fs_tuning
+
+     !>
+     !! Enable collective metadata reads and writes. All processes perform
+     !! metadata operations collectively, only one process reads metadata
+     !! from disk and broadcasts it.
+     !!
+     !! The property is only available in the parallel library and requires
+     !! HDF5 1.10.0 or later. In all other cases it is ignored.
+     !!
+     !! \return \c H5_SUCCESS on success
+     !! \return \c H5_FAILURE on error
+     !!
+     !! \see h5_setprop_file_page_buffer()
+     !! \see h5_setprop_file_mdc_size()
+
+     INTEGER*8 FUNCTION h5_setprop_file_collective_metadata (prop)
+       INTEGER*8, INTENT(IN) :: prop               !< property
+     END FUNCTION h5_setprop_file_collective_metadata
+
+     !>
+     !! Use paged file space allocation with pages of \c page_size bytes
+     !! for new files and a page buffer of \c buf_size bytes. Set \c buf_size
+     !! to 0 to enable paging without page buffer. HDF5 does not support a
+     !! page buffer with the MPI-IO VFD, in this case only paging is enabled.
+     !!
+     !! \return \c H5_SUCCESS on success
+     !! \return \c H5_FAILURE on error
+     !!
+     !! \see h5_setprop_file_collective_metadata()
+     !! \see h5_setprop_file_mdc_size()
+
+     INTEGER*8 FUNCTION h5_setprop_file_page_buffer (prop, page_size, buf_size)
+       INTEGER*8, INTENT(IN) :: prop               !< property
+       INTEGER*8, INTENT(IN) :: page_size          !< file space page size in bytes
+       INTEGER*8, INTENT(IN) :: buf_size           !< page buffer size in bytes
+     END FUNCTION h5_setprop_file_page_buffer
+
+     !>
+     !! Set the initial size of the HDF5 metadata cache to \c size bytes.
+     !!
+     !! \return \c H5_SUCCESS on success
+     !! \return \c H5_FAILURE on error
+     !!
+     !! \see h5_setprop_file_collective_metadata()
+     !! \see h5_setprop_file_page_buffer()
+
+     INTEGER*8 FUNCTION h5_setprop_file_mdc_size (prop, size)
+       INTEGER*8, INTENT(IN) :: prop               !< property
+       INTEGER*8, INTENT(IN) :: size               !< initial cache size in bytes
+     END FUNCTION h5_setprop_file_mdc_size
+
+     !>
+     !! Enable read-ahead of the next iteration. Each time a dataset is read,
+     !! the same dataset in the next iteration is read by a background thread.
+     !! Only contiguous datasets of files opened read-only by a single process
+     !! are prefetched. \c mem_cap limits the memory used for prefetched
+     !! datasets, set it to 0 for no limit.
+     !!
+     !! \return \c H5_SUCCESS on success
+     !! \return \c H5_FAILURE on error
+
+     INTEGER*8 FUNCTION h5_setprop_file_prefetch (prop, mem_cap)
+       INTEGER*8, INTENT(IN) :: prop               !< property
+       INTEGER*8, INTENT(IN) :: mem_cap            !< memory cap in bytes
+     END FUNCTION h5_setprop_file_prefetch
+
+     !>
+     !! Compress attachments with the deflate filter. \c level must be
+     !! between 0 (no compression) and 9.
+     !!
+     !! \return \c H5_SUCCESS on success
+     !! \return \c H5_FAILURE on error
+
+     INTEGER*8 FUNCTION h5_setprop_file_attachment_compression (prop, level)
+       INTEGER*8, INTENT(IN) :: prop               !< property
+       INTEGER*8, INTENT(IN) :: level              !< compression level
+     END FUNCTION h5_setprop_file_attachment_compression
+
+     !>
+     !! Stripe reading and writing of attachments across all processes.
+     !! The attached file must be accessible by all processes.
+     !!
+     !! \return \c H5_SUCCESS on success
+     !! \return \c H5_FAILURE on error
+
+     INTEGER*8 FUNCTION h5_setprop_file_attachment_striping (prop)
+       INTEGER*8, INTENT(IN) :: prop               !< property
+     END FUNCTION h5_setprop_file_attachment_striping
+
+     !>
+     !! Cache attribute information and small attribute values in memory.
+     !! Writing an attribute to an object discards the cached information
+     !! of this object.
+     !!
+     !! \return \c H5_SUCCESS on success
+     !! \return \c H5_FAILURE on error
+
+     INTEGER*8 FUNCTION h5_setprop_file_attrib_cache (prop)
+       INTEGER*8, INTENT(IN) :: prop               !< property
+     END FUNCTION h5_setprop_file_attrib_cache
+
+     !>
+     !! Trace dataset reads and writes. The trace is written to \c path
+     !! when the file is closed. If \c path contains \c %d, each process
+     !! writes its own trace, otherwise a summary over all processes is
+     !! written. The format is CSV if \c path ends with \c .csv, JSON
+     !! otherwise.
+     !!
+     !! \return \c H5_SUCCESS on success
+     !! \return \c H5_FAILURE on error
+
+     INTEGER*8 FUNCTION h5_setprop_file_io_trace (prop, path)
+       INTEGER*8, INTENT(IN) :: prop               !< property
+       CHARACTER(LEN=*), INTENT(IN) :: path        !< name of trace file
+     END FUNCTION h5_setprop_file_io_trace
+
      !>
      !! Close file property list.
 
@@ -178,7 +329,6 @@
      !! - \c H5_O_WRONLY: create new file, dataset must not exist
      !! - \c H5_O_APPENDONLY: allows to append new data to an existing file
      !! - \c H5_O_RDWR:   dataset may exist
-     !! - \c H5_FS_LUSTRE - enable optimizations for the Lustre file system
      !! - \c H5_VFD_MPIO_POSIX - use the HDF5 MPI-POSIX virtual file driver
      !! - \c H5_VFD_MPIO_INDEPENDENT - use MPI-IO in indepedent mode
      !!
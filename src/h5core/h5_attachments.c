@@ -12,6 +12,9 @@
 #include "private/h5_err.h"
 #include "private/h5_hdf5.h"
 #include "private/h5_model.h"
+#include "private/h5_mpi.h"
+#include "private/h5_file.h"
+#include "private/h5_trace.h"
 #include "h5core/h5_syscall.h"
 #include "private/h5_va_macros.h"
 
@@ -23,6 +26,183 @@
 #include <fcntl.h>
 #include <errno.h>
 
+/*
+  Attachments are stored as chunked byte datasets and streamed between
+  the file system and the H5hut file in blocks, so no process ever holds
+  more than one block in memory. Block i is handled by process
+  i % nstripes, where nstripes is the number of processes if striping
+  has been enabled and 1 otherwise. All processes take part in each
+  (possibly collective) HDF5 call, processes without a block in a round
+  select nothing.
+ */
+#define H5_ATTACHMENT_BLOCK_SIZE	(4*1024*1024)
+
+static inline int
+get_num_stripes (
+	const h5_file_p f
+	) {
+	return (f->props->flags & H5_ATTACH_STRIPED) ? f->nprocs : 1;
+}
+
+/*
+  Propagate a system call error of any process to all processes, so no
+  process is left waiting in a collective call.
+ */
+static inline h5_err_t
+check_syscall_status (
+	const h5_file_p f,
+	const char* const msg,
+	const char* const fname,
+	const int err
+	) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	int any_err = err;
+#ifdef H5_HAVE_PARALLEL
+	TRY (h5priv_mpi_allreduce_max (
+		     (void*)&err, &any_err, 1, MPI_INT, f->props->comm));
+#else
+	UNUSED_ARGUMENT (f);
+#endif
+	if (err) {
+		H5_RETURN_ERROR (
+			H5_ERR_H5,
+			"%s '%s': %s",
+			msg, fname, strerror (err));
+	} else if (any_err) {
+		H5_RETURN_ERROR (
+			H5_ERR_H5,
+			"%s '%s' on another process",
+			msg, fname);
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
+static int
+read_block (
+	const int fd,
+	char* buf,
+	size_t size,
+	off_t offset
+	) {
+	while (size > 0) {
+		ssize_t n = pread (fd, buf, size, offset);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return n < 0 ? errno : EIO;
+		buf += n;
+		size -= (size_t)n;
+		offset += n;
+	}
+	return 0;
+}
+
+static int
+write_block (
+	const int fd,
+	const char* buf,
+	size_t size,
+	off_t offset
+	) {
+	while (size > 0) {
+		ssize_t n = pwrite (fd, buf, size, offset);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0)
+			return errno;
+		buf += n;
+		size -= (size_t)n;
+		offset += n;
+	}
+	return 0;
+}
+
+/*
+  Select block [start, start+len) in diskspace and transfer it. With
+  len == 0 nothing is selected.
+ */
+static h5_err_t
+transfer_block (
+	const h5_file_p f,
+	const hid_t dataset_id,
+	const hid_t diskspace_id,
+	hsize_t start,
+	hsize_t len,
+	char* const buf,
+	const int write
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t,
+			    "f=%p, dataset_id=%lld, diskspace_id=%lld, "
+			    "start=%llu, len=%llu, buf=%p, write=%d",
+			    f, (long long)dataset_id, (long long)diskspace_id,
+			    (unsigned long long)start, (unsigned long long)len,
+			    buf, write);
+	if (len > 0) {
+		TRY (hdf5_select_hyperslab_of_dataspace (
+			     diskspace_id,
+			     H5S_SELECT_SET,
+			     &start,
+			     NULL,
+			     &len,
+			     NULL));
+	} else {
+		TRY (hdf5_select_none (diskspace_id));
+	}
+	hid_t memspace_id;
+	hsize_t max = H5S_UNLIMITED;
+	TRY (memspace_id = hdf5_create_dataspace (1, &len, &max));
+	if (write) {
+		TRY (h5priv_trace_write (f, "write_attachment",
+					 dataset_id,
+					 H5T_NATIVE_CHAR,
+					 memspace_id,
+					 diskspace_id,
+					 buf));
+	} else {
+		TRY (h5priv_trace_read (f, "read_attachment",
+					dataset_id,
+					H5T_NATIVE_CHAR,
+					memspace_id,
+					diskspace_id,
+					buf));
+	}
+	TRY (hdf5_close_dataspace (memspace_id));
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline hid_t
+create_attachment_property (
+	const h5_file_p f,
+	const hsize_t fsize
+	) {
+	H5_INLINE_FUNC_ENTER (hid_t);
+	hid_t dcpl_id;
+	TRY (dcpl_id = hdf5_create_property (H5P_DATASET_CREATE));
+	if (fsize == 0) {
+		H5_LEAVE (dcpl_id);
+	}
+	hsize_t chunk = fsize < H5_ATTACHMENT_BLOCK_SIZE ?
+		fsize : H5_ATTACHMENT_BLOCK_SIZE;
+	TRY (hdf5_set_chunk_property (dcpl_id, 1, &chunk));
+	if (f->props->attach_compression == 0) {
+		H5_LEAVE (dcpl_id);
+	}
+#if defined(H5_HAVE_PARALLEL) && !H5_VERSION_GE(1,10,2)
+	h5_warn ("Compression of attachments requires HDF5 1.10.2 or later.");
+#else
+	h5_err_t avail;
+	TRY (avail = hdf5_filter_avail (H5Z_FILTER_DEFLATE));
+	if (avail) {
+		TRY (hdf5_set_deflate_property (
+			     dcpl_id, (unsigned int)f->props->attach_compression));
+	} else {
+		h5_warn ("Deflate filter not available, "
+			 "attachments are stored uncompressed.");
+	}
+#endif
+	H5_RETURN (dcpl_id);
+}
+
 h5_err_t
 h5_add_attachment (
 	const h5_file_t f_,
@@ -33,49 +213,6 @@ h5_add_attachment (
 	CHECK_FILEHANDLE (f);
 	CHECK_WRITABLE_MODE (f);
 
-	struct stat st;
-        if (stat (fname, &st) < 0) {
-		H5_RETURN_ERROR (
-			H5_ERR_HDF5,
-			"Cannot stat file '%s'",
-			fname);
-	}
-	hsize_t fsize = st.st_size;
-	hsize_t write_length;
-	char* buf = NULL;
-	if (f->myproc == 0) {
-		TRY (buf = h5_calloc (1, fsize));
-		write_length = fsize;
-		int fd;
-		if ((fd = open (fname, O_RDONLY)) < 0) {
-			H5_RETURN_ERROR (
-				H5_ERR_HDF5,
-				"Cannot open file '%s' for reading",
-				fname);
-		}
-	again:
-		if (read (fd, buf, fsize) < 0) {
-			if (errno == EINTR) {
-				goto again;
-			} else {
-				H5_RETURN_ERROR (
-					H5_ERR_HDF5,
-					"Cannot read file '%s'",
-					fname);
-			}
-		}
-		if (close (fd) < 0) {
-			H5_RETURN_ERROR (
-				H5_ERR_HDF5,
-				"Cannot close file '%s'",
-				fname);
-		}
-
-	} else {
-		TRY (buf = h5_calloc (1, 1));
-		write_length = 0;
-	}
-
 	hid_t loc_id;
 	TRY (loc_id = h5priv_create_group (f->file, H5_ATTACHMENT));
 	h5_err_t exists;
@@ -84,35 +221,71 @@ h5_add_attachment (
 		H5_LEAVE (
 			h5priv_handle_file_mode_error (f->props->flags));
 	}
+
+	// size of file as seen by first process
+	int nstripes = get_num_stripes (f);
+	int err = 0;
+	h5_int64_t size = 0;
+	if (f->myproc == 0) {
+		struct stat st;
+		if (stat (fname, &st) < 0) {
+			err = errno;
+		} else {
+			size = st.st_size;
+		}
+	}
+	TRY (check_syscall_status (f, "Cannot stat file", fname, err));
+#ifdef H5_HAVE_PARALLEL
+	TRY (h5priv_mpi_bcast (&size, 1, MPI_LONG_LONG, 0, f->props->comm));
+#endif
+	hsize_t fsize = (hsize_t)size;
+
+	int fd = -1;
+	char* buf = NULL;
+	if (f->myproc < nstripes) {
+		if ((fd = open (fname, O_RDONLY)) < 0) {
+			err = errno;
+		}
+		TRY (buf = h5_calloc (1, H5_ATTACHMENT_BLOCK_SIZE));
+	} else {
+		TRY (buf = h5_calloc (1, 1));
+	}
+	TRY (check_syscall_status (f, "Cannot open file", fname, err));
+
 	hid_t diskspace_id;
 	TRY (diskspace_id = hdf5_create_dataspace (1, &fsize, &fsize));
+	hid_t dcpl_id;
+	TRY (dcpl_id = create_attachment_property (f, fsize));
 	hid_t dataset_id;
 	TRY (dataset_id = hdf5_create_dataset (loc_id,
 					       fname,
 					       H5T_NATIVE_CHAR,
 					       diskspace_id,
-					       H5P_DEFAULT));
-	hsize_t start = 0;
-	TRY (hdf5_select_hyperslab_of_dataspace (
-		     diskspace_id,
-		     H5S_SELECT_SET,
-		     &start,
-		     NULL,
-		     &write_length,
-		     NULL));
+					       dcpl_id));
+	TRY (hdf5_close_property (dcpl_id));
 
-	hid_t memspace_id;
-	hsize_t max = H5S_UNLIMITED;
-	TRY (memspace_id = hdf5_create_dataspace (1, &write_length, &max));
-	TRY (hdf5_write_dataset (dataset_id,
-				 H5T_NATIVE_CHAR,
-				 memspace_id,
-				 diskspace_id,
-				 f->props->xfer_prop,
-				 buf));
+	hsize_t num_blocks = (fsize + H5_ATTACHMENT_BLOCK_SIZE - 1) /
+		H5_ATTACHMENT_BLOCK_SIZE;
+	for (hsize_t first = 0; first < num_blocks; first += nstripes) {
+		hsize_t block = first + f->myproc;
+		hsize_t start = block * H5_ATTACHMENT_BLOCK_SIZE;
+		hsize_t len = 0;
+		if (f->myproc < nstripes && block < num_blocks) {
+			len = fsize - start;
+			if (len > H5_ATTACHMENT_BLOCK_SIZE)
+				len = H5_ATTACHMENT_BLOCK_SIZE;
+			err = read_block (fd, buf, len, (off_t)start);
+		}
+		TRY (check_syscall_status (f, "Cannot read file", fname, err));
+		TRY (transfer_block (
+			     f, dataset_id, diskspace_id, start, len, buf, 1));
+	}
+	if (fd >= 0 && close (fd) < 0) {
+		err = errno;
+	}
+	TRY (check_syscall_status (f, "Cannot close file", fname, err));
 
 	TRY (hdf5_close_dataspace (diskspace_id));
-	TRY (hdf5_close_dataspace (memspace_id));
 	TRY (hdf5_close_dataset (dataset_id));
 	TRY (hdf5_close_group (loc_id));
 
@@ -237,70 +410,60 @@ h5_get_attachment (
 	hid_t loc_id;
 	TRY (loc_id = hdf5_open_group (f->file, H5_ATTACHMENT));
 
-	// read dataset
 	hid_t dataset_id, diskspace_id;
-	h5_ssize_t fsize;
+	h5_ssize_t size;
 	TRY (dataset_id = hdf5_open_dataset_by_name (loc_id, fname));
 	TRY (diskspace_id = hdf5_get_dataset_space (dataset_id));
-	TRY (fsize = hdf5_get_npoints_of_dataspace (diskspace_id));
+	TRY (size = hdf5_get_npoints_of_dataspace (diskspace_id));
+	hsize_t fsize = (hsize_t)size;
 
-	hsize_t read_length;
-	char* buf = NULL;
-	if (f->myproc == 0) {
-		buf = h5_calloc (1, fsize);
-		read_length = fsize;
+	// the first process creates the file, the others open it afterwards
+	int nstripes = get_num_stripes (f);
+	int err = 0;
+	int fd = -1;
+	if (f->myproc == 0 &&
+	    (fd = open (fname, O_WRONLY|O_CREAT|O_TRUNC, 0600)) < 0) {
+		err = errno;
+	}
+	TRY (check_syscall_status (f, "Error opening file", fname, err));
+	if (f->myproc > 0 && f->myproc < nstripes &&
+	    (fd = open (fname, O_WRONLY)) < 0) {
+		err = errno;
+	}
+	TRY (check_syscall_status (f, "Error opening file", fname, err));
 
+	char* buf = NULL;
+	if (f->myproc < nstripes) {
+		TRY (buf = h5_calloc (1, H5_ATTACHMENT_BLOCK_SIZE));
 	} else {
-		buf = h5_calloc (1, 1);
-		read_length = 0;
+		TRY (buf = h5_calloc (1, 1));
 	}
-
-	hsize_t start = 0;
-	TRY (hdf5_select_hyperslab_of_dataspace (
-		     diskspace_id,
-		     H5S_SELECT_SET,
-		     &start,
-		     NULL,
-		     &read_length,
-		     NULL));
-
-	hid_t memspace_id;
-	hsize_t max = H5S_UNLIMITED;
-	TRY (memspace_id = hdf5_create_dataspace (1, &read_length, &max));
-	TRY (hdf5_read_dataset (dataset_id,
-				 H5T_NATIVE_CHAR,
-				 memspace_id,
-				 diskspace_id,
-				 f->props->xfer_prop,
-				 buf));
+	hsize_t num_blocks = (fsize + H5_ATTACHMENT_BLOCK_SIZE - 1) /
+		H5_ATTACHMENT_BLOCK_SIZE;
+	for (hsize_t first = 0; first < num_blocks; first += nstripes) {
+		hsize_t block = first + f->myproc;
+		hsize_t start = block * H5_ATTACHMENT_BLOCK_SIZE;
+		hsize_t len = 0;
+		if (f->myproc < nstripes && block < num_blocks) {
+			len = fsize - start;
+			if (len > H5_ATTACHMENT_BLOCK_SIZE)
+				len = H5_ATTACHMENT_BLOCK_SIZE;
+		}
+		TRY (transfer_block (
+			     f, dataset_id, diskspace_id, start, len, buf, 0));
+		if (len > 0) {
+			err = write_block (fd, buf, len, (off_t)start);
+		}
+		TRY (check_syscall_status (f, "Error writing to file", fname, err));
+	}
+	if (fd >= 0 && close (fd) < 0) {
+		err = errno;
+	}
+	TRY (check_syscall_status (f, "Error closing file", fname, err));
 
 	TRY (hdf5_close_dataspace (diskspace_id));
-	TRY (hdf5_close_dataspace (memspace_id));
 	TRY (hdf5_close_dataset (dataset_id));
 	TRY (hdf5_close_group (loc_id));
-
-	// write file
-	if (f->myproc == 0) {
-		int fd;
-		if ((fd = open (fname, O_WRONLY|O_CREAT|O_TRUNC, 0600)) < 0) {
-			H5_RETURN_ERROR (
-				H5_ERR_H5,
-				"Error opening file '%s': %s",
-				fname, strerror(errno));
-		}
-		if (write (fd, buf, fsize) != fsize) {
-			H5_RETURN_ERROR (
-				H5_ERR_H5,
-				"Error writing to file '%s': %s",
-				fname, strerror(errno));
-		}
-		if (close (fd) < 0) {
-			H5_RETURN_ERROR (
-				H5_ERR_H5,
-				"Error closing file '%s': %s",
-				fname, strerror(errno));
-		}
-	}
 	TRY (h5_free (buf));
 
 	H5_RETURN (H5_SUCCESS);
@@ -10,9 +10,11 @@
 #include "h5core/h5_log.h"
 #include "h5core/h5_file_attribs.h"
 #include "h5core/h5_step_attribs.h"
+#include "h5core/h5_syscall.h"
 
 #include "private/h5_hdf5.h"
 #include "private/h5_attribs.h"
+#include "private/h5_attrib_cache.h"
 
 h5_err_t
 h5_has_file_attrib (
@@ -26,7 +28,8 @@ h5_has_file_attrib (
 			   f,
 			   attrib_name);
 	CHECK_FILEHANDLE (f);
-	TRY (ret_value = hdf5_attribute_exists(f->root_gid, attrib_name));
+	TRY (ret_value = h5priv_cached_attrib_exists (
+		     f, f->root_gid, attrib_name));
 	H5_RETURN (ret_value);
 }
 	
@@ -42,7 +45,8 @@ h5_has_iteration_attrib (
 			   f,
 			   attrib_name);
 	check_iteration_handle_is_valid (f);
-	TRY (ret_value = hdf5_attribute_exists (f->iteration_gid, attrib_name));
+	TRY (ret_value = h5priv_cached_attrib_exists (
+		     f, f->iteration_gid, attrib_name));
 	H5_RETURN (ret_value);
 }
 
@@ -53,7 +57,7 @@ h5_get_num_file_attribs (
         h5_file_p f = (h5_file_p)f_;
 	H5_CORE_API_ENTER (h5_ssize_t, "f=%p", f);
 	CHECK_FILEHANDLE (f);
-	TRY (ret_value = hdf5_get_num_attribute (f->root_gid));
+	TRY (ret_value = h5priv_cached_get_num_attribs (f, f->root_gid));
 	H5_RETURN (ret_value);
 }
 
@@ -64,7 +68,7 @@ h5_get_num_iteration_attribs (
         h5_file_p f = (h5_file_p)f_;
 	H5_CORE_API_ENTER (h5_ssize_t, "f=%p", f);
 	check_iteration_handle_is_valid (f);
-	TRY (ret_value = hdf5_get_num_attribute (f->iteration_gid));
+	TRY (ret_value = h5priv_cached_get_num_attribs (f, f->iteration_gid));
 	H5_RETURN (ret_value);
 }
 
@@ -88,8 +92,8 @@ h5_get_file_attrib_info_by_idx (
 			   attrib_name, (long long unsigned)len_attrib_name,
 			   attrib_type, attrib_nelem);
 	CHECK_FILEHANDLE (f);
-	TRY (ret_value = h5priv_get_attrib_info_by_idx (
-			f->root_gid,
+	TRY (ret_value = h5priv_cached_get_attrib_info_by_idx (
+			f, f->root_gid,
 			attrib_idx,
 			attrib_name, len_attrib_name,
 			attrib_type, attrib_nelem));
@@ -112,8 +116,8 @@ h5_get_file_attrib_info_by_name (
 			   attrib_name,
 			   attrib_type, attrib_nelem);
 	CHECK_FILEHANDLE (f);
-	TRY (ret_value = h5priv_get_attrib_info_by_name (
-		     f->root_gid,
+	TRY (ret_value = h5priv_cached_get_attrib_info_by_name (
+		     f, f->root_gid,
 		     attrib_name,
 		     attrib_type, attrib_nelem));
 	H5_RETURN (ret_value);
@@ -139,8 +143,8 @@ h5_get_iteration_attrib_info_by_idx (
 			   attrib_name, (long long unsigned)len_attrib_name,
 			   attrib_type, attrib_nelem);
 	check_iteration_handle_is_valid (f);
-	TRY (ret_value = h5priv_get_attrib_info_by_idx (
-		     f->iteration_gid,
+	TRY (ret_value = h5priv_cached_get_attrib_info_by_idx (
+		     f, f->iteration_gid,
 		     attrib_idx,
 		     attrib_name, len_attrib_name,
 		     attrib_type, attrib_nelem));
@@ -163,8 +167,8 @@ h5_get_iteration_attrib_info_by_name (
 			   attrib_name,
 			   attrib_type, attrib_nelem);
 	check_iteration_handle_is_valid (f);
-	TRY (ret_value = h5priv_get_attrib_info_by_name (
-		     f->iteration_gid,
+	TRY (ret_value = h5priv_cached_get_attrib_info_by_name (
+		     f, f->iteration_gid,
 		     attrib_name,
 		     attrib_type, attrib_nelem));
 	H5_RETURN (ret_value);
@@ -186,8 +190,8 @@ h5_read_file_attrib (
 			   (long long int)attrib_type,
 			   attrib_value);
 	CHECK_FILEHANDLE (f);
-	TRY (ret_value = h5priv_read_attrib (
-		     f->root_gid,
+	TRY (ret_value = h5priv_cached_read_attrib (
+		     f, f->root_gid,
 		     attrib_name,
 		     attrib_type,
 		     attrib_value));
@@ -211,8 +215,8 @@ h5_read_iteration_attrib (
 			   attrib_value);
 	check_iteration_is_readable (f);
 	
-	TRY (ret_value = h5priv_read_attrib (
-		     f->iteration_gid,
+	TRY (ret_value = h5priv_cached_read_attrib (
+		     f, f->iteration_gid,
 		     attrib_name,
 		     attrib_type,
 		     attrib_value));
@@ -238,6 +242,9 @@ h5_write_file_attrib (
 			   (long long)attrib_nelem);
 	CHECK_FILEHANDLE (f);
 	CHECK_WRITABLE_MODE (f);
+	TRY (h5priv_invalidate_attrib_cache (f, f->root_gid));
+	TRY (h5priv_remove_table_attrib (
+		     f->root_gid, attrib_name, is_appendonly (f)));
 	if (is_appendonly (f)) {
 		TRY (h5priv_append_attrib (
 			     f->root_gid,
@@ -274,6 +281,9 @@ h5_write_iteration_attrib (
 			   attrib_value,
 			   (long long)attrib_nelem);
 	check_iteration_is_writable (f);
+	TRY (h5priv_invalidate_attrib_cache (f, f->iteration_gid));
+	TRY (h5priv_remove_table_attrib (
+		     f->iteration_gid, attrib_name, is_appendonly (f)));
 	if (is_appendonly (f)) {
 		TRY (h5priv_append_attrib (
 			     f->iteration_gid,
@@ -291,3 +301,81 @@ h5_write_iteration_attrib (
 	}
 	H5_RETURN (H5_SUCCESS);
 }
+
+h5_err_t
+h5_write_file_attribs (
+	const h5_file_t f_,
+	const h5_attrib_t* const attribs,
+	const h5_size_t num_attribs
+	) {
+        h5_file_p f = (h5_file_p)f_;
+	H5_CORE_API_ENTER (h5_err_t,
+			   "f=%p, attribs=%p, num_attribs=%llu",
+			   f,
+			   attribs,
+			   (long long unsigned)num_attribs);
+	CHECK_FILEHANDLE (f);
+	CHECK_WRITABLE_MODE (f);
+	TRY (h5priv_invalidate_attrib_cache (f, f->root_gid));
+	TRY (h5priv_write_attribs (
+		     f->root_gid,
+		     attribs,
+		     num_attribs,
+		     is_appendonly (f)));
+	H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5_write_iteration_attribs (
+	const h5_file_t f_,
+	const h5_attrib_t* const attribs,
+	const h5_size_t num_attribs
+	) {
+        h5_file_p f = (h5_file_p)f_;
+	H5_CORE_API_ENTER (h5_err_t,
+			   "f=%p, attribs=%p, num_attribs=%llu",
+			   f,
+			   attribs,
+			   (long long unsigned)num_attribs);
+	check_iteration_is_writable (f);
+	TRY (h5priv_invalidate_attrib_cache (f, f->iteration_gid));
+	TRY (h5priv_write_attribs (
+		     f->iteration_gid,
+		     attribs,
+		     num_attribs,
+		     is_appendonly (f)));
+	H5_RETURN (H5_SUCCESS);
+}
+
+h5_ssize_t
+h5_read_file_attribs (
+	const h5_file_t f_,
+	h5_attrib_t** const attribs
+	) {
+        h5_file_p f = (h5_file_p)f_;
+	H5_CORE_API_ENTER (h5_ssize_t, "f=%p, attribs=%p", f, attribs);
+	CHECK_FILEHANDLE (f);
+	TRY (ret_value = h5priv_read_attribs (f->root_gid, attribs));
+	H5_RETURN (ret_value);
+}
+
+h5_ssize_t
+h5_read_iteration_attribs (
+	const h5_file_t f_,
+	h5_attrib_t** const attribs
+	) {
+        h5_file_p f = (h5_file_p)f_;
+	H5_CORE_API_ENTER (h5_ssize_t, "f=%p, attribs=%p", f, attribs);
+	check_iteration_is_readable (f);
+	TRY (ret_value = h5priv_read_attribs (f->iteration_gid, attribs));
+	H5_RETURN (ret_value);
+}
+
+h5_err_t
+h5_free_attribs (
+	h5_attrib_t* const attribs
+	) {
+	H5_CORE_API_ENTER (h5_err_t, "attribs=%p", attribs);
+	TRY (h5_free (attribs));
+	H5_RETURN (H5_SUCCESS);
+}
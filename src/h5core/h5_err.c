@@ -16,7 +16,7 @@ extern int h5_myproc;
 #include <stdlib.h>
 
 static h5_errorhandler_t	h5_errhandler = h5_report_errorhandler;
-h5_err_t			h5_errno;
+H5_THREAD_LOCAL h5_err_t	h5_errno;
 
 /*!
    \ingroup h5_core
@@ -14,11 +14,17 @@
 
 #include "h5core/h5_log.h"
 
+#include "private/h5_attrib_cache.h"
 #include "private/h5_file.h"
+#include "private/h5_fs.h"
 #include "private/h5_hdf5.h"
 
 #include "private/h5_model.h"
 #include "private/h5_mpi.h"
+#include "private/h5_mmap.h"
+#include "private/h5_prefetch.h"
+#include "private/h5_staging.h"
+#include "private/h5_trace.h"
 #include "private/h5u_io.h"
 #include "private/h5b_io.h"
 
@@ -82,7 +88,6 @@ mpi_init (
 	/* xfer_prop:  also used for parallel I/O, during actual writes
 	   rather than the access_prop which is for file creation. */
 	TRY (f->props->xfer_prop = hdf5_create_property(H5P_DATASET_XFER));
-	TRY (f->props->access_prop = hdf5_create_property(H5P_FILE_ACCESS));
 
 	/* select the HDF5 VFD */
 #if H5_VERSION_LE(1,8,12)
@@ -95,7 +100,8 @@ mpi_init (
         } else if ((f->props->flags & H5_VFD_CORE)) {
 		h5_info("Selecting CORE VFD");
                 TRY (hdf5_set_fapl_core (f->props->access_prop,
-                                         f->props->align, 1));
+                                         f->props->increment,
+                                         !(f->props->flags & H5_STAGE_ASYNC)));
         } else if ((f->props->flags & H5_VFD_MPIO_INDEPENDENT)){
                 h5_info("Selecting MPI-IO VFD, using independent mode");
 		TRY (hdf5_set_fapl_mpio_property (f->props->access_prop,
@@ -115,7 +121,8 @@ mpi_init (
         if ((f->props->flags & H5_VFD_CORE)) {
 		h5_info("Selecting CORE VFD");
                 TRY (hdf5_set_fapl_core (f->props->access_prop,
-                                         f->props->align, 1));
+                                         f->props->increment,
+                                         !(f->props->flags & H5_STAGE_ASYNC)));
         } else if ((f->props->flags & H5_VFD_MPIO_INDEPENDENT)){
                 h5_info("Selecting MPI-IO VFD, using independent mode");
 		TRY (hdf5_set_fapl_mpio_property (f->props->access_prop,
@@ -131,11 +138,13 @@ mpi_init (
                                                   H5FD_MPIO_COLLECTIVE) );
 	}
 #endif
-#ifdef H5_USE_LUSTRE
-	if (f->flags & H5_FS_LUSTRE) {
-		TRY (h5_optimize_for_lustre(f, filename));
+#else
+        if ((f->props->flags & H5_VFD_CORE)) {
+		h5_info("Selecting CORE VFD");
+                TRY (hdf5_set_fapl_core (f->props->access_prop,
+                                         f->props->increment,
+                                         !(f->props->flags & H5_STAGE_ASYNC)));
 	}
-#endif
 #endif /* H5_HAVE_PARALLEL */
 	H5_RETURN (H5_SUCCESS);
 }
@@ -162,6 +171,74 @@ set_alignment (
 	H5_RETURN (H5_SUCCESS);
 }
 
+/*
+  Configure HDF5 metadata handling: collective metadata operations,
+  paged file space allocation with page buffer and the initial size
+  of the metadata cache.
+ */
+static inline h5_err_t
+set_metadata_props (
+	const h5_file_p f
+	) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	h5_prop_file_p props = f->props;
+	if (!(props->flags & H5_COLL_METADATA) &&
+	    props->page_size == 0 && props->mdc_size == 0) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	if (props->flags & H5_COLL_METADATA) {
+#if defined(H5_HAVE_PARALLEL) && H5_VERSION_GE(1,10,0)
+		h5_info ("Enabling collective metadata reads and writes.");
+		TRY (hdf5_set_all_coll_metadata_ops (props->access_prop, 1));
+		TRY (hdf5_set_coll_metadata_write (props->access_prop, 1));
+#else
+		h5_info ("Collective metadata operations not available, "
+			 "property ignored.");
+#endif
+	}
+	if (props->page_size > 0) {
+#if H5_VERSION_GE(1,10,1)
+		if (props->flags & (H5_O_WRONLY | H5_O_APPENDONLY | H5_O_RDWR)) {
+			h5_info ("Setting file space page size to %lld bytes.",
+				 (long long int)props->page_size);
+			TRY (hdf5_set_file_space_page_strategy (
+				     props->create_prop,
+				     (hsize_t)props->page_size));
+		}
+#if defined(H5_HAVE_PARALLEL)
+		// HDF5 does not support page buffering with the MPI-IO VFD
+		if (props->page_buf_size > 0 && (props->flags & H5_VFD_CORE)) {
+#else
+		if (props->page_buf_size > 0) {
+#endif
+			h5_info ("Setting page buffer size to %lld bytes.",
+				 (long long int)props->page_buf_size);
+			TRY (hdf5_set_page_buffer_size (
+				     props->access_prop,
+				     (size_t)props->page_buf_size));
+		}
+#else
+		h5_info ("Paged file space allocation requires HDF5 1.10.1 "
+			 "or later, property ignored.");
+#endif
+	}
+	if (props->mdc_size > 0) {
+		h5_info ("Setting initial metadata cache size to %lld bytes.",
+			 (long long int)props->mdc_size);
+		H5AC_cache_config_t config;
+		config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+		TRY (hdf5_get_mdc_property (props->access_prop, &config));
+		config.set_initial_size = 1;
+		config.initial_size = (size_t)props->mdc_size;
+		if (config.max_size < config.initial_size)
+			config.max_size = config.initial_size;
+		if (config.min_size > config.initial_size)
+			config.min_size = config.initial_size;
+		TRY (hdf5_set_mdc_property (props->access_prop, &config));
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
 static inline h5_err_t
 set_default_file_props (
         h5_prop_file_t* const _props
@@ -275,23 +352,51 @@ h5_set_prop_file_core_vfd (
 			"Invalid property class: %lld",
 			(long long int)props->class);
         }
-#ifdef H5_HAVE_PARALLEL
         props->flags &= ~(H5_VFD_MPIO_COLLECTIVE |
 			  H5_VFD_MPIO_INDEPENDENT |
-			  H5_VFD_MPIO_POSIX);
-        props->flags |= H5_VFD_MPIO_INDEPENDENT;
+			  H5_VFD_MPIO_POSIX |
+			  H5_STAGE_ASYNC);
+        props->flags |= H5_VFD_CORE;
+	props->increment = increment > 0 ? increment : H5_CORE_VFD_INCREMENT;
+#ifdef H5_HAVE_PARALLEL
         props->comm = MPI_COMM_SELF;
-	props->increment = increment;
 	if (props->throttle > 0) {
 		h5_warn ("Throttling is not permitted with core VFD. Reset throttling.");
 		props->throttle = 0;
 	}
-#else
-	h5_info ("Setting MPIO core property ignored in serial H5hut");
 #endif
         H5_RETURN (H5_SUCCESS);
 }
 
+h5_err_t
+h5_set_prop_file_core_staging (
+        h5_prop_t _props,
+	const h5_int64_t increment,
+	const h5_int64_t mem_cap,
+	const char* const local_path
+        ) {
+        h5_prop_file_t* props = (h5_prop_file_t*)_props;
+        H5_CORE_API_ENTER (h5_err_t,
+			   "props=%p, increment=%lld, mem_cap=%lld, local_path='%s'",
+			   props, (long long int)increment, (long long int)mem_cap,
+			   local_path ? local_path : "");
+	if (mem_cap < 0) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid memory cap: %lld",
+			(long long int)mem_cap);
+	}
+	TRY (h5_set_prop_file_core_vfd (_props, increment));
+        props->flags |= H5_STAGE_ASYNC;
+	props->stage_mem_cap = mem_cap;
+	TRY (h5_free (props->stage_path));
+	props->stage_path = NULL;
+	if (local_path && local_path[0] != '\0') {
+		TRY (props->stage_path = h5_strdup (local_path));
+	}
+        H5_RETURN (H5_SUCCESS);
+}
+
 
 h5_err_t
 h5_set_prop_file_align (
@@ -375,6 +480,261 @@ h5_set_prop_file_throttle (
 }
 
 
+h5_err_t
+h5_set_prop_file_fs_tuning (
+        h5_prop_t _props
+        ) {
+        h5_prop_file_t* props = (h5_prop_file_t*)_props;
+        H5_CORE_API_ENTER (
+		h5_err_t,
+		"props=%p",
+		props);
+        if (props->class != H5_PROP_FILE) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid property class: %lld",
+			(long long int)props->class);
+        }
+        props->flags |= H5_FS_TUNE;
+        H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5_set_prop_file_collective_metadata (
+        h5_prop_t _props
+        ) {
+        h5_prop_file_t* props = (h5_prop_file_t*)_props;
+        H5_CORE_API_ENTER (
+		h5_err_t,
+		"props=%p",
+		props);
+        if (props->class != H5_PROP_FILE) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid property class: %lld",
+			(long long int)props->class);
+        }
+#ifdef H5_HAVE_PARALLEL
+        props->flags |= H5_COLL_METADATA;
+#else
+	h5_info ("Setting collective metadata property ignored in serial H5hut");
+#endif
+        H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5_set_prop_file_page_buffer (
+        h5_prop_t _props,
+        const h5_int64_t page_size,
+        const h5_int64_t buf_size
+        ) {
+        h5_prop_file_t* props = (h5_prop_file_t*)_props;
+        H5_CORE_API_ENTER (
+		h5_err_t,
+		"props=%p, page_size=%lld, buf_size=%lld",
+		props, (long long int)page_size, (long long int)buf_size);
+        if (props->class != H5_PROP_FILE) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid property class: %lld",
+			(long long int)props->class);
+        }
+	if (page_size < 0 || (page_size > 0 && page_size < 512)) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid page size: %lld, must be at least 512 bytes",
+			(long long int)page_size);
+	}
+	if (buf_size < 0 || (buf_size > 0 && page_size > 0 &&
+			     (buf_size < page_size || buf_size % page_size))) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid page buffer size: %lld, must be a multiple "
+			"of the page size %lld",
+			(long long int)buf_size, (long long int)page_size);
+	}
+        props->page_size = page_size;
+        props->page_buf_size = page_size > 0 ? buf_size : 0;
+        H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5_set_prop_file_mdc_size (
+        h5_prop_t _props,
+        const h5_int64_t size
+        ) {
+        h5_prop_file_t* props = (h5_prop_file_t*)_props;
+        H5_CORE_API_ENTER (
+		h5_err_t,
+		"props=%p, size=%lld",
+		props, (long long int)size);
+        if (props->class != H5_PROP_FILE) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid property class: %lld",
+			(long long int)props->class);
+        }
+	if (size < 0) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid metadata cache size: %lld",
+			(long long int)size);
+	}
+        props->mdc_size = size;
+        H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5_set_prop_file_prefetch (
+        h5_prop_t _props,
+        const h5_int64_t mem_cap
+        ) {
+        h5_prop_file_t* props = (h5_prop_file_t*)_props;
+        H5_CORE_API_ENTER (
+		h5_err_t,
+		"props=%p, mem_cap=%lld",
+		props, (long long int)mem_cap);
+        if (props->class != H5_PROP_FILE) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid property class: %lld",
+			(long long int)props->class);
+        }
+	if (mem_cap < 0) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid memory cap: %lld",
+			(long long int)mem_cap);
+	}
+        props->flags |= H5_PREFETCH;
+        props->prefetch_mem_cap = mem_cap;
+        H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5_set_prop_file_attachment_compression (
+        h5_prop_t _props,
+        const h5_int64_t level
+        ) {
+        h5_prop_file_t* props = (h5_prop_file_t*)_props;
+        H5_CORE_API_ENTER (
+		h5_err_t,
+		"props=%p, level=%lld",
+		props, (long long int)level);
+        if (props->class != H5_PROP_FILE) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid property class: %lld",
+			(long long int)props->class);
+        }
+	if (level < 0 || level > 9) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid compression level: %lld",
+			(long long int)level);
+	}
+        props->attach_compression = level;
+        H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5_set_prop_file_attachment_striping (
+        h5_prop_t _props
+        ) {
+        h5_prop_file_t* props = (h5_prop_file_t*)_props;
+        H5_CORE_API_ENTER (
+		h5_err_t,
+		"props=%p",
+		props);
+        if (props->class != H5_PROP_FILE) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid property class: %lld",
+			(long long int)props->class);
+        }
+        props->flags |= H5_ATTACH_STRIPED;
+        H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5_set_prop_file_attrib_cache (
+        h5_prop_t _props
+        ) {
+        h5_prop_file_t* props = (h5_prop_file_t*)_props;
+        H5_CORE_API_ENTER (
+		h5_err_t,
+		"props=%p",
+		props);
+        if (props->class != H5_PROP_FILE) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid property class: %lld",
+			(long long int)props->class);
+        }
+        props->flags |= H5_ATTRIB_CACHE;
+        H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5_set_prop_file_io_trace (
+        h5_prop_t _props,
+	const char* const path
+        ) {
+        h5_prop_file_t* props = (h5_prop_file_t*)_props;
+        H5_CORE_API_ENTER (
+		h5_err_t,
+		"props=%p, path='%s'",
+		props, path ? path : "");
+        if (props->class != H5_PROP_FILE) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid property class: %lld",
+			(long long int)props->class);
+        }
+	if (path == NULL || path[0] == '\0') {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"%s",
+			"Invalid trace file name");
+	}
+	TRY (h5_free (props->trace_path));
+	TRY (props->trace_path = h5_strdup (path));
+        props->flags |= H5_IO_TRACE;
+        H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5_set_prop_file_mesh_partitioner (
+        h5_prop_t _props,
+	const h5_int64_t partitioner
+        ) {
+        h5_prop_file_t* props = (h5_prop_file_t*)_props;
+        H5_CORE_API_ENTER (
+		h5_err_t,
+		"props=%p, partitioner=%lld",
+		props, (long long int)partitioner);
+        if (props->class != H5_PROP_FILE) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid property class: %lld",
+			(long long int)props->class);
+        }
+	if (partitioner != H5_PARTITIONER_PARMETIS &&
+	    partitioner != H5_PARTITIONER_SFC) {
+                H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid mesh partitioner: %lld",
+			(long long int)partitioner);
+	}
+#if defined(WITH_PARALLEL_H5GRID)
+	props->mesh_partitioner = partitioner;
+#else
+	h5_info ("Parallel mesh partitioning not available, "
+		 "property ignored.");
+#endif
+        H5_RETURN (H5_SUCCESS);
+}
+
 h5_prop_t
 h5_create_prop (
         const h5_int64_t class
@@ -408,6 +768,8 @@ h5_close_prop (
         case H5_PROP_FILE: {
                 h5_prop_file_t* file_prop = (h5_prop_file_t*)prop;
                 TRY (h5_free (file_prop->prefix_iteration_name));
+                TRY (h5_free (file_prop->stage_path));
+                TRY (h5_free (file_prop->trace_path));
                 break;
         }
         default:
@@ -419,6 +781,30 @@ h5_close_prop (
         H5_RETURN (h5_free (prop));
 }
 
+/*
+  Open an existing file. HDF5 refuses to open files without paged
+  file space allocation if a page buffer has been requested. In this
+  case we retry without page buffer.
+ */
+static inline hid_t
+open_existing_file (
+	const h5_file_p f,
+	const char* const filename,
+	const unsigned flags
+	) {
+	hid_t file = H5Fopen (filename, flags, f->props->access_prop);
+#if H5_VERSION_GE(1,10,1)
+	if (file < 0 && f->props->page_buf_size > 0) {
+		h5_info ("File '%s' has no paged file space, "
+			 "opening without page buffer.", filename);
+		if (hdf5_set_page_buffer_size (f->props->access_prop, 0) < 0)
+			return -1;
+		file = H5Fopen (filename, flags, f->props->access_prop);
+	}
+#endif
+	return file;
+}
+
 static inline h5_err_t
 open_file (
 	const h5_file_p f,
@@ -445,11 +831,14 @@ open_file (
         
         f->props->xfer_prop = f->props->access_prop = H5P_DEFAULT;
         TRY (f->props->create_prop = hdf5_create_property (H5P_FILE_CREATE));
-	TRY (mpi_init (f));              // noop if serial
+	TRY (f->props->access_prop = hdf5_create_property (H5P_FILE_ACCESS));
+	TRY (mpi_init (f));              // selects VFD
+	TRY (h5priv_tune_for_fs (f, filename));
 	TRY (set_alignment (f));
+	TRY (set_metadata_props (f));
 
 	if (f->props->flags & H5_O_RDONLY) {
-		f->file = H5Fopen (filename, H5F_ACC_RDONLY, f->props->access_prop);
+		f->file = open_existing_file (f, filename, H5F_ACC_RDONLY);
 	}
 	else if (f->props->flags & H5_O_WRONLY){
 		f->file = H5Fcreate (
@@ -467,8 +856,7 @@ open_file (
 		}
 		else if (fd != -1) {
 			close (fd);
-			f->file = H5Fopen (filename, H5F_ACC_RDWR,
-					   f->props->access_prop);
+			f->file = open_existing_file (f, filename, H5F_ACC_RDWR);
 		}
 	}
 	else {
@@ -487,6 +875,9 @@ open_file (
 
 	TRY (h5upriv_open_file (f));
 	TRY (h5bpriv_open_file (f));
+	TRY (h5priv_start_staging (f, filename));
+	TRY (h5priv_start_prefetch (f, filename));
+	TRY (h5priv_start_trace (f));
 
 	H5_RETURN (H5_SUCCESS);
 }
@@ -520,6 +911,20 @@ h5_open_file2 (
                 f->props->flags = props->flags;
                 f->props->throttle = props->throttle;
                 f->props->align = props->align;
+                f->props->mdc_size = props->mdc_size;
+                f->props->page_size = props->page_size;
+                f->props->page_buf_size = props->page_buf_size;
+                f->props->increment = props->increment;
+                f->props->stage_mem_cap = props->stage_mem_cap;
+                f->props->prefetch_mem_cap = props->prefetch_mem_cap;
+                f->props->attach_compression = props->attach_compression;
+                f->props->mesh_partitioner = props->mesh_partitioner;
+                if (props->stage_path) {
+                        TRY (f->props->stage_path = h5_strdup (props->stage_path));
+                }
+                if (props->trace_path) {
+                        TRY (f->props->trace_path = h5_strdup (props->trace_path));
+                }
 
                 strncpy (
                         f->props->prefix_iteration_name,
@@ -596,6 +1001,10 @@ h5_close_file (
 	check_file_handle_is_valid (f);
 
 	TRY (h5priv_close_iteration (f));
+	TRY (h5priv_stop_prefetch (f));
+	TRY (h5priv_close_mmap (f));
+	TRY (h5priv_free_attrib_cache (f));
+	TRY (h5priv_stop_trace (f));
 	TRY (h5upriv_close_file (f));
 	TRY (h5bpriv_close_file (f));
 	TRY (hdf5_close_property (f->props->xfer_prop));
@@ -603,8 +1012,10 @@ h5_close_file (
 	TRY (hdf5_close_property (f->props->create_prop));
 	TRY (hdf5_close_group (f->root_gid));
         TRY (hdf5_flush (f->file, H5F_SCOPE_GLOBAL));
+	TRY (h5priv_stage_file (f, 1));
         TRY (h5_close_prop ((h5_prop_t)f->props));
 	TRY (hdf5_close_file (f->file));
+	TRY (h5priv_stop_staging (f));
         TRY (h5_free (f->iteration_name));
  	TRY (h5_free (f));
 	H5_RETURN (H5_SUCCESS);
@@ -615,6 +1026,7 @@ h5_close_h5hut (
         void
         ) {
 	H5_CORE_API_ENTER (h5_err_t, "%s", "");
+	TRY (h5_report_alloc_stats ());
 	TRY (h5_finalize ());
 	TRY (hdf5_close ());
 	H5_RETURN (H5_SUCCESS);
@@ -11,6 +11,7 @@
 #include <stdarg.h>     /* va_arg - System dependent ?! */
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
 
 #include "private/h5_hdf5.h"
 
@@ -737,14 +738,26 @@ _h5_exit (int status) {
 	return H5_ERR;
 }
 
-h5_err_t
-h5_initialize (
+/*
+  H5hut may be called from several threads. Initialization is done
+  exactly once with pthread_once(). Functions called during
+  initialization may call h5_initialize() again, these recursive calls
+  are detected with a thread local flag and return immediately.
+
+  HDF5 itself is not required to be thread-safe. All API calls are
+  therefore serialized with a recursive lock, acquired in
+  H5_API_ENTER and released in H5_API_RETURN. Call stack, error number
+  and debug mask are kept per thread.
+ */
+static pthread_once_t		h5_init_once = PTHREAD_ONCE_INIT;
+static H5_THREAD_LOCAL int	h5_initializing = 0;
+static h5_err_t			h5_init_status = H5_ERR;
+static pthread_mutex_t		h5_api_mutex;
+
+static h5_err_t
+initialize (
         void
         ) {
-	if (h5_initialized) return 0;
-	memset (&h5_call_stack, 0, sizeof (h5_call_stack));
-	// must be set here, otherwise next statement will fail!
-	h5_initialized = 1;
 	H5_PRIV_FUNC_ENTER (h5_err_t, "%s", "void");
 	ret_value = H5_SUCCESS;
 #ifdef H5_HAVE_PARALLEL
@@ -782,6 +795,45 @@ h5_initialize (
 	H5_RETURN ((ret_value != H5_SUCCESS) ? _h5_exit (42) : H5_SUCCESS);
 }
 
+static void
+initialize_once (
+        void
+        ) {
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init (&attr);
+	pthread_mutexattr_settype (&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init (&h5_api_mutex, &attr);
+	pthread_mutexattr_destroy (&attr);
+
+	h5_initializing = 1;
+	h5_init_status = initialize ();
+	h5_initializing = 0;
+	h5_initialized = 1;
+}
+
+h5_err_t
+h5_initialize (
+        void
+        ) {
+	if (h5_initializing) return H5_SUCCESS;
+	pthread_once (&h5_init_once, initialize_once);
+	return h5_init_status;
+}
+
+void
+h5_api_lock (
+        void
+        ) {
+	pthread_mutex_lock (&h5_api_mutex);
+}
+
+void
+h5_api_unlock (
+        void
+        ) {
+	pthread_mutex_unlock (&h5_api_mutex);
+}
+
 h5_err_t
 h5_finalize (
 	void
@@ -14,9 +14,9 @@ extern int h5_myproc;
 
 
 h5_int64_t			__h5_log_level = H5_VERBOSE_ERROR;
-h5_int64_t			__h5_debug_mask = 0;
+H5_THREAD_LOCAL h5_int64_t	__h5_debug_mask = 0;
 
-struct call_stack		h5_call_stack;
+H5_THREAD_LOCAL struct call_stack h5_call_stack;
 
 char *h5_rfmts[] = {
 	[e_int]			= "%d",
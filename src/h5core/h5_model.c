@@ -13,6 +13,8 @@
 #include "private/h5_types.h"
 #include "private/h5_hdf5.h"
 #include "private/h5_model.h"
+#include "private/h5_prefetch.h"
+#include "private/h5_staging.h"
 
 h5_err_t
 h5priv_close_iteration (
@@ -38,7 +40,12 @@ h5_set_iteration (
                            "f=%p, iteration_idx=%lld",
                            f, (long long)iteration_idx);
 	CHECK_FILEHANDLE (f);
+	int completed = f->iteration_gid > 0;
 	TRY (h5priv_close_iteration (f));
+	if (completed) {
+		// hand completed iteration to background writer
+		TRY (h5priv_stage_file (f, 0));
+	}
 	f->iteration_idx = iteration_idx;
 
 	sprintf (
@@ -46,6 +53,7 @@ h5_set_iteration (
 		"%s#%0*lld",
 		f->props->prefix_iteration_name, f->props->width_iteration_idx,
                 (long long) f->iteration_idx);
+	TRY (h5priv_prefetch_set_iteration (f));
 	h5_info (
 		"Open iteration #%lld in file %lld",
 		(long long)f->iteration_idx,
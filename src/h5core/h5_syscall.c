@@ -12,6 +12,9 @@
 
 #include <stdlib.h>
 #include <string.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 #include "h5core/h5_types.h"
 #include "private/h5_log.h"
@@ -23,13 +26,81 @@ extern "C" {
 #define MALLOC_WRAPPER_ENTER(type, fmt, ...)			\
 	__FUNC_ENTER(type, H5_DEBUG_MALLOC, fmt, __VA_ARGS__)
 
+/*
+  All memory is allocated via the allocator set with
+  h5_set_allocator(), the default allocator uses the C library. The
+  statistics are updated under the API lock.
+ */
+static void*
+libc_realloc (
+	void* ctx,
+	void* ptr,
+	const size_t size
+	) {
+	(void)ctx;
+	return realloc (ptr, size);
+}
+
+static void
+libc_free (
+	void* ctx,
+	void* ptr
+	) {
+	(void)ctx;
+	free (ptr);
+}
+
+#ifdef __GLIBC__
+static size_t
+libc_size (
+	void* ctx,
+	void* ptr
+	) {
+	(void)ctx;
+	return malloc_usable_size (ptr);
+}
+#else
+#define libc_size NULL
+#endif
+
+static const h5_allocator_t libc_allocator = {
+	libc_realloc, libc_free, libc_size, NULL
+};
+
+static h5_allocator_t allocator = {
+	libc_realloc, libc_free, libc_size, NULL
+};
+
+static h5_alloc_stats_t stats;
+static h5_int64_t num_blocks = 0;	// number of allocated blocks
+
+static inline size_t
+block_size (
+	void* ptr
+	) {
+	return (ptr && allocator.size) ? allocator.size (allocator.ctx, ptr) : 0;
+}
+
+static inline void
+count_in_use (
+	const size_t freed,
+	const size_t allocated
+	) {
+	stats.in_use += (h5_int64_t)allocated - (h5_int64_t)freed;
+	if (stats.in_use > stats.peak)
+		stats.peak = stats.in_use;
+}
+
 h5_err_t
 h5_free (
         void* ptr
         ) {
 	MALLOC_WRAPPER_ENTER (h5_err_t, "ptr=%p", ptr);
 	if (ptr) {
-		free (ptr);
+		count_in_use (block_size (ptr), 0);
+		stats.frees++;
+		num_blocks--;
+		allocator.free (allocator.ctx, ptr);
 	}
 	H5_RETURN (H5_SUCCESS);
 }
@@ -45,14 +116,23 @@ h5_alloc (
 		ret_value = (void_p) h5_free (ptr);
 		H5_LEAVE (NULL);
 	}
-	ptr = realloc (ptr, size);
-	if (ptr == NULL) {
+	size_t old_size = block_size (ptr);
+	void* new_ptr = allocator.realloc (allocator.ctx, ptr, size);
+	if (new_ptr == NULL) {
 		H5_LEAVE (
 		        (void_p)h5_error (
 				H5_ERR_NOMEM,
 				"Out of memory. Tried to alloc %lld", (long long int)size));
 	}
-	H5_RETURN (ptr);
+	if (ptr) {
+		stats.reallocs++;
+	} else {
+		stats.allocs++;
+		num_blocks++;
+	}
+	stats.bytes += (h5_int64_t)size;
+	count_in_use (old_size, block_size (new_ptr));
+	H5_RETURN (new_ptr);
 }
 
 void_p
@@ -65,17 +145,18 @@ h5_calloc (
 	if (count * size < 1) {
 		H5_LEAVE (ptr);
 	}
-	ptr = calloc (count, size);
-	if (ptr == NULL) {
+	if (size > (size_t)-1 / count) {
 		H5_LEAVE (
 		        (void_p)h5_error (
 				H5_ERR_NOMEM,
-				"Out of memory. Tried to alloc %lld", (long long int)count* size));
+				"Out of memory. Tried to alloc %zu times %zu bytes",
+				count, size));
 	}
+	TRY (ptr = h5_alloc (NULL, count * size));
+	memset (ptr, 0, count * size);
 	H5_RETURN (ptr);
 }
 
-
 char_p
 h5_strdup (
         const char* s1
@@ -92,6 +173,67 @@ h5_strdup (
 	H5_RETURN (strcpy (s2, s1));
 }
 
+/*
+  Set allocator, NULL restores the default allocator. The allocator can
+  only be changed while no memory is allocated by H5hut, i.e. before
+  opening the first file.
+ */
+h5_err_t
+h5_set_allocator (
+	const h5_allocator_t* new_allocator
+	) {
+	H5_CORE_API_ENTER (h5_err_t, "allocator=%p", new_allocator);
+	if (num_blocks != 0) {
+		H5_LEAVE (
+			h5_error (
+				H5_ERR_INVAL,
+				"Cannot change allocator: "
+				"%lld blocks are still allocated.",
+				(long long)num_blocks));
+	}
+	if (new_allocator == NULL) {
+		new_allocator = &libc_allocator;
+	} else if (new_allocator->realloc == NULL || new_allocator->free == NULL) {
+		H5_LEAVE (
+			h5_error (
+				H5_ERR_INVAL,
+				"%s",
+				"Allocator must provide realloc and free."));
+	}
+	allocator = *new_allocator;
+	memset (&stats, 0, sizeof (stats));
+	H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5_get_alloc_stats (
+	h5_alloc_stats_t* const s
+	) {
+	H5_CORE_API_ENTER (h5_err_t, "stats=%p", s);
+	*s = stats;
+	H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5_report_alloc_stats (
+	void
+	) {
+	H5_CORE_API_ENTER (h5_err_t, "%s", "void");
+	if (allocator.size) {
+		h5_info ("Memory: %lld allocs, %lld reallocs, %lld frees, "
+			 "%lld bytes requested, %lld bytes in use, peak %lld bytes",
+			 (long long)stats.allocs, (long long)stats.reallocs,
+			 (long long)stats.frees, (long long)stats.bytes,
+			 (long long)stats.in_use, (long long)stats.peak);
+	} else {
+		h5_info ("Memory: %lld allocs, %lld reallocs, %lld frees, "
+			 "%lld bytes requested",
+			 (long long)stats.allocs, (long long)stats.reallocs,
+			 (long long)stats.frees, (long long)stats.bytes);
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
 #ifdef __cplusplus
 }
 #endif
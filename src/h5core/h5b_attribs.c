@@ -10,6 +10,7 @@
 
 #include "private/h5_hdf5.h"
 #include "private/h5_attribs.h"
+#include "private/h5_attrib_cache.h"
 #include "private/h5b_types.h"
 #include "private/h5b_model.h"
 
@@ -36,6 +37,9 @@ h5b_write_field_attrib (
 	check_iteration_is_writable (f);
 
 	TRY( h5bpriv_create_field_group(f, field_name) );
+	TRY (h5priv_invalidate_attrib_cache (f, f->b->field_gid));
+	TRY (h5priv_remove_table_attrib (
+		     f->b->field_gid, attrib_name, is_appendonly (f)));
 	if (is_appendonly (f)) {
 		TRY (h5priv_append_attrib (
 			     f->b->field_gid,
@@ -76,8 +80,8 @@ h5b_read_field_attrib (
 
 	TRY (h5bpriv_open_field_group(f, field_name));
 
-	TRY (h5priv_read_attrib (
-		     f->b->field_gid,
+	TRY (h5priv_cached_read_attrib (
+		     f, f->b->field_gid,
 		     attrib_name,
 		     attrib_type,
 		     buffer));
@@ -85,6 +89,52 @@ h5b_read_field_attrib (
 	H5_RETURN (H5_SUCCESS);
 }
 
+h5_err_t
+h5b_write_field_attribs (
+	const h5_file_t fh,			/*!< IN: file handle */
+	const char* const field_name,		/*!< IN: field name */
+	const h5_attrib_t* const attribs,	/*!< IN: attribute table */
+	const h5_size_t num_attribs		/*!< IN: number of entries */
+	) {
+        h5_file_p f = (h5_file_p)fh;
+	H5_CORE_API_ENTER (h5_err_t,
+	                   "f=%p, field_name='%s', "
+	                   "attribs=%p, num_attribs=%llu",
+	                   f,
+	                   field_name,
+	                   attribs,
+	                   (long long unsigned)num_attribs);
+	check_iteration_is_writable (f);
+
+	TRY (h5bpriv_create_field_group (f, field_name));
+	TRY (h5priv_invalidate_attrib_cache (f, f->b->field_gid));
+	TRY (h5priv_write_attribs (
+		     f->b->field_gid,
+		     attribs,
+		     num_attribs,
+		     is_appendonly (f)));
+	H5_RETURN (H5_SUCCESS);
+}
+
+h5_ssize_t
+h5b_read_field_attribs (
+	const h5_file_t fh,			/*!< IN: file handle */
+	const char* const field_name,		/*!< IN: field name */
+	h5_attrib_t** const attribs		/*!< OUT: attribute table */
+	) {
+        h5_file_p f = (h5_file_p)fh;
+	H5_CORE_API_ENTER (h5_ssize_t,
+	                   "f=%p, field_name='%s', attribs=%p",
+	                   f,
+	                   field_name,
+	                   attribs);
+	check_iteration_is_readable (f);
+
+	TRY (h5bpriv_open_field_group (f, field_name));
+	TRY (ret_value = h5priv_read_attribs (f->b->field_gid, attribs));
+	H5_RETURN (ret_value);
+}
+
 h5_err_t
 h5b_has_field_attrib (
 	const h5_file_t fh,			/*!< IN: file handle */
@@ -103,7 +153,8 @@ h5b_has_field_attrib (
 
 	TRY (h5bpriv_open_field_group(f, field_name));
 
-	TRY (ret_value = hdf5_attribute_exists (
+	TRY (ret_value = h5priv_cached_attrib_exists (
+		     f,
 		     f->b->field_gid,
 		     attrib_name));	       
 	H5_RETURN (ret_value);
@@ -120,7 +171,7 @@ h5b_get_num_field_attribs (
 
 	TRY (h5bpriv_open_field_group(f, field_name));
 
-	TRY (ret_value = hdf5_get_num_attribute (f->b->field_gid));
+	TRY (ret_value = h5priv_cached_get_num_attribs (f, f->b->field_gid));
 	H5_RETURN (ret_value);
 }
 
@@ -148,8 +199,8 @@ h5b_get_field_attrib_info_by_idx (
 	                   attrib_type, attrib_nelem);
 	check_iteration_handle_is_valid (f);
 	TRY (h5bpriv_open_field_group(f, field_name));
-	TRY (ret_value = h5priv_get_attrib_info_by_idx (
-		     f->b->field_gid,
+	TRY (ret_value = h5priv_cached_get_attrib_info_by_idx (
+		     f, f->b->field_gid,
 		     attrib_idx,
 		     attrib_name, len_attrib_name,
 		     attrib_type, attrib_nelem));
@@ -176,8 +227,8 @@ h5b_get_field_attrib_info_by_name (
 	                   attrib_type, attrib_nelem);
 	check_iteration_handle_is_valid (f);
 	TRY (h5bpriv_open_field_group(f, field_name));
-	TRY (ret_value = h5priv_get_attrib_info_by_name (
-		     f->b->field_gid,
+	TRY (ret_value = h5priv_cached_get_attrib_info_by_name (
+		     f, f->b->field_gid,
 		     attrib_name,
 		     attrib_type, attrib_nelem));
 	H5_RETURN (ret_value);
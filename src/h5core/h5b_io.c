@@ -13,6 +13,7 @@
 #include "private/h5_model.h"
 #include "private/h5_mpi.h"
 #include "private/h5_io.h"
+#include "private/h5_prefetch.h"
 #include "private/h5b_types.h"
 #include "private/h5b_model.h"
 
@@ -232,12 +233,12 @@ write_data (
 		             b->dcreate_prop));
 	}
 	TRY (h5priv_start_throttle (f));
-	TRY (hdf5_write_dataset(
+	TRY (h5priv_trace_write (
+	             f, __func__,
 	             dataset,
 	             hdf5_data_type,
 	             b->memshape,
 	             b->diskshape,
-	             f->props->xfer_prop,
 	             data));
 	TRY (h5priv_end_throttle (f));
 	TRY (hdf5_close_dataset (dataset));
@@ -401,15 +402,21 @@ read_data (
 	}
 
 	TRY (select_hyperslab_for_reading (f, dataset) );
-	TRY (h5priv_start_throttle (f));
-	TRY (hdf5_read_dataset(
-	             dataset,
-	             hdf5_data_type,
-	             f->b->memshape,
-	             f->b->diskshape,
-	             f->props->xfer_prop,
-	             data));
-	TRY (h5priv_end_throttle (f));
+	h5_err_t prefetched;
+	TRY (prefetched = h5priv_read_prefetched (
+		     f, dataset, hdf5_data_type,
+		     f->b->memshape, f->b->diskshape, data));
+	if (!prefetched) {
+		TRY (h5priv_start_throttle (f));
+		TRY (h5priv_trace_read (
+			     f, __func__,
+			     dataset,
+			     hdf5_data_type,
+			     f->b->memshape,
+			     f->b->diskshape,
+			     data));
+		TRY (h5priv_end_throttle (f));
+	}
 	TRY (hdf5_close_dataset(dataset));
 
 	H5_RETURN (H5_SUCCESS);
@@ -9,6 +9,7 @@
 
 #include "private/h5_types.h"
 
+#include <math.h>
 #include <stdlib.h>
 #include <unistd.h> // for the use of sleep
 
@@ -41,6 +42,7 @@ int dont_use_parmetis = 0;
 #include "private/h5t_map.h"
 #include "private/h5t_adjacencies.h"
 #include "private/h5t_io.h"
+#include "private/h5t_profile.h"
 #include "private/h5t_store.h"
 #include "private/h5t_core.h"
 #include "private/h5_mpi.h"
@@ -85,6 +87,63 @@ hidxmap_compute_hval (
 	return hval;
 }
 
+/*
+   Levels already in the file are only appended to, if the mesh has
+   been read from or written to the file before.
+ */
+static inline int
+is_incremental_write (
+        h5t_mesh_t* const m
+        ) {
+	return m->num_written_levels > 0 &&
+		!(m->f->props->flags & H5_O_APPENDONLY);
+}
+
+/*
+   Write items [start, start+count) of buf to the dataset. Both, buf and
+   the dataset, have dsinfo->dims[0] items.
+ */
+static h5_err_t
+write_range (
+        h5t_mesh_t* const m,
+        const hid_t dset_id,
+        const h5_dsinfo_t* const dsinfo,
+        hsize_t start,
+        hsize_t count,
+        const void* const buf
+        ) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p, start=%llu, count=%llu",
+	                    m, (long long unsigned)start,
+	                    (long long unsigned)count);
+	hid_t mspace_id;
+	hid_t dspace_id;
+	hsize_t hstride = 1;
+	TRY (mspace_id = hdf5_create_dataspace (1, dsinfo->dims, NULL));
+	TRY (dspace_id = hdf5_create_dataspace (1, dsinfo->dims, NULL));
+	TRY (hdf5_select_hyperslab_of_dataspace (
+	             mspace_id,
+	             H5S_SELECT_SET,
+	             &start, &hstride, &count,
+	             NULL));
+	TRY (hdf5_select_hyperslab_of_dataspace (
+	             dspace_id,
+	             H5S_SELECT_SET,
+	             &start, &hstride, &count,
+	             NULL));
+	TRY (h5priv_start_throttle (m->f));
+	TRY (h5priv_trace_write (
+	             m->f, __func__,
+	             dset_id,
+	             dsinfo->type_id,
+	             mspace_id,
+	             dspace_id,
+	             buf));
+	TRY (h5priv_end_throttle (m->f));
+	TRY (hdf5_close_dataspace (dspace_id));
+	TRY (hdf5_close_dataspace (mspace_id));
+	H5_RETURN (H5_SUCCESS);
+}
+
 /*
    Write vertices:
  * either we write a new dataset
@@ -106,14 +165,29 @@ write_vertices (
 	}
 
 	m->dsinfo_vertices.dims[0] = m->num_loc_vertices[m->num_leaf_levels-1];
-	TRY( h5priv_write_dataset_by_name (
-				 m,
-	             m->f,
-	             m->mesh_gid,
-	             &m->dsinfo_vertices,
-	             open_space_all,
-	             open_space_all,
-	             m->vertices) );
+	if (is_incremental_write (m)) {
+		hsize_t first = m->num_loc_vertices[m->num_written_levels-1];
+		hid_t dset_id;
+		TRY (dset_id = hdf5_open_dataset_by_name (
+		             m->mesh_gid, m->dsinfo_vertices.name));
+		TRY (hdf5_set_dataset_extent (dset_id, m->dsinfo_vertices.dims));
+		if (first < m->dsinfo_vertices.dims[0]) {
+			TRY (write_range (
+			             m, dset_id, &m->dsinfo_vertices,
+			             first, m->dsinfo_vertices.dims[0] - first,
+			             m->vertices));
+		}
+		TRY (hdf5_close_dataset (dset_id));
+	} else {
+		TRY( h5priv_write_dataset_by_name (
+			     m,
+			     m->f,
+			     m->mesh_gid,
+			     &m->dsinfo_vertices,
+			     open_space_all,
+			     open_space_all,
+			     m->vertices) );
+	}
 
 	TRY (h5priv_write_attrib (
 	             m->mesh_gid,
@@ -264,6 +338,18 @@ linsearch (
 	return NULL;
 }
 
+static int
+cmp_glb_idx (
+        const void* x,
+        const void* y
+        ) {
+	if (*(h5_glb_idx_t*)x < *(h5_glb_idx_t*)y) return -1;
+	if (*(h5_glb_idx_t*)x > *(h5_glb_idx_t*)y) return 1;
+
+	return 0;
+}
+
+
 #if defined(WITH_PARALLEL_H5GRID)
 static int
 sort_glb_idx (
@@ -394,7 +480,7 @@ get_map_vertices_write (
 		}
 	}
 	TRY (h5priv_hdestroy (&htab));
-	h5priv_sort_idxmap (map);
+	TRY (h5priv_sort_idxmap (map));
 
 	h5_glb_idx_t* range = NULL;
 	h5_glb_idx_t* glb_vtx = NULL;
@@ -406,7 +492,7 @@ get_map_vertices_write (
 	TRY (check_multiple_vtx_writes (m, map, range, glb_vtx));
 
 
-	h5priv_sort_idxmap (map);
+	TRY (h5priv_sort_idxmap (map));
 	TRY (h5_free (range));
 	TRY (h5_free (glb_vtx));
 
@@ -426,17 +512,31 @@ write_vertices_chk (
 	hid_t dspace_id;
 
 
+	TRY (h5tpriv_profile_begin (m, "calc_vtx_map"));
 	h5_idxmap_t map_r;
 	TRY (h5priv_new_idxmap (&map_r, m->num_loc_vertices[m->num_leaf_levels-1] + 128));
 	h5_idxmap_t* map = &map_r;
 	get_map_vertices_write (m, map);
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
+	if (is_incremental_write (m)) {
+		// vertices in file are never changed
+		h5_glb_idx_t first = m->num_glb_vertices[m->num_written_levels-1];
+		h5_size_t num_new = 0;
+		for (h5_size_t i = 0; i < map->num_items; i++) {
+			if (map->items[i].glb_idx >= first)
+				map->items[num_new++] = map->items[i];
+		}
+		map->num_items = num_new;
+	}
+	TRY (h5tpriv_profile_end (m, "calc_vtx_map"));
+	TRY (h5tpriv_profile_begin (m, "select_hyperslabs"));
 	// create memspace
 	hsize_t num_loc_vertices = m->num_loc_vertices[m->leaf_level];
 	TRY (mspace_id = hdf5_create_dataspace(1, &num_loc_vertices, NULL));
 	// add memspace
 	hsize_t hstride = 1;
+	if (map->num_items == 0) {
+		TRY (hdf5_select_none (mspace_id));
+	}
 	H5S_seloper_t seloper = H5S_SELECT_SET; // first selection
 	for (hsize_t i = 0; i < map->num_items; i++) {
 		hsize_t hstart = map->items[i].loc_idx;
@@ -460,6 +560,9 @@ write_vertices_chk (
 	TRY (hdf5_set_dataset_extent (dset_id, &num_glb_vertices));
 	H5Sset_extent_simple(dspace_id, 1,m->dsinfo_vertices.dims, NULL); //TODO WRITE WRAPPER
 
+	if (map->num_items == 0) {
+		TRY (hdf5_select_none (dspace_id));
+	}
 	seloper = H5S_SELECT_SET; // first selection
 	for (hsize_t i = 0; i < map->num_items; i++) {
 		hsize_t hstart = map->items[i].glb_idx;
@@ -475,8 +578,7 @@ write_vertices_chk (
 			             NULL));
 		seloper = H5S_SELECT_OR;
 	}
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
+	TRY (h5tpriv_profile_end (m, "select_hyperslabs"));
 	TRY (h5priv_start_throttle (m->f));
 
 	TRY( h5priv_write_dataset_by_name_id (
@@ -512,6 +614,7 @@ write_vertices_chk (
 	TRY (hdf5_close_dataspace (dspace_id));
 	TRY (hdf5_close_dataspace (mspace_id));
 	TRY (hdf5_close_dataset (dset_id));
+	TRY (h5priv_free_idxmap (map));
 	m->f->empty = 0;
 
 	H5_RETURN (H5_SUCCESS);
@@ -528,6 +631,54 @@ write_elems (
 #else
 
 // SERIAL WRITE
+#define ELEM_BLOCK_SIZE	(1 << 16)	// max elements written at once
+#define ELEM_MAX_GAP	256		// write through smaller gaps
+
+/*
+   Write elements created since the mesh has been written or read and
+   elements in the file which have been refined since then. For the
+   latter only the child index has changed. They are written in blocks,
+   small gaps between them are written again.
+ */
+static h5_err_t
+write_new_elems (
+        h5t_mesh_t* const m,
+        const h5_glb_elem_t* const glb_elems
+        ) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p", m);
+	h5_loc_idx_t first = m->num_interior_elems[m->num_written_levels-1];
+	h5_loc_idx_t num_elems = m->dsinfo_elems.dims[0];
+	hid_t dset_id;
+	TRY (dset_id = hdf5_open_dataset_by_name (m->mesh_gid, m->dsinfo_elems.name));
+	TRY (hdf5_set_dataset_extent (dset_id, m->dsinfo_elems.dims));
+
+	h5_loc_idx_t i = 0;
+	while (i < first) {
+		if (h5tpriv_get_loc_elem_child_idx (m, i) < first) {
+			i++;
+			continue;
+		}
+		h5_loc_idx_t last = i;
+		for (h5_loc_idx_t j = i + 1;
+		     j < first && j - i < ELEM_BLOCK_SIZE && j - last <= ELEM_MAX_GAP;
+		     j++) {
+			if (h5tpriv_get_loc_elem_child_idx (m, j) >= first)
+				last = j;
+		}
+		TRY (write_range (
+		             m, dset_id, &m->dsinfo_elems,
+		             i, last - i + 1, glb_elems));
+		i = last + 1;
+	}
+	if (first < num_elems) {
+		TRY (write_range (
+		             m, dset_id, &m->dsinfo_elems,
+		             first, num_elems - first, glb_elems));
+	}
+	TRY (hdf5_close_dataset (dset_id));
+	H5_RETURN (H5_SUCCESS);
+}
+
 static h5_err_t
 write_elems (
         h5t_mesh_t* const m
@@ -542,14 +693,18 @@ write_elems (
 	TRY (h5tpriv_init_glb_elems_struct (m, glb_elems));
 
 	m->dsinfo_elems.dims[0] = num_interior_elems;
-	TRY (h5priv_write_dataset_by_name (
-				 m,
-	             m->f,
-	             m->mesh_gid,
-	             &m->dsinfo_elems,
-	             open_space_all,
-	             open_space_all,
-	             glb_elems));
+	if (is_incremental_write (m)) {
+		TRY (write_new_elems (m, glb_elems));
+	} else {
+		TRY (h5priv_write_dataset_by_name (
+			     m,
+			     m->f,
+			     m->mesh_gid,
+			     &m->dsinfo_elems,
+			     open_space_all,
+			     open_space_all,
+			     glb_elems));
+	}
 
 	TRY (h5priv_write_attrib (
 	             m->mesh_gid,
@@ -590,6 +745,33 @@ write_elems (
 }
 #endif
 #ifdef WITH_PARALLEL_H5GRID
+/*
+   Return true if chunk contains elements created or refined since the
+   mesh has been written or read. Elements with global index >= first
+   are new.
+ */
+static int
+is_chunk_changed (
+        h5t_mesh_t* const m,
+        const h5_chk_idx_t chk_idx,
+        const h5_glb_idx_t first
+        ) {
+	h5_glb_idx_t glb_idx = m->chunks->chunks[chk_idx].elem;
+	h5_glb_idx_t end = glb_idx + m->chunks->chunks[chk_idx].num_elems;
+	if (end > first) {
+		return 1;
+	}
+	for (; glb_idx < end; glb_idx++) {
+		h5_loc_idx_t loc_idx = h5t_map_glb_elem_idx2loc (m, glb_idx);
+		h5_loc_idx_t child_idx = h5tpriv_get_loc_elem_child_idx (m, loc_idx);
+		if (child_idx >= 0 &&
+		    h5tpriv_get_loc_elem_glb_idx (m, child_idx) >= first) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
 //TODO maybe use ifdef to have name without _chk
 static h5_err_t
 write_elems_chk (
@@ -602,6 +784,16 @@ write_elems_chk (
 	int num_chk = 0;
 	// get my chunks to write
 	TRY (h5tpriv_get_list_of_chunks_to_write(m, &chk_list, &num_chk));
+	if (is_incremental_write (m)) {
+		// elements in file only change if they are refined
+		h5_glb_idx_t first = m->num_glb_elems[m->num_written_levels-1];
+		int num_changed = 0;
+		for (int i = 0; i < num_chk; i++) {
+			if (is_chunk_changed (m, chk_list[i], first))
+				chk_list[num_changed++] = chk_list[i];
+		}
+		num_chk = num_changed;
+	}
 
 	hsize_t num_elems = 0;
 	for (int i = 0; i < num_chk; i++) {
@@ -622,11 +814,15 @@ write_elems_chk (
 	hsize_t hstride = 1;
 	hsize_t hcount = num_elems;
 	TRY (mspace_id = hdf5_create_dataspace (1, &num_elems, NULL));
-	TRY (hdf5_select_hyperslab_of_dataspace (
-				             mspace_id,
-				             H5S_SELECT_SET,
-				             &hstart, &hstride, &hcount,
-				             NULL));
+	if (num_elems > 0) {
+		TRY (hdf5_select_hyperslab_of_dataspace (
+			     mspace_id,
+			     H5S_SELECT_SET,
+			     &hstart, &hstride, &hcount,
+			     NULL));
+	} else {
+		TRY (hdf5_select_none (mspace_id));
+	}
 
 
 	// create diskspace and select subset
@@ -637,7 +833,10 @@ write_elems_chk (
 	H5Sset_extent_simple(dspace_id, 1,m->dsinfo_elems.dims, NULL); //TODO WRITE WRAPPER
 
 
-	hsize_t hnext = h5tpriv_get_glb_elem_idx(m, glb_elems, 0);
+	if (num_elems == 0) {
+		TRY (hdf5_select_none (dspace_id));
+	}
+	hsize_t hnext = num_elems > 0 ? h5tpriv_get_glb_elem_idx(m, glb_elems, 0) : 0;
 	hsize_t hcurr = 0;
 	// with those two variables the number of func calls can be reduced 3 times!
 	H5S_seloper_t seloper = H5S_SELECT_SET; // first selection
@@ -1026,55 +1225,286 @@ write_weights (
 }
 #endif
 
+static h5_err_t
+write_mesh (
+        h5t_mesh_t* const m
+        ) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p", m);
+	TRY (h5tpriv_profile_begin (m, "write_mesh"));
+	if (m->is_chunked) {
+#ifdef WITH_PARALLEL_H5GRID
+		if (m->num_weights > 0) {
+			TRY (h5tpriv_profile_begin (m, "write_weights"));
+			TRY (write_weights (m));
+			TRY (h5tpriv_profile_end (m, "write_weights"));
+		}
+		TRY (h5tpriv_profile_begin (m, "write_chunks"));
+		TRY (write_chunks (m));
+		TRY (h5tpriv_profile_end (m, "write_chunks"));
+		TRY (h5tpriv_profile_begin (m, "write_octree"));
+		TRY (write_octree (m));
+		TRY (h5tpriv_profile_end (m, "write_octree"));
+		TRY (h5tpriv_profile_begin (m, "write_vertices"));
+		TRY (m->f->nprocs > 1 ?
+		     write_vertices_chk (m) : write_vertices (m));
+		TRY (h5tpriv_profile_end (m, "write_vertices"));
+		TRY (h5tpriv_profile_begin (m, "write_elems"));
+		TRY (m->f->nprocs > 1 ?
+		     write_elems_chk (m) : write_elems (m));
+		TRY (h5tpriv_profile_end (m, "write_elems"));
+#endif			
+	} else {
+		TRY (h5tpriv_profile_begin (m, "write_vertices"));
+		TRY (write_vertices (m));
+		TRY (h5tpriv_profile_end (m, "write_vertices"));
+		TRY (h5tpriv_profile_begin (m, "write_elems"));
+		TRY (write_elems (m));
+		TRY (h5tpriv_profile_end (m, "write_elems"));
+	}
+	TRY (h5tpriv_profile_end (m, "write_mesh"));
+	m->num_written_levels = m->num_leaf_levels;
+	m->mesh_changed = 0;
+	H5_RETURN (H5_SUCCESS);
+}
+
 h5_err_t
 h5tpriv_write_mesh (
         h5t_mesh_t* const m
         ) {
 	H5_PRIV_API_ENTER (h5_err_t, "m=%p", m);
 	if (m->mesh_changed) {
-		if (m->is_chunked) {
-#ifdef WITH_PARALLEL_H5GRID
-			if (m->num_weights > 0) {
-				TRY (write_weights (m));
-			}
-			TRY (h5priv_mpi_barrier (m->f->props->comm));
-			m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-			TRY (write_chunks (m));
-			TRY (h5priv_mpi_barrier (m->f->props->comm));
-			m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-			TRY (write_octree (m));
-			TRY (h5priv_mpi_barrier (m->f->props->comm));
-			m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-			if (m->f->nprocs > 1) {
-				TRY (write_vertices_chk (m));
-				TRY (h5priv_mpi_barrier (m->f->props->comm));
-				m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-				TRY (write_elems_chk (m));
-				TRY (h5priv_mpi_barrier (m->f->props->comm));
-				m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-			} else {
-				TRY (write_vertices (m));
-				TRY (h5priv_mpi_barrier (m->f->props->comm));
-				m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-				TRY (write_elems (m));
-				TRY (h5priv_mpi_barrier (m->f->props->comm));
-				m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-			}
-#endif			
-		} else {
-			TRY (write_vertices (m));
-			TRY (write_elems (m));
+		int depth = h5tpriv_profile_depth (m);
+		if (write_mesh (m) < 0) {
+			TRY (h5tpriv_profile_unwind (m, depth));
+			H5_LEAVE (H5_ERR);
 		}
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+// ANCHOR WRITE
+/*
+   Read vertices with global indices in [start, start+count) into buf.
+ */
+static h5_err_t
+read_vertex_range (
+        h5t_mesh_t* const m,
+        const hid_t dset_id,
+        hsize_t start,
+        hsize_t count,
+        h5_loc_vertex_t* buf
+        ) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p, start=%llu, count=%llu",
+	                    m, (long long unsigned)start,
+	                    (long long unsigned)count);
+	hid_t mspace_id;
+	hid_t dspace_id;
+	hsize_t num_glb_vertices = m->num_glb_vertices[m->num_leaf_levels-1];
+	hsize_t num_mem = count > 0 ? count : 1;
+	TRY (mspace_id = hdf5_create_dataspace (1, &num_mem, NULL));
+	TRY (dspace_id = hdf5_create_dataspace (1, &num_glb_vertices, NULL));
+	h5_loc_vertex_t dummy;
+	if (count > 0) {
+		hsize_t hstride = 1;
+		TRY (hdf5_select_hyperslab_of_dataspace (
+		             dspace_id,
+		             H5S_SELECT_SET,
+		             &start, &hstride, &count,
+		             NULL));
+	} else {
+		// take part in collective read
+		TRY (hdf5_select_none (mspace_id));
+		TRY (hdf5_select_none (dspace_id));
+		buf = &dummy;
+	}
+	TRY (h5priv_start_throttle (m->f));
+	TRY (h5priv_trace_read (
+	             m->f, "read_vertices",
+	             dset_id,
+	             m->dsinfo_vertices.type_id,
+	             mspace_id,
+	             dspace_id,
+	             buf));
+	TRY (h5priv_end_throttle (m->f));
+	TRY (hdf5_close_dataspace (dspace_id));
+	TRY (hdf5_close_dataspace (mspace_id));
+	H5_RETURN (H5_SUCCESS);
+}
 
+#define VERTEX_BLOCK_SIZE	(1 << 16)	// max vertices read at once
+#define VERTEX_MAX_GAP		256		// read through smaller gaps
 
+/*
+   Read vertices given in map block by block. Runs of vertices with
+   small gaps are read with one contiguous selection into a staging
+   buffer and the vertices in the map are gathered from it.
 
+   The number of blocks depends on the map. With collective transfers
+   every proc must issue the same number of reads, procs with fewer
+   blocks take part in the remaining reads with an empty selection.
+ */
+static h5_err_t
+read_vertices_blocked (
+        h5t_mesh_t* const m,
+        const hid_t dset_id,
+        const h5_idxmap_t* const map
+        ) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p, map=%p", m, map);
+	h5_loc_vertex_t* block;
+	TRY (block = h5_calloc (VERTEX_BLOCK_SIZE, sizeof (*block)));
+	h5_int64_t num_reads = 0;
+	h5_size_t i = 0;
+	while (i < map->num_items) {
+		h5_glb_idx_t first = map->items[i].glb_idx;
+		h5_size_t j = i + 1;
+		while (j < map->num_items &&
+		       map->items[j].glb_idx - first < VERTEX_BLOCK_SIZE &&
+		       map->items[j].glb_idx - map->items[j-1].glb_idx <= VERTEX_MAX_GAP) {
+			j++;
+		}
+		hsize_t count = map->items[j-1].glb_idx - first + 1;
+		num_reads++;
+		if (count == j - i) {
+			// contiguous: read directly
+			TRY (read_vertex_range (m, dset_id, first, count, &m->vertices[i]));
+			i = j;
+			continue;
+		}
+		TRY (read_vertex_range (m, dset_id, first, count, block));
+		for (; i < j; i++) {
+			m->vertices[i] = block[map->items[i].glb_idx - first];
+		}
 	}
+#ifdef H5_HAVE_PARALLEL
+	if (m->f->nprocs > 1 && (m->f->props->flags & H5_VFD_MPIO_COLLECTIVE)) {
+		h5_int64_t max_reads;
+		TRY (h5priv_mpi_allreduce_max (
+		             &num_reads, &max_reads, 1, MPI_LONG_LONG,
+		             m->f->props->comm));
+		for (; num_reads < max_reads; num_reads++) {
+			TRY (read_vertex_range (m, dset_id, 0, 0, block));
+		}
+	}
+#endif
+	TRY (h5_free (block));
 	H5_RETURN (H5_SUCCESS);
 }
-// ANCHOR WRITE
+
+#if defined(WITH_PARALLEL_H5GRID)
+/*
+   First global vertex index of the contiguous slice read by proc.
+ */
+static inline h5_glb_idx_t
+first_vertex_of_slice (
+        const h5_glb_idx_t num_glb_vertices,
+        const int proc,
+        const int nprocs
+        ) {
+	return (h5_glb_idx_t)(((uint64_t)num_glb_vertices * (uint64_t)proc) / (uint64_t)nprocs);
+}
+
+/*
+   Read vertices given in map into vertices. Each proc reads a contiguous
+   slice of the vertices, the vertices in the map are requested from the
+   procs owning the slices containing them. The map must be sorted.
+ */
+static h5_err_t
+read_vertices_distributed (
+        h5t_mesh_t* const m,
+        const hid_t dset_id,
+        const h5_idxmap_t* const map,
+        h5_loc_vertex_t* const vertices
+        ) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p, map=%p", m, map);
+	int nprocs = m->f->nprocs;
+	int myproc = m->f->myproc;
+	MPI_Comm comm = m->f->props->comm;
+	h5_glb_idx_t num_glb_vertices = m->num_glb_vertices[m->num_leaf_levels-1];
+
+	h5_glb_idx_t start = first_vertex_of_slice (num_glb_vertices, myproc, nprocs);
+	h5_glb_idx_t end = first_vertex_of_slice (num_glb_vertices, myproc+1, nprocs);
+	h5_loc_vertex_t* slice;
+	TRY (slice = h5_calloc (end - start + 1, sizeof (*slice)));
+	TRY (read_vertex_range (m, dset_id, start, end - start, slice));
+
+	int* sendcounts;
+	int* senddispls;
+	int* recvcounts;
+	int* recvdispls;
+	TRY (sendcounts = h5_calloc (nprocs, sizeof (*sendcounts)));
+	TRY (senddispls = h5_calloc (nprocs, sizeof (*senddispls)));
+	TRY (recvcounts = h5_calloc (nprocs, sizeof (*recvcounts)));
+	TRY (recvdispls = h5_calloc (nprocs, sizeof (*recvdispls)));
+
+	// requests are sorted by global index, thus by owner
+	h5_glb_idx_t* requests;
+	TRY (requests = h5_calloc (map->num_items + 1, sizeof (*requests)));
+	int proc = 0;
+	for (h5_size_t i = 0; i < map->num_items; i++) {
+		h5_glb_idx_t glb_idx = map->items[i].glb_idx;
+		while (glb_idx >= first_vertex_of_slice (num_glb_vertices, proc+1, nprocs)) {
+			proc++;
+		}
+		requests[i] = glb_idx;
+		sendcounts[proc]++;
+	}
+	TRY (h5priv_mpi_alltoall (
+	             sendcounts, 1, MPI_INT,
+	             recvcounts, 1, MPI_INT,
+	             comm));
+	int num_requested = 0;
+	for (proc = 0; proc < nprocs; proc++) {
+		senddispls[proc] = proc > 0 ? senddispls[proc-1] + sendcounts[proc-1] : 0;
+		recvdispls[proc] = num_requested;
+		num_requested += recvcounts[proc];
+	}
+	h5_glb_idx_t* requested;
+	TRY (requested = h5_calloc (num_requested + 1, sizeof (*requested)));
+	TRY (h5priv_mpi_alltoallv (
+	             requests, sendcounts, senddispls, MPI_LONG_LONG,
+	             requested, recvcounts, recvdispls, MPI_LONG_LONG,
+	             comm));
+
+	// answer requests from slice, on an invalid request take part in
+	// the exchange anyway, so the other procs don't hang
+	h5_loc_vertex_t* replies;
+	TRY (replies = h5_calloc (num_requested + 1, sizeof (*replies)));
+	int invalid = 0;
+	for (int i = 0; i < num_requested; i++) {
+		if (requested[i] < start || requested[i] >= end) {
+			invalid = 1;
+			continue;
+		}
+		replies[i] = slice[requested[i] - start];
+	}
+	TRY (h5priv_mpi_alltoallv (
+	             replies, recvcounts, recvdispls, h5_dta_types.mpi_glb_vtx,
+	             vertices, sendcounts, senddispls, h5_dta_types.mpi_glb_vtx,
+	             comm));
+
+	TRY (h5_free (replies));
+	TRY (h5_free (requested));
+	TRY (h5_free (requests));
+	TRY (h5_free (recvdispls));
+	TRY (h5_free (recvcounts));
+	TRY (h5_free (senddispls));
+	TRY (h5_free (sendcounts));
+	TRY (h5_free (slice));
+	if (invalid) {
+		H5_LEAVE (h5_error_internal ());
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+#endif
+
 /*
    Read vertices from file. If map is NULL, read *all* vertices otherwise the
    vertices specified in the map.
+
+   Selecting the vertices of a map with one hyperslab per run of
+   consecutive indices doesn't scale for fragmented maps. With more than
+   one proc, every proc reads a contiguous slice and the vertices are
+   redistributed. Otherwise the vertices are read in blocks, see
+   read_vertices_blocked().
  */
 static h5_err_t
 read_vertices (
@@ -1084,54 +1514,33 @@ read_vertices (
 	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p", m);
 	hid_t dset_id;
 	TRY (dset_id = hdf5_open_dataset_by_name (m->mesh_gid, m->dsinfo_vertices.name));
-	hid_t mspace_id = H5S_ALL;
-	hid_t dspace_id = H5S_ALL;
 
 	if (map) {
 		m->num_loc_vertices[m->num_leaf_levels-1] = map->num_items;
 		m->last_stored_vid = m->num_loc_vertices[m->num_leaf_levels-1] - 1;
 		TRY (h5tpriv_alloc_loc_vertices (m, map->num_items));
-
-		// create memspace
-		hsize_t num_loc_vertices = map->num_items;
-		TRY (mspace_id = hdf5_create_dataspace(1, &num_loc_vertices, NULL));
-
-		// create diskspace and select subset
-		hsize_t num_glb_vertices = m->num_glb_vertices[m->num_leaf_levels-1];
-		TRY (dspace_id = hdf5_create_dataspace (1, &num_glb_vertices, NULL));
-		hsize_t hstride = 1;
-		H5S_seloper_t seloper = H5S_SELECT_SET; // first selection
-		for (hsize_t i = 0; i < map->num_items; i++) {
-			hsize_t hstart = map->items[i].glb_idx;
-			hsize_t hcount = 1;
-			while (map->items[i].glb_idx+1 == map->items[i+1].glb_idx &&
-			       i + 1 < map->num_items) {// WARNING check if +1 is correct here
-				i++; hcount++;
-			}
-			TRY (hdf5_select_hyperslab_of_dataspace (
-			             dspace_id,
-			             seloper,
-			             &hstart, &hstride, &hcount,
-			             NULL));
-			seloper = H5S_SELECT_OR;
+#if defined(WITH_PARALLEL_H5GRID)
+		if (m->f->nprocs > 1) {
+			TRY (read_vertices_distributed (m, dset_id, map, m->vertices));
+		} else
+#endif
+		{
+			TRY (read_vertices_blocked (m, dset_id, map));
 		}
 	} else {
 		size_t num_vertices =  m->num_glb_vertices[m->num_leaf_levels-1];
 		m->last_stored_vid = m->num_glb_vertices[m->num_leaf_levels-1] - 1;
 		TRY (h5tpriv_alloc_loc_vertices (m, num_vertices));
+		TRY (h5priv_start_throttle (m->f));
+		TRY (h5priv_trace_read (
+		             m->f, __func__,
+		             dset_id,
+		             m->dsinfo_vertices.type_id,
+		             H5S_ALL,
+		             H5S_ALL,
+		             m->vertices));
+		TRY (h5priv_end_throttle (m->f));
 	}
-
-	TRY (h5priv_start_throttle (m->f));
-	TRY (hdf5_read_dataset (
-	             dset_id,
-	             m->dsinfo_vertices.type_id,
-	             mspace_id,
-	             dspace_id,
-	             m->f->props->xfer_prop,
-	             m->vertices));
-	TRY (h5priv_end_throttle (m->f));
-	TRY (hdf5_close_dataspace (dspace_id));
-	TRY (hdf5_close_dataspace (mspace_id));
 	TRY (hdf5_close_dataset (dset_id));
 
 	H5_RETURN (H5_SUCCESS);
@@ -1165,12 +1574,12 @@ read_elems (
 	             NULL));
 
 	TRY (h5priv_start_throttle (m->f));
-	TRY (hdf5_read_dataset (
+	TRY (h5priv_trace_read (
+	             m->f, __func__,
 	             dset_id,
 	             m->dsinfo_elems.type_id,
 	             mspace_id,
 	             dspace_id,
-	             m->f->props->xfer_prop,
 	             glb_elems));
 	TRY (h5priv_end_throttle (m->f));
 
@@ -1186,7 +1595,318 @@ read_elems (
 #if defined(WITH_PARALLEL_H5GRID)
 // READ MESH PARALLEL
 /*
-   Partition mesh via dual graph partitioning
+   Space-filling curve partitioning
+
+   Items (elements or leaf octants) are ordered along a Morton curve of
+   their centers and the curve is split into nprocs pieces of equal
+   weight. The splitters are found by a simultaneous binary search over
+   the key space, in each round the weights of the keys below the
+   candidate splitters are summed up over all procs. Neither the items
+   nor the keys are moved, thus no graph and no parallel sort is
+   required.
+ */
+#define SFC_BITS	21	// bits per dimension of Morton keys
+
+static inline uint64_t
+spread_bits (
+        uint64_t x
+        ) {
+	x &= 0x1fffff;
+	x = (x | x << 32) & 0x001f00000000ffffULL;
+	x = (x | x << 16) & 0x001f0000ff0000ffULL;
+	x = (x | x << 8)  & 0x100f00f00f00f00fULL;
+	x = (x | x << 4)  & 0x10c30c30c30c30c3ULL;
+	x = (x | x << 2)  & 0x1249249249249249ULL;
+	return x;
+}
+
+/*
+   Morton key of point P in bounding box bb = {min x, y, z, max x, y, z}.
+ */
+static inline uint64_t
+morton_key (
+        const h5_float64_t* const P,
+        const h5_float64_t* const bb
+        ) {
+	const uint64_t max_coord = (1ULL << SFC_BITS) - 1;
+	uint64_t key = 0;
+	for (int i = 0; i < 3; i++) {
+		h5_float64_t extent = bb[i+3] - bb[i];
+		h5_float64_t x = extent > 0 ? (P[i] - bb[i]) / extent : 0;
+		uint64_t c = x <= 0 ? 0 : (x >= 1 ? max_coord : (uint64_t)(x * max_coord));
+		key |= spread_bits (c) << i;
+	}
+	return key;
+}
+
+typedef struct {
+	uint64_t key;
+	h5_int64_t weight;
+} sfc_item_t;
+
+static int
+cmp_sfc_items (
+        const void* _a,
+        const void* _b
+        ) {
+	const sfc_item_t* a = (const sfc_item_t*)_a;
+	const sfc_item_t* b = (const sfc_item_t*)_b;
+	return (a->key > b->key) - (a->key < b->key);
+}
+
+/*
+   Return sum of weights of sorted items with key < value. The weight
+   of an item is the prefix sum up to and including the item.
+ */
+static inline h5_int64_t
+weight_below (
+        const sfc_item_t* const items,
+        const size_t num,
+        const uint64_t value
+        ) {
+	size_t low = 0;
+	size_t high = num;
+	while (low < high) {
+		size_t mid = (low + high) / 2;
+		if (items[mid].key < value)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low > 0 ? items[low-1].weight : 0;
+}
+
+/*
+   Compute part of num items with given keys and weights. If weights
+   is NULL, all items have weight 1. Must be called by all procs.
+ */
+static h5_err_t
+partition_sfc (
+        h5t_mesh_t* const m,
+        const uint64_t* const keys,
+        const h5_int64_t* const weights,
+        const size_t num,
+        idx_t* const part
+        ) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p, keys=%p, weights=%p, num=%zu",
+	                    m, keys, weights, num);
+	int nprocs = m->f->nprocs;
+	MPI_Comm comm = m->f->props->comm;
+
+	sfc_item_t* items;
+	TRY (items = h5_calloc (num + 1, sizeof (*items)));
+	for (size_t i = 0; i < num; i++) {
+		items[i].key = keys[i];
+		items[i].weight = weights ? weights[i] : 1;
+	}
+	qsort (items, num, sizeof (*items), cmp_sfc_items);
+	h5_int64_t loc_weight = 0;
+	for (size_t i = 0; i < num; i++) {
+		loc_weight += items[i].weight;
+		items[i].weight = loc_weight;
+	}
+	h5_int64_t glb_weight = 0;
+	TRY (h5priv_mpi_sum (
+	             &loc_weight, &glb_weight, 1, MPI_LONG_LONG, comm));
+
+	// splitter k is the smallest key with at least k/nprocs of the
+	// total weight below
+	int num_splitters = nprocs - 1;
+	uint64_t* low;
+	uint64_t* high;
+	h5_int64_t* targets;
+	h5_int64_t* loc_below;
+	h5_int64_t* glb_below;
+	TRY (low = h5_calloc (nprocs, sizeof (*low)));
+	TRY (high = h5_calloc (nprocs, sizeof (*high)));
+	TRY (targets = h5_calloc (nprocs, sizeof (*targets)));
+	TRY (loc_below = h5_calloc (nprocs, sizeof (*loc_below)));
+	TRY (glb_below = h5_calloc (nprocs, sizeof (*glb_below)));
+	for (int k = 0; k < num_splitters; k++) {
+		low[k] = 0;
+		high[k] = 1ULL << (3 * SFC_BITS);
+		targets[k] = (h5_int64_t)(((double)glb_weight * (k+1)) / nprocs);
+	}
+	int converged = num_splitters == 0;
+	while (!converged) {
+		for (int k = 0; k < num_splitters; k++) {
+			uint64_t mid = low[k] + (high[k] - low[k]) / 2;
+			loc_below[k] = weight_below (items, num, mid);
+		}
+		TRY (h5priv_mpi_sum (
+		             loc_below, glb_below, num_splitters,
+		             MPI_LONG_LONG, comm));
+		converged = 1;
+		for (int k = 0; k < num_splitters; k++) {
+			uint64_t mid = low[k] + (high[k] - low[k]) / 2;
+			if (glb_below[k] >= targets[k]) {
+				high[k] = mid;
+			} else {
+				low[k] = mid + 1;
+			}
+			if (low[k] < high[k])
+				converged = 0;
+		}
+	}
+	// part of an item is the number of splitters less or equal its key
+	for (size_t i = 0; i < num; i++) {
+		int l = 0;
+		int h = num_splitters;
+		while (l < h) {
+			int mid = (l + h) / 2;
+			if (low[mid] <= keys[i])
+				l = mid + 1;
+			else
+				h = mid;
+		}
+		part[i] = l;
+	}
+	TRY (h5_free (glb_below));
+	TRY (h5_free (loc_below));
+	TRY (h5_free (targets));
+	TRY (h5_free (high));
+	TRY (h5_free (low));
+	TRY (h5_free (items));
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+   Partition elements read by this proc along a Morton curve of their
+   centroids. The vertices of the elements are read with the
+   distributed vertex reader.
+ */
+static h5_err_t
+partition_elems_sfc (
+        h5t_mesh_t* const m,
+        h5_glb_elem_t* const elems,
+        const size_t num_elems,
+        idx_t* const part
+        ) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p, elems=%p, num_elems=%zu",
+	                    m, elems, num_elems);
+	int num_vertices = h5tpriv_ref_elem_get_num_vertices (m);
+
+	// unique global indices of vertices of my elements
+	h5_idxmap_t map;
+	TRY (h5priv_new_idxmap (&map, num_elems * num_vertices + 1));
+	for (size_t i = 0; i < num_elems; i++) {
+		h5_glb_idx_t* vertices = h5tpriv_get_glb_elem_vertices (m, elems, i);
+		for (int j = 0; j < num_vertices; j++) {
+			map.items[map.num_items++] = (h5_idxmap_el_t) {vertices[j], 0};
+		}
+	}
+	TRY (h5priv_sort_idxmap (&map));
+	h5_size_t num_unique = 0;
+	for (h5_size_t i = 0; i < map.num_items; i++) {
+		if (num_unique > 0 &&
+		    map.items[num_unique-1].glb_idx == map.items[i].glb_idx)
+			continue;
+		map.items[num_unique] = map.items[i];
+		map.items[num_unique].loc_idx = num_unique;
+		num_unique++;
+	}
+	map.num_items = num_unique;
+	TRY (h5priv_sort_idxmap (&map));	// rebuild hash index
+
+	h5_loc_vertex_t* vertices;
+	TRY (vertices = h5_calloc (map.num_items + 1, sizeof (*vertices)));
+	hid_t dset_id;
+	TRY (dset_id = hdf5_open_dataset_by_name (m->mesh_gid, m->dsinfo_vertices.name));
+	TRY (read_vertices_distributed (m, dset_id, &map, vertices));
+	TRY (hdf5_close_dataset (dset_id));
+
+	// centroids and global bounding box, minima are negated to get
+	// them with the same reduction. The last entry flags a missing
+	// vertex, all procs must take part in the reduction anyway.
+	h5_float64_t* centroids;
+	TRY (centroids = h5_calloc (3 * num_elems + 1, sizeof (*centroids)));
+	h5_float64_t loc_bb[7] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL,
+	                          -HUGE_VAL, -HUGE_VAL, -HUGE_VAL, 0};
+	for (size_t i = 0; i < num_elems; i++) {
+		h5_float64_t* C = &centroids[3*i];
+		h5_glb_idx_t* vertex_indices = h5tpriv_get_glb_elem_vertices (m, elems, i);
+		for (int j = 0; j < num_vertices; j++) {
+			h5_loc_idx_t idx = h5priv_find_idxmap (&map, vertex_indices[j]);
+			if (idx < 0) {
+				loc_bb[6] = 1;
+				continue;
+			}
+			for (int k = 0; k < 3; k++) {
+				C[k] += vertices[idx].P[k] / num_vertices;
+			}
+		}
+		for (int k = 0; k < 3; k++) {
+			if (-C[k] > loc_bb[k])
+				loc_bb[k] = -C[k];
+			if (C[k] > loc_bb[k+3])
+				loc_bb[k+3] = C[k];
+		}
+	}
+	h5_float64_t bb[7];
+	TRY (h5priv_mpi_allreduce_max (
+	             loc_bb, bb, 7, MPI_DOUBLE, m->f->props->comm));
+	if (bb[6] > 0) {
+		TRY (h5_free (centroids));
+		TRY (h5_free (vertices));
+		TRY (h5priv_free_idxmap (&map));
+		H5_LEAVE (h5_error_internal ());
+	}
+	for (int k = 0; k < 3; k++) {
+		bb[k] = -bb[k];
+	}
+
+	uint64_t* keys;
+	TRY (keys = h5_calloc (num_elems + 1, sizeof (*keys)));
+	for (size_t i = 0; i < num_elems; i++) {
+		keys[i] = morton_key (&centroids[3*i], bb);
+	}
+	TRY (partition_sfc (m, keys, NULL, num_elems, part));
+
+	TRY (h5_free (keys));
+	TRY (h5_free (centroids));
+	TRY (h5_free (vertices));
+	TRY (h5priv_free_idxmap (&map));
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+   Initial distribution of the elements of level 0 before partitioning:
+   proc p reads the slice of elements starting at
+   first_elem_of_slice (num_elems, nprocs, p), the first r procs get
+   one element more.
+ */
+static inline h5_glb_idx_t
+first_elem_of_slice (
+	const h5_glb_idx_t num_elems,
+	const int nprocs,
+	const int proc
+	) {
+	h5_glb_idx_t n = num_elems / nprocs;
+	h5_glb_idx_t r = num_elems % nprocs;
+	return proc * n + (proc < r ? proc : r);
+}
+
+/*
+   Return proc which has read the element with given global index.
+ */
+static inline int
+slice_of_elem (
+	const h5_glb_idx_t num_elems,
+	const int nprocs,
+	const h5_glb_idx_t idx
+	) {
+	h5_glb_idx_t n = num_elems / nprocs;
+	h5_glb_idx_t r = num_elems % nprocs;
+	if (idx < r * (n + 1))
+		return (int)(idx / (n + 1));
+	return (int)(r + (idx - r * (n + 1)) / n);
+}
+
+/*
+   Partition mesh via dual graph partitioning or along a space-filling
+   curve, depending on the mesh partitioner set in the file properties.
+   The elements read by this proc are returned in slice_elems, they
+   are needed to answer requests for ghost cells.
 
    Step 1: Partiton dual graph of mesh, all procs have their global
           cell data loaded.
@@ -1196,7 +1916,8 @@ read_elems (
 static h5_err_t
 part_kway  (
         h5t_mesh_t* const m,
-        h5_glb_elem_t** glb_elems
+        h5_glb_elem_t** glb_elems,
+        h5_glb_elem_t** slice_elems
         ) {
 	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p", m);
 	/*
@@ -1209,21 +1930,12 @@ part_kway  (
 	 */
 
 	// compute initial distribution of cells on all procs
-	int n = m->num_glb_elems[0] / m->f->nprocs;
-	int r = m->num_glb_elems[0] % m->f->nprocs;
-
 	idx_t* vtxdist;
 	TRY (vtxdist = h5_calloc (m->f->nprocs+1, sizeof (*vtxdist)));
-	vtxdist[0] = 0;
-	h5_debug ("vtxdist[%d]: %d", 0, 0);
-	for (int i = 1; i < m->f->nprocs+1; i++) {
-		if (r > 0) {
-			vtxdist[i] = vtxdist[i-1] + n + 1;
-			r--;
-		} else {
-			vtxdist[i] = vtxdist[i-1] + n;
-		}
-		h5_debug ("vtxdist[%d]: %d", i, vtxdist[i]);
+	for (int i = 0; i < m->f->nprocs+1; i++) {
+		vtxdist[i] = first_elem_of_slice (
+			m->num_glb_elems[0], m->f->nprocs, i);
+		h5_debug ("vtxdist[%d]: %lld", i, (long long)vtxdist[i]);
 	}
 	// read cells only
 	idx_t start = vtxdist[m->f->myproc];
@@ -1235,74 +1947,78 @@ part_kway  (
 
 	TRY (read_elems (m, start, num_interior_elems, elems));
 
-
-	// setup input for ParMETIS
-	idx_t* xadj;
-	idx_t* adjncy;
 	idx_t* part;
-	TRY (xadj = h5_calloc (num_interior_elems, sizeof(*xadj)));
-	TRY (part = h5_calloc (num_interior_elems, sizeof(*part)));
-	//  TODO: 4*num_interior_elems will work for meshes with up to 4 facets only!
-	TRY (adjncy = h5_calloc (4*num_interior_elems, sizeof(*adjncy)));
-	idx_t i, j;
-	int num_facets = h5tpriv_ref_elem_get_num_facets (m);
-	for (i = 0, j = 0; i < num_interior_elems; i++) {
-		h5_glb_idx_t* neighbors = h5tpriv_get_glb_elem_neighbors(m, elems, i);
-		xadj[i] = j;
-		h5_debug ("xadj[%d]: %d", i, j);
-		// for all facets
-		for (int l = 0; l < num_facets; l++) {
-			if (neighbors[l] < 0) continue;
-			adjncy[j] = neighbors[l];
-			h5_debug ("adjncy[%d]: %d", j, adjncy[j]);
-			j++;
-		}
-	}
-	xadj[num_interior_elems] = j;
-	h5_debug ("xadj[%lld]: %d", (long long)num_interior_elems, j);
-	// now we can call the partitioner
-	idx_t wgtflag = 0;
-	idx_t numflag = 0;
-	idx_t ncon = 1;
+	idx_t i;
 	idx_t nparts = m->f->nprocs;
-	real_t* tpwgts;
-	real_t* ubvec;
-	idx_t options[] = {1,127,42};
-	idx_t edgecut;
-	h5_debug ("nparts: %d", nparts);
-	TRY (tpwgts = h5_calloc (nparts, sizeof(*tpwgts)));
-	TRY (ubvec = h5_calloc (nparts, sizeof(*ubvec)));
-	for (i = 0; i < nparts; i++) {
-		tpwgts[i] = 1.0 / (real_t)nparts;
-		ubvec[i] = 1.05;
-	}
-	int rc = ParMETIS_V3_PartKway (
-	        vtxdist,
-	        xadj,
-	        adjncy,
-	        NULL,           // vwgt
-	        NULL,           // adjwgt
-	        &wgtflag,
-	        &numflag,
-	        &ncon,
-	        &nparts,
-	        tpwgts,
-	        ubvec,
-	        options,
-	        &edgecut,
-	        part,
-	        &m->f->props->comm
-	        );
-	if (rc != METIS_OK) {
-		H5_RETURN_ERROR (
-		        H5_ERR,
-			"ParMETIS failed");
+	TRY (part = h5_calloc (num_interior_elems + 1, sizeof(*part)));
+	if (m->f->props->mesh_partitioner == H5_PARTITIONER_SFC) {
+		TRY (partition_elems_sfc (m, elems, num_interior_elems, part));
+	} else {
+		// setup input for ParMETIS
+		idx_t* xadj;
+		idx_t* adjncy;
+		TRY (xadj = h5_calloc (num_interior_elems, sizeof(*xadj)));
+		//  TODO: 4*num_interior_elems will work for meshes with up to 4 facets only!
+		TRY (adjncy = h5_calloc (4*num_interior_elems, sizeof(*adjncy)));
+		idx_t j;
+		int num_facets = h5tpriv_ref_elem_get_num_facets (m);
+		for (i = 0, j = 0; i < num_interior_elems; i++) {
+			h5_glb_idx_t* neighbors = h5tpriv_get_glb_elem_neighbors(m, elems, i);
+			xadj[i] = j;
+			h5_debug ("xadj[%d]: %d", i, j);
+			// for all facets
+			for (int l = 0; l < num_facets; l++) {
+				if (neighbors[l] < 0) continue;
+				adjncy[j] = neighbors[l];
+				h5_debug ("adjncy[%d]: %d", j, adjncy[j]);
+				j++;
+			}
+		}
+		xadj[num_interior_elems] = j;
+		h5_debug ("xadj[%lld]: %d", (long long)num_interior_elems, j);
+		// now we can call the partitioner
+		idx_t wgtflag = 0;
+		idx_t numflag = 0;
+		idx_t ncon = 1;
+		real_t* tpwgts;
+		real_t* ubvec;
+		idx_t options[] = {1,127,42};
+		idx_t edgecut;
+		h5_debug ("nparts: %d", nparts);
+		TRY (tpwgts = h5_calloc (nparts, sizeof(*tpwgts)));
+		TRY (ubvec = h5_calloc (nparts, sizeof(*ubvec)));
+		for (i = 0; i < nparts; i++) {
+			tpwgts[i] = 1.0 / (real_t)nparts;
+			ubvec[i] = 1.05;
+		}
+		int rc = ParMETIS_V3_PartKway (
+		        vtxdist,
+		        xadj,
+		        adjncy,
+		        NULL,           // vwgt
+		        NULL,           // adjwgt
+		        &wgtflag,
+		        &numflag,
+		        &ncon,
+		        &nparts,
+		        tpwgts,
+		        ubvec,
+		        options,
+		        &edgecut,
+		        part,
+		        &m->f->props->comm
+		        );
+		if (rc != METIS_OK) {
+			H5_RETURN_ERROR (
+			        H5_ERR,
+				"ParMETIS failed");
+		}
+		TRY (h5_free (xadj));
+		TRY (h5_free (adjncy));
+		TRY (h5_free (tpwgts));
+		TRY (h5_free (ubvec));
 	}
 	TRY (h5_free (vtxdist));
-	TRY (h5_free (xadj));
-	TRY (h5_free (adjncy));
-	TRY (h5_free (tpwgts));
-	TRY (h5_free (ubvec));
 
 #if !defined(NDEBUG)
 	for (i = 0; i < num_interior_elems; i++) {
@@ -1396,7 +2112,7 @@ part_kway  (
 	TRY (h5_free (recvcounts));
 	TRY (h5_free (recvdispls));
 
-	TRY (h5_free (elems));
+	*slice_elems = elems;
 	*glb_elems = recvbuf;
 
 	H5_RETURN (H5_SUCCESS);
@@ -1404,171 +2120,237 @@ part_kway  (
 
 
 /*
-   exchange ghost cells:
-   idea: send my ghost cells to all procs
-   1. compute ghost cells
-   2. allgather ghost cell IDs: each proc knows the ghost cell IDs of all procs
-   3. compute number of border cells to scatter to each proc
-   4. scatter these numbers
-   5. build array with (border)cells to scatter (note: we may have to scatter
-     the same cell to multiple procs)
-   6. scatter border cells with alltoallv
+   Nonblocking exchange of ghost cells. Ghost cells are requested from
+   the procs which have read them in part_kway(), thus no proc has to
+   know the ghost cells of all other procs. The exchange runs in three
+   stages, each of them a nonblocking all-to-all communication:
+
+   1. scatter number of requested cells
+   2. scatter global indices of requested cells
+   3. send requested cells back
+
+   The exchange is started with begin_ghost_exchange() and driven by
+   progress_ghost_exchange(), local work can be done in between.
  */
+#define GHOST_EXCHANGE_BATCH	4096	// elements between progress calls
+
+struct ghost_exchange {
+	int		stage;		// stage in progress, 0 if done
+	MPI_Request	request;
+	h5_glb_elem_t*	slice_elems;	// cells read by this proc
+	h5_glb_idx_t	slice_start;	// global index of first cell in slice
+	h5_glb_idx_t	slice_end;
+	h5_glb_idx_t*	ghost_ids;	// sorted IDs of my ghost cells
+	int		num_ghost_elems;
+	h5_glb_idx_t*	requested_ids;	// IDs requested by other procs
+	int		num_requested;
+	int*		sendcounts;	// per proc: my requests
+	int*		senddispls;
+	int*		recvcounts;	// per proc: requests to answer
+	int*		recvdispls;
+	h5_glb_elem_t*	replies;
+	h5_glb_elem_t*	ghost_elems;	// received ghost cells
+	int		invalid;	// invalid request received
+};
+
 static h5_err_t
-exchange_ghost_cells (
+begin_ghost_exchange (
         h5t_mesh_t* const m,
         h5_glb_elem_t* glb_elems,
-        h5_glb_elem_t** ghost_elems,
-        size_t* num_ghost_elems
+        h5_glb_elem_t* slice_elems,
+        struct ghost_exchange* x
         ) {
-	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p, ghost_elems=%p", m, ghost_elems);
-	int* sendcounts;
-	int* senddispls;
-	int* recvcounts;
-	int* recvdispls;
+	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p, glb_elems=%p, slice_elems=%p, x=%p",
+	                    m, glb_elems, slice_elems, x);
 	int nprocs = m->f->nprocs;
-	TRY (sendcounts = h5_calloc (nprocs, sizeof(*sendcounts)));
-	TRY (senddispls = h5_calloc (nprocs, sizeof(*senddispls)));
-	TRY (recvcounts = h5_calloc (nprocs, sizeof(*recvcounts)));
-	TRY (recvdispls = h5_calloc (nprocs, sizeof(*recvdispls)));
+	memset (x, 0, sizeof (*x));
+	x->slice_elems = slice_elems;
+	x->slice_start = first_elem_of_slice (
+		m->num_glb_elems[0], nprocs, m->f->myproc);
+	x->slice_end = first_elem_of_slice (
+		m->num_glb_elems[0], nprocs, m->f->myproc+1);
+	TRY (x->sendcounts = h5_calloc (nprocs, sizeof (*x->sendcounts)));
+	TRY (x->senddispls = h5_calloc (nprocs, sizeof (*x->senddispls)));
+	TRY (x->recvcounts = h5_calloc (nprocs, sizeof (*x->recvcounts)));
+	TRY (x->recvdispls = h5_calloc (nprocs, sizeof (*x->recvdispls)));
 
 	// determine my ghost cells
-	h5_glb_idxlist_t* loc_ghostcell_ids = NULL;
+	h5_loc_idx_t num_interior_elems = m->num_interior_elems[0];
 	int num_facets = h5tpriv_ref_elem_get_num_facets (m);
-	for (int i = 0; i < m->num_interior_elems[0]; i++) {
-		h5_glb_idx_t* neighbors = h5tpriv_get_glb_elem_neighbors(m, glb_elems, i);
+	TRY (x->ghost_ids = h5_calloc (
+		     (size_t)num_interior_elems * num_facets + 1,
+		     sizeof (*x->ghost_ids)));
+	size_t num_ids = 0;
+	for (h5_loc_idx_t i = 0; i < num_interior_elems; i++) {
+		h5_glb_idx_t* neighbors = h5tpriv_get_glb_elem_neighbors (
+			m, glb_elems, i);
 		for (int facet = 0; facet < num_facets; facet++) {
 			if (neighbors[facet] == -1) {
 				// geometric boundary
 				continue;
 			}
-			if (h5priv_search_idxmap (&m->map_elem_g2l, neighbors[facet]) >= 0) {
+			if (h5priv_find_idxmap (&m->map_elem_g2l, neighbors[facet]) >= 0) {
 				// neighbor is local
 				continue;
 			}
-			// neighbor is *not* local
-			TRY (h5priv_search_in_glb_idxlist (&loc_ghostcell_ids, neighbors[facet]));
-			h5_debug ("ghost cell: %lld", neighbors[facet]);
+			x->ghost_ids[num_ids++] = neighbors[facet];
 		}
 	}
-	// allgather number of ghost cells
-	int* num_ghostcells;
-	TRY (num_ghostcells = h5_calloc (nprocs, sizeof(num_ghostcells[0])));
-	TRY (mpi_allgather (&loc_ghostcell_ids->num_items, 1, MPI_INT,
-	                    num_ghostcells, 1, MPI_INT, m->f->props->comm));
-	for (int i = 0; i < nprocs; i++) {
-		h5_debug ("num_ghostcells[%d] = %d", i, num_ghostcells[i]);
+	qsort (x->ghost_ids, num_ids, sizeof (*x->ghost_ids), cmp_glb_idx);
+	x->num_ghost_elems = 0;
+	for (size_t i = 0; i < num_ids; i++) {
+		if (x->num_ghost_elems > 0 &&
+		    x->ghost_ids[x->num_ghost_elems-1] == x->ghost_ids[i])
+			continue;
+		x->ghost_ids[x->num_ghost_elems++] = x->ghost_ids[i];
+		h5_debug ("ghost cell: %lld", (long long)x->ghost_ids[i]);
 	}
 
-	// allgather ghost cell IDs
-	int num_ghostcells_total = num_ghostcells[0];
-	recvdispls[0] = 0;
-	for (int i = 1; i < nprocs; i++) {
-		recvdispls[i] = num_ghostcells_total;
-		num_ghostcells_total += num_ghostcells[i];
-	}
-	h5_glb_id_t* ghostcells;
-	TRY (ghostcells = h5_calloc (num_ghostcells_total, sizeof(*ghostcells)));
-	TRY (mpi_allgatherv (
-	             loc_ghostcell_ids->items, (int)loc_ghostcell_ids->num_items,
-	             MPI_LONG_LONG,
-	             ghostcells, num_ghostcells, recvdispls,
-	             MPI_LONG_LONG,
-	             m->f->props->comm));
-
-	for (int i = 0; i < num_ghostcells_total; i++) {
-		h5_debug ("ghostcells[%d] = %lld", i, ghostcells[i]);
-	}
-
-	// scatter my border cells
-	// - count and collect border cells we have to scatter
-	h5_loc_idxlist_t** belem_lists;
-	TRY (belem_lists = h5_calloc (nprocs, sizeof (*belem_lists)));
-	h5_loc_idx_t num_elems_to_scatter_total = 0;
-	for (int proc = 0; proc < nprocs; proc++) {
-		h5_loc_idxlist_t** list = &belem_lists[proc];
-		h5_loc_idx_t last = recvdispls[proc] + num_ghostcells[proc] - 1;
-		for (int i = recvdispls[proc]; i <= last; i++) {
-			// is cell with ID local?
-			h5_loc_idx_t idx;
-			idx = h5priv_search_idxmap (&m->map_elem_g2l, ghostcells[i]);
-			if (idx >= 0) {
-				// yes: we have to send this cell to proc
-				// add to collection
-				TRY (h5priv_insert_into_loc_idxlist (list, idx, -1));
-				num_elems_to_scatter_total++;
-			}
-		}
+	// slices are ordered, thus sorted IDs are grouped by proc
+	for (int i = 0; i < x->num_ghost_elems; i++) {
+		x->sendcounts[slice_of_elem (
+				m->num_glb_elems[0], nprocs, x->ghost_ids[i])]++;
+	}
+	for (int proc = 0; proc < nprocs-1; proc++) {
+		x->senddispls[proc+1] = x->senddispls[proc] + x->sendcounts[proc];
 	}
-	TRY (h5_free (num_ghostcells));
-	TRY (h5_free (ghostcells));
+	x->stage = 1;
+	TRY (h5priv_mpi_ialltoall (
+	             x->sendcounts, 1, MPI_INT,
+	             x->recvcounts, 1, MPI_INT,
+	             m->f->props->comm, &x->request));
+	H5_RETURN (H5_SUCCESS);
+}
 
-	// - allocate memory for border cells we have to scatter
-	h5_glb_elem_t* sendbuf;
-	TRY (sendbuf = h5tpriv_alloc_glb_elems (m, num_elems_to_scatter_total));
-
-	// - setup send buffer
-	for (int sendidx = 0, proc = 0; proc < nprocs; proc++) {
-		h5_loc_idxlist_t* list = belem_lists[proc];
-		if (list) {
-			sendcounts[proc] = list->num_items;
-			senddispls[proc] = sendidx;
-			for (size_t i = 0; i < list->num_items; i++, sendidx++) {
-				// copy glb cell at list->item[i] to sendbuf
-				h5tpriv_copy_glb_elems (
-				        m,
-				        sendbuf, sendidx,
-				        glb_elems,
-				        list->items[i],
-				        1);
+/*
+   Start next stage after the communication of the current stage has
+   been completed.
+ */
+static h5_err_t
+advance_ghost_exchange (
+        h5t_mesh_t* const m,
+        struct ghost_exchange* x
+        ) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p, x=%p", m, x);
+	int nprocs = m->f->nprocs;
+	MPI_Datatype type = h5tpriv_get_mpi_type_of_glb_elem (m);
+	switch (x->stage) {
+	case 1:
+		// scatter IDs of requested cells
+		x->num_requested = 0;
+		for (int proc = 0; proc < nprocs; proc++) {
+			x->recvdispls[proc] = x->num_requested;
+			x->num_requested += x->recvcounts[proc];
+		}
+		TRY (x->requested_ids = h5_calloc (
+			     x->num_requested + 1, sizeof (*x->requested_ids)));
+		x->stage = 2;
+		TRY (h5priv_mpi_ialltoallv (
+		             x->ghost_ids, x->sendcounts, x->senddispls, MPI_LONG_LONG,
+		             x->requested_ids, x->recvcounts, x->recvdispls, MPI_LONG_LONG,
+		             m->f->props->comm, &x->request));
+		break;
+	case 2:
+		// answer requests from the cells in my slice. Invalid
+		// requests get a zeroed reply, the exchange must be posted
+		// anyway, the other procs wait for it.
+		TRY (x->replies = h5tpriv_alloc_glb_elems (m, x->num_requested));
+		for (int i = 0; i < x->num_requested; i++) {
+			h5_glb_idx_t idx = x->requested_ids[i];
+			if (idx < x->slice_start || idx >= x->slice_end) {
+				x->invalid = 1;
+				continue;
 			}
-			TRY (h5_free (list));
-		} else { // nothing to to for this proc
-			sendcounts[proc] = 0;
-			senddispls[proc] = sendidx;
+			h5tpriv_copy_glb_elems (
+			        m,
+			        x->replies, i,
+			        x->slice_elems, idx - x->slice_start, 1);
+		}
+		TRY (x->ghost_elems = h5tpriv_alloc_glb_elems (m, x->num_ghost_elems));
+		x->stage = 3;
+		TRY (h5priv_mpi_ialltoallv (
+		             x->replies, x->recvcounts, x->recvdispls, type,
+		             x->ghost_elems, x->sendcounts, x->senddispls, type,
+		             m->f->props->comm, &x->request));
+		break;
+	case 3:
+		for (int i = 0; i < x->num_ghost_elems; i++) {
+			h5_debug ("global ghost cell ID[%d]: %lld",
+			          i, (long long)h5tpriv_get_glb_elem_idx (m, x->ghost_elems, i));
 		}
+		TRY (h5_free (x->replies));
+		TRY (h5_free (x->requested_ids));
+		TRY (h5_free (x->ghost_ids));
+		TRY (h5_free (x->sendcounts));
+		TRY (h5_free (x->senddispls));
+		TRY (h5_free (x->recvcounts));
+		TRY (h5_free (x->recvdispls));
+		x->stage = 0;
+		break;
+	default:
+		H5_LEAVE (h5_error_internal ());
 	}
-	TRY (h5_free (belem_lists));
-
-	// - scatter send counts
-	TRY (h5priv_mpi_alltoall (
-	             sendcounts, 1, MPI_INT,
-	             recvcounts, 1, MPI_INT,
-	             m->f->props->comm));
+	H5_RETURN (H5_SUCCESS);
+}
 
-	// compute receive displacements and number of local ghost cells
-	recvdispls[0] = 0;
-	for (int proc = 0; proc < nprocs-1; proc++) {
-		recvdispls[proc+1] = recvdispls[proc] + recvcounts[proc];
+/*
+   Advance ghost cell exchange as far as possible without blocking. If
+   wait is set, block until the exchange is done.
+ */
+static h5_err_t
+progress_ghost_exchange (
+        h5t_mesh_t* const m,
+        struct ghost_exchange* x,
+        const int wait
+        ) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p, x=%p, wait=%d", m, x, wait);
+	while (x->stage > 0) {
+		if (wait) {
+			TRY (h5priv_mpi_wait (&x->request));
+		} else {
+			int done = 0;
+			TRY (h5priv_mpi_test (&x->request, &done));
+			if (!done)
+				break;
+		}
+		TRY (advance_ghost_exchange (m, x));
 	}
-	int num_loc_ghost_elems = recvdispls[nprocs-1] + recvcounts[nprocs-1];
-
-	// - scatter ghost cells alltoall
-	h5_glb_elem_t* recvbuf;
-	TRY (recvbuf = h5tpriv_alloc_glb_elems (m, num_loc_ghost_elems));
-	MPI_Datatype type = h5tpriv_get_mpi_type_of_glb_elem (m);
-
-	TRY (h5priv_mpi_alltoallv (
-	             sendbuf, sendcounts, senddispls, type,
-	             recvbuf, recvcounts, recvdispls, type,
-	             m->f->props->comm));
-
-	for (int i = 0; i < num_loc_ghost_elems; i++) {
-		h5_debug ("global ghost cell ID[%d]: %lld",
-		          i, h5tpriv_get_glb_elem_idx (m, recvbuf, i));
+	if (x->stage == 0 && x->invalid) {
+		H5_LEAVE (h5_error_internal ());
 	}
-	TRY (h5_free (sendbuf));
-
-	TRY (h5_free (sendcounts));
-	TRY (h5_free (senddispls));
-	TRY (h5_free (recvcounts));
-	TRY (h5_free (recvdispls));
-
-	*ghost_elems = recvbuf;
-	*num_ghost_elems = num_loc_ghost_elems;
 	H5_RETURN (H5_SUCCESS);
 }
 
+/*
+   Add global vertex indices of elements to map. The hash table is used
+   only for a fast test whether a global index has already been added.
+ */
+static inline void
+add_vertices_to_map (
+        h5t_mesh_t* const m,
+        h5_glb_elem_t* elems,
+        const size_t from,
+        const size_t to,
+        h5_hashtable_t* htab
+        ) {
+	h5_idxmap_t* map = &m->map_vertex_g2l;
+	int num_vertices = h5tpriv_ref_elem_get_num_vertices (m);
+	for (size_t idx = from; idx < to; idx++) {
+		h5_glb_idx_t* vertices = h5tpriv_get_glb_elem_vertices (m, elems, idx);
+		for (int i = 0; i < num_vertices; i++) {
+			// add index temporarly to map ...
+			map->items[map->num_items] = (h5_idxmap_el_t) {vertices[i], 0};
+			// ... and check whether it has already been added
+			h5_idxmap_el_t* retval;
+			h5priv_hsearch (&map->items[map->num_items],
+			                H5_ENTER, (void**)&retval, htab);
+			if (retval == &map->items[map->num_items]) {
+				// new entry in hash table thus in map
+				map->num_items++;
+			}
+		}
+	}
+}
 
 h5_err_t
 h5tpriv_read_mesh (
@@ -1576,67 +2358,47 @@ h5tpriv_read_mesh (
         ) {
 	H5_PRIV_API_ENTER (h5_err_t, "m=%p", m);
 	h5_glb_elem_t* glb_elems = NULL;
-	TRY (part_kway (m, &glb_elems));
+	h5_glb_elem_t* slice_elems = NULL;
+	TRY (part_kway (m, &glb_elems, &slice_elems));
 	h5_loc_idx_t num_interior_elems = m->num_interior_elems[0];
 
 	// add interior elements to global -> local index map
 	TRY (h5tpriv_init_map_elem_g2l (m, glb_elems, num_interior_elems));
 
-	// gather ghost cells
-	h5_glb_elem_t* ghost_elems;
-	size_t num_ghost_elems;
-	TRY (exchange_ghost_cells (m, glb_elems, &ghost_elems, &num_ghost_elems));
+	// request ghost cells, they are received while we set up the
+	// vertex map for the interior elements
+	struct ghost_exchange x;
+	TRY (begin_ghost_exchange (m, glb_elems, slice_elems, &x));
+	size_t num_ghost_elems = x.num_ghost_elems;
 	m->num_ghost_elems[0] = num_ghost_elems;
 
-	// add ghost cells to global -> local index map
-	TRY (h5tpriv_init_map_elem_g2l (m, ghost_elems, num_ghost_elems));
-
 	// define local indices for all vertices of all local elements
 	size_t size = num_interior_elems+num_ghost_elems;
 	TRY (h5priv_new_idxmap (&m->map_vertex_g2l, size+128));
 
 	h5_idxmap_t* map = &m->map_vertex_g2l;
-
-	/* for the time being we use the hash table only for a fast test
-	   whether a global index has already been added to the map or not. */
 	h5_hashtable_t htab;
 	TRY (h5priv_hcreate ((size << 2) / 3, &htab,
 	                     hidxmap_cmp, hidxmap_compute_hval, NULL));
 
-	int num_vertices = h5tpriv_ref_elem_get_num_vertices (m);
-	for (size_t idx = 0; idx < num_interior_elems; idx++) {
-		h5_glb_idx_t* vertices = h5tpriv_get_glb_elem_vertices (m, glb_elems, idx);
-		for (int i = 0; i < num_vertices; i++) {
-			// add index temporarly to map ...
-			map->items[map->num_items] = (h5_idxmap_el_t) {vertices[i], 0};
-			// ... and check whether it has already been added
-			h5_idxmap_el_t* retval;
-			h5priv_hsearch (&map->items[map->num_items],
-			                H5_ENTER, (void**)&retval, &htab);
-			if (retval == &map->items[map->num_items]) {
-				// new entry in hash table thus in map
-				map->num_items++;
-			}
-		}
-	}
-	// same for ghost cells
-	for (size_t idx = 0; idx < num_ghost_elems; idx++) {
-		h5_glb_idx_t* vertices = h5tpriv_get_glb_elem_vertices (m, ghost_elems, idx);
-		for (int i = 0; i < num_vertices; i++) {
-			// add index temporarly to map ...
-			map->items[map->num_items] = (h5_idxmap_el_t) {vertices[i], 0};
-			// ... and check whether it has already been added
-			h5_idxmap_el_t* retval;
-			h5priv_hsearch (&map->items[map->num_items],
-			                H5_ENTER, (void**)&retval, &htab);
-			if (retval == &map->items[map->num_items]) {
-				// new entry in hash table thus in map
-				map->num_items++;
-			}
-		}
+	for (size_t idx = 0; idx < num_interior_elems; idx += GHOST_EXCHANGE_BATCH) {
+		size_t to = idx + GHOST_EXCHANGE_BATCH;
+		if (to > num_interior_elems)
+			to = num_interior_elems;
+		add_vertices_to_map (m, glb_elems, idx, to, &htab);
+		TRY (progress_ghost_exchange (m, &x, 0));
 	}
+	TRY (progress_ghost_exchange (m, &x, 1));
+	h5_glb_elem_t* ghost_elems = x.ghost_elems;
+	TRY (h5_free (slice_elems));
+
+	// add ghost cells to global -> local index map
+	TRY (h5tpriv_init_map_elem_g2l (m, ghost_elems, num_ghost_elems));
+
+	// same for vertices of ghost cells
+	add_vertices_to_map (m, ghost_elems, 0, num_ghost_elems, &htab);
 	TRY (h5priv_hdestroy (&htab));
-	h5priv_sort_idxmap (map);
+	TRY (h5priv_sort_idxmap (map));
 	for (h5_loc_idx_t i = 0; i < map->num_items; i++) {
 		map->items[i].loc_idx = i;
 	}
@@ -1687,6 +2449,7 @@ h5tpriv_read_mesh (
 	TRY (h5tpriv_update_internal_structs (m, 0));
 	TRY (h5tpriv_init_elem_flags (m, 0, num_interior_elems));
 	TRY (h5_free (glb_elems));
+	m->num_written_levels = m->num_leaf_levels;
 
 	H5_RETURN (H5_SUCCESS);
 }
@@ -1742,23 +2505,23 @@ read_octree (
 	TRY (H5t_set_bounding_box (m->octree, bounding_box));
 	TRY (h5priv_start_throttle (m->f));
 
-	TRY (hdf5_read_dataset (
+	TRY (h5priv_trace_read (
+             m->f, __func__,
              dset_id,
              m->dsinfo_octree.type_id,
              mspace_id,
              dspace_id,
-             m->f->props->xfer_prop,
              octants));
 
 	if (size_userdata > 0) {
 		TRY (dset_id2 = hdf5_open_dataset_by_name (
 			     m->mesh_gid, m->dsinfo_userdata.name));
-		TRY (hdf5_read_dataset (
+		TRY (h5priv_trace_read (
+	             m->f, __func__,
 	             dset_id2,
 	             m->dsinfo_userdata.type_id,
 	             mspace_id,
 	             dspace_id,
-	             m->f->props->xfer_prop,
 	             userdata));
 		TRY (hdf5_close_dataset (dset_id2));
 	}
@@ -1796,12 +2559,12 @@ read_weights (
 	}
 	TRY (h5priv_start_throttle (m->f));
 
-	TRY (hdf5_read_dataset (
+	TRY (h5priv_trace_read (
+		             m->f, __func__,
 		             dset_id,
 		             m->dsinfo_weights.type_id,
 		             mspace_id,
 		             dspace_id,
-		             m->f->props->xfer_prop,
 		             m->weights));
 	TRY (h5priv_end_throttle (m->f));
 
@@ -1859,12 +2622,12 @@ read_chunks (
 
 	TRY (h5priv_start_throttle (m->f));
 
-		TRY (hdf5_read_dataset (
+		TRY (h5priv_trace_read (
+	             m->f, __func__,
 	             dset_id,
 	             m->dsinfo_chunks.type_id,
 	             mspace_id,
 	             dspace_id,
-	             m->f->props->xfer_prop,
 	             m->chunks->chunks));
 	TRY (h5priv_end_throttle (m->f));
 
@@ -1978,6 +2741,74 @@ calc_weights_oct_leaflevel (
 	H5_RETURN (H5_SUCCESS);
 }
 
+/*
+   Partition leaf octants along a Morton curve of their centers. Each
+   proc computes the parts of the octants [vtxdist[myproc],
+   vtxdist[myproc+1]) in new_numbering, the weights of these octants
+   are summed up over all weight constraints. The parts are gathered in
+   glb_part.
+ */
+static h5_err_t
+partition_octants_sfc (
+	h5t_mesh_t* const m,
+	const idx_t* const weights,
+	const h5_oct_idx_t* const new_numbering,
+	idx_t* const vtxdist,
+	idx_t* const glb_part
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p, weights=%p, new_numbering=%p",
+			    m, weights, new_numbering);
+	idx_t start = vtxdist[m->f->myproc];
+	idx_t num_interior_oct = vtxdist[m->f->myproc+1] - start;
+
+	h5_float64_t* bb = H5t_get_bounding_box (m->octree);
+	uint64_t* keys;
+	h5_int64_t* oct_weights;
+	idx_t* part;
+	TRY (keys = h5_calloc (num_interior_oct + 1, sizeof (*keys)));
+	TRY (oct_weights = h5_calloc (num_interior_oct + 1, sizeof (*oct_weights)));
+	TRY (part = h5_calloc (num_interior_oct + 1, sizeof (*part)));
+	for (idx_t i = 0; i < num_interior_oct; i++) {
+		h5_float64_t oct_bb[6];
+		TRY (H5t_get_bounding_box_of_octant (
+			     m->octree, new_numbering[start + i], oct_bb));
+		h5_float64_t center[3];
+		for (int k = 0; k < 3; k++) {
+			center[k] = (oct_bb[k] + oct_bb[k+3]) / 2.0;
+		}
+		keys[i] = morton_key (center, bb);
+		oct_weights[i] = m->num_weights > 0 ? 0 : 1;
+		for (int k = 0; k < m->num_weights; k++) {
+			oct_weights[i] += weights[i * m->num_weights + k];
+		}
+	}
+	TRY (partition_sfc (m, keys, oct_weights, num_interior_oct, part));
+
+	MPI_Datatype type = sizeof (idx_t) == sizeof (int) ? MPI_INT : MPI_LONG_LONG;
+	int* recvcounts;
+	int* recvdispls;
+	TRY (recvcounts = h5_calloc (m->f->nprocs, sizeof (*recvcounts)));
+	TRY (recvdispls = h5_calloc (m->f->nprocs, sizeof (*recvdispls)));
+	for (int i = 0; i < m->f->nprocs; i++) {
+		recvcounts[i] = vtxdist[i+1]-vtxdist[i];
+		recvdispls[i] = vtxdist[i];
+	}
+	TRY (h5priv_mpi_allgatherv (part,
+			num_interior_oct,
+			type,
+			glb_part,
+			recvcounts,
+			recvdispls,
+			type,
+			m->f->props->comm));
+	TRY (h5_free (recvdispls));
+	TRY (h5_free (recvcounts));
+	TRY (h5_free (part));
+	TRY (h5_free (oct_weights));
+	TRY (h5_free (keys));
+	H5_RETURN (H5_SUCCESS);
+}
+
 static h5_err_t
 distribute_octree_parmetis (
 	h5t_mesh_t* const m,
@@ -2020,7 +2851,9 @@ distribute_octree_parmetis (
 #endif
 	}
 	TRY (glb_part = h5_calloc (vtxdist[m->f->nprocs], sizeof(*glb_part)));
-	if (!dont_use_parmetis) {
+	if (m->f->props->mesh_partitioner == H5_PARTITIONER_SFC) {
+		TRY (partition_octants_sfc (m, weights, new_numbering, vtxdist, glb_part));
+	} else if (!dont_use_parmetis) {
 		//	// read cells only
 		idx_t start = vtxdist[m->f->myproc];
 		idx_t num_interior_oct = vtxdist[m->f->myproc+1] - start;
@@ -2056,7 +2889,8 @@ distribute_octree_parmetis (
 					m->leaf_level));
 			if (counter + num_neigh >= num_alloc_adj) {
 				 // WARNING may alloc too much mem (minimal would be counter + num_neigh)
-				adjncy = realloc (adjncy, (num_alloc_adj + counter + num_neigh) * sizeof(*adjncy));
+				num_alloc_adj += counter + num_neigh;
+				TRY (adjncy = h5_alloc (adjncy, num_alloc_adj * sizeof(*adjncy)));
 			}
 			xadj[i+1] = xadj[i] + num_neigh;
 #if !defined(NDEBUG)
@@ -2162,8 +2996,7 @@ distribute_octree_parmetis (
 				MPI_INT,
 				m->f->props->comm));
 		TRY (h5_free (part));
-	}
-	if (dont_use_parmetis == 1 ) { // not use parmetis and just distribute octants with morton ordering
+	} else if (dont_use_parmetis == 1 ) { // not use parmetis and just distribute octants with morton ordering
 		int curr_proc = 0;
 		for (int i = 0; i < vtxdist[m->f->nprocs]; i++) {
 			while(i >= vtxdist[curr_proc +1]) {
@@ -2172,8 +3005,7 @@ distribute_octree_parmetis (
 			glb_part[i] = curr_proc;
 		}
 
-	}
-	if (dont_use_parmetis == 2) { // distribute geometrically in slices acc to preferred direction.
+	} else if (dont_use_parmetis == 2) { // distribute geometrically in slices acc to preferred direction.
 		assert (preferred_direction > -1 && preferred_direction <3);
 		// calculate slices
 		h5_float64_t* bb = H5t_get_bounding_box(m->octree);
@@ -2484,12 +3316,12 @@ read_chunked_elements (
 	}
 
 	TRY (h5priv_start_throttle (m->f));
-	TRY (hdf5_read_dataset (
+	TRY (h5priv_trace_read (
+	             m->f, __func__,
 	             dset_id,
 	             m->dsinfo_elems.type_id,
 	             mspace_id,
 	             dspace_id,
-	             m->f->props->xfer_prop,
 	             *glb_elems));
 	TRY (h5priv_end_throttle (m->f));
 	TRY (hdf5_close_dataspace (dspace_id));
@@ -2540,20 +3372,20 @@ h5tpriv_read_chunked_mesh (
         ) {
 	H5_PRIV_API_ENTER (h5_err_t, "m=%p", m);
 #ifdef WITH_PARALLEL_H5GRID
-
+	TRY (h5tpriv_profile_begin (m, "read_octree"));
 	TRY (read_octree (m));
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
+	TRY (h5tpriv_profile_end (m, "read_octree"));
+	TRY (h5tpriv_profile_begin (m, "read_chunks"));
 	TRY (read_chunks (m));
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
+	TRY (h5tpriv_profile_end (m, "read_chunks"));
+	TRY (h5tpriv_profile_begin (m, "read_weights"));
 	if (m->num_weights > 0) {
 		TRY (read_weights (m));
 	} else {
 		m->weights = NULL;
 	}
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
+	TRY (h5tpriv_profile_end (m, "read_weights"));
+	TRY (h5tpriv_profile_begin (m, "distribute_chunks"));
 	h5_oct_idx_t* new_numbering = NULL;
 	idx_t* weights = NULL;
 	h5_oct_idx_t num_tot_leaf_oct = -1;
@@ -2561,17 +3393,15 @@ h5tpriv_read_chunked_mesh (
 
 	TRY (distribute_octree_parmetis (m, weights, new_numbering, num_tot_leaf_oct));
 	TRY (h5_free (weights));
+	TRY (h5tpriv_profile_end (m, "distribute_chunks"));
 
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-
+	TRY (h5tpriv_profile_begin (m, "read_elems"));
 	h5_glb_elem_t* glb_elems = NULL;
 	h5_int32_t* my_procs = NULL;
 	TRY (read_chunked_elements (m, &glb_elems, &my_procs));
+	TRY (h5tpriv_profile_end (m, "read_elems"));
 
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-
+	TRY (h5tpriv_profile_begin (m, "init_vertex_map"));
 	h5_loc_idx_t num_interior_elems = m->num_interior_elems[m->leaf_level];
 	// add interior elements to global -> local index map
 	TRY (h5tpriv_init_map_elem_g2l (m, glb_elems, num_interior_elems));
@@ -2616,15 +3446,16 @@ h5tpriv_read_chunked_mesh (
 		m->num_loc_vertices[i] += m->num_loc_vertices[i-1];
 	}
 
-	h5priv_sort_idxmap (map);
+	TRY (h5priv_sort_idxmap (map));
 	for (h5_loc_idx_t i = 0; i < map->num_items; i++) {
 		map->items[i].loc_idx = i;
 	}
+	TRY (h5tpriv_profile_end (m, "init_vertex_map"));
+	TRY (h5tpriv_profile_begin (m, "read_vertices"));
 	TRY (read_vertices (m, map));
+	TRY (h5tpriv_profile_end (m, "read_vertices"));
 
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-
+	TRY (h5tpriv_profile_begin (m, "update_internal_structs"));
 	m->num_loaded_levels = m->num_leaf_levels;
 	// calculate which elem belongs to which proc
 	TRY (h5tpriv_init_loc_elems_struct (m, glb_elems, 0, num_interior_elems, 0, my_procs));
@@ -2632,27 +3463,14 @@ h5tpriv_read_chunked_mesh (
 
 	TRY (h5tpriv_update_internal_structs (m, 0)); //TODO check if that should be 0 or m->leaf_level
 	TRY (h5_free (glb_elems));
-
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
+	TRY (h5tpriv_profile_end (m, "update_internal_structs"));
+	m->num_written_levels = m->num_leaf_levels;
 #endif	
 	H5_RETURN (H5_SUCCESS);
 }
 
 
 
-static int
-cmp_glb_idx (
-        const void* x,
-        const void* y
-        ) {
-	if (*(h5_glb_idx_t*)x < *(h5_glb_idx_t*)y) return -1;
-	if (*(h5_glb_idx_t*)x > *(h5_glb_idx_t*)y) return 1;
-
-	return 0;
-}
-
-
 static h5_err_t
 read_elems_part (
         h5t_mesh_t* const m,
@@ -2702,12 +3520,12 @@ read_elems_part (
 	}
 	hid_t dset_id;
 	TRY (dset_id = hdf5_open_dataset_by_name (m->mesh_gid, m->dsinfo_elems.name));
-	TRY (hdf5_read_dataset (
+	TRY (h5priv_trace_read (
+	             m->f, __func__,
 	             dset_id,
 	             m->dsinfo_elems.type_id,
 	             mspace_id,
 	             dspace_id,
-	             m->f->props->xfer_prop,
 	             elems));
 	TRY (hdf5_close_dataspace (dspace_id));
 	TRY (hdf5_close_dataspace (mspace_id));
@@ -2724,24 +3542,14 @@ h5tpriv_read_mesh_part (
         h5_glb_idx_t num_elems
         ) {
 	H5_PRIV_API_ENTER (h5_err_t, "m=%p", m);
-#ifdef WITH_PARALLEL_H5GRID
-	TRY (h5priv_mpi_barrier (m->f->props->comm)); // octree
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-	TRY (h5priv_mpi_barrier (m->f->props->comm)); // chunks
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-	TRY (h5priv_mpi_barrier (m->f->props->comm)); // weights
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-	TRY (h5priv_mpi_barrier (m->f->props->comm)); // distribute chunks
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-#endif
+	TRY (h5tpriv_profile_begin (m, "read_elems"));
 	h5_glb_elem_t* glb_elems = NULL;
 	TRY (read_elems_part (m, &glb_elems, elem_indices, num_elems));
 	h5_loc_idx_t num_interior_elems = m->num_interior_elems[0];
 	h5_loc_idx_t num_ghost_elems = m->num_ghost_elems[0] = 0;
-#ifdef WITH_PARALLEL_H5GRID
-	TRY (h5priv_mpi_barrier (m->f->props->comm)); // read elems
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-#endif
+	TRY (h5tpriv_profile_end (m, "read_elems"));
+
+	TRY (h5tpriv_profile_begin (m, "init_vertex_map"));
 	// add interior elements to global -> local index map
 	TRY (h5tpriv_init_map_elem_g2l (m, glb_elems, num_interior_elems));
 
@@ -2774,26 +3582,24 @@ h5tpriv_read_mesh_part (
 		}
 	}
 	TRY (h5priv_hdestroy (&htab));
-	h5priv_sort_idxmap (map);
+	TRY (h5priv_sort_idxmap (map));
 	for (h5_loc_idx_t i = 0; i < map->num_items; i++) {
 		map->items[i].loc_idx = i;
 	}
+	TRY (h5tpriv_profile_end (m, "init_vertex_map"));
+	TRY (h5tpriv_profile_begin (m, "read_vertices"));
 	TRY (read_vertices (m, map));
+	TRY (h5tpriv_profile_end (m, "read_vertices"));
+
+	TRY (h5tpriv_profile_begin (m, "update_internal_structs"));
 	TRY (h5tpriv_alloc_loc_elems (m, 0, num_interior_elems+num_ghost_elems));
 	m->num_loaded_levels = 1;
-#ifdef WITH_PARALLEL_H5GRID
-	TRY (h5priv_mpi_barrier (m->f->props->comm)); // read vtx
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-#endif
 	TRY (h5tpriv_init_loc_elems_struct (m, glb_elems, 0, num_interior_elems, 0, NULL));
 	TRY (h5tpriv_init_elem_flags (m, 0, num_interior_elems+num_ghost_elems));
 	TRY (h5tpriv_update_internal_structs (m, 0));
 
 	TRY (h5_free (glb_elems));
-#ifdef WITH_PARALLEL_H5GRID
-	TRY (h5priv_mpi_barrier (m->f->props->comm)); // init update
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-#endif
+	TRY (h5tpriv_profile_end (m, "update_internal_structs"));
 	H5_RETURN (H5_SUCCESS);
 }
 
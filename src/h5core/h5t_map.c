@@ -93,7 +93,7 @@ h5tpriv_find_glb_idx_in_map (
 	H5_CORE_API_ENTER (h5_loc_idx_t, "m=%p, glb_idx=%lld", map, (long long)glb_idx);
 	if (glb_idx < 0) return -1;
 
-	h5_loc_idx_t loc_idx = h5priv_search_idxmap (map, glb_idx); // loc_idx is position in map
+	h5_loc_idx_t loc_idx = h5priv_find_idxmap (map, glb_idx); // loc_idx is position in map
 	if (loc_idx < 0) { // set to next position
 		loc_idx = map->num_items;
 	}
@@ -112,7 +112,7 @@ h5t_map_global_vertex_idx2local (
 	if (glb_idx < 0) return -1;
 
 	// loc_idx is position in map
-	h5_loc_idx_t loc_idx = h5priv_search_idxmap (&m->map_vertex_g2l, glb_idx);
+	h5_loc_idx_t loc_idx = h5priv_find_idxmap (&m->map_vertex_g2l, glb_idx);
 	if (loc_idx < 0) {
 		H5_LEAVE (
 			h5tpriv_error_global_id_nexist ("vertex", glb_idx));
@@ -162,7 +162,7 @@ h5t_map_glb_elem_idx2loc (
 	// global index is -1, if the cell is at the geometric border
 	if (glb_idx < 0) H5_LEAVE (-1);
 
-	h5_loc_idx_t i = h5priv_search_idxmap (&m->map_elem_g2l, glb_idx);
+	h5_loc_idx_t i = h5priv_find_idxmap (&m->map_elem_g2l, glb_idx);
 	// global index >= 0 && negative result means: element is on other proc
 	if (i < 0) H5_LEAVE (-glb_idx-2);
 
@@ -212,7 +212,7 @@ h5tpriv_rebuild_map_vertex_g2l (
 		item->loc_idx = loc_idx;
 		m->map_vertex_g2l.num_items++;
 	}
-	h5priv_sort_idxmap (&m->map_vertex_g2l);
+	TRY (h5priv_sort_idxmap (&m->map_vertex_g2l));
 	H5_RETURN (H5_SUCCESS);
 }
 /*
@@ -235,7 +235,7 @@ h5tpriv_rebuild_map_vertex_g2l_partial (
 		item->loc_idx = loc_idx;
 		m->map_vertex_g2l.num_items++;
 	}
-	h5priv_sort_idxmap (&m->map_vertex_g2l);
+	TRY (h5priv_sort_idxmap (&m->map_vertex_g2l));
 	H5_RETURN (H5_SUCCESS);
 }
 /*
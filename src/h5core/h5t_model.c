@@ -22,6 +22,7 @@
 #include "private/h5t_adjacencies.h"
 #include "private/h5t_io.h"
 #include "private/h5t_tags.h"
+#include "private/h5t_profile.h"
 
 #include "h5core/h5_model.h"
 #include "private/h5t_core.h"
@@ -63,14 +64,12 @@ h5tpriv_init_mesh (
 
 	m->mesh_changed = 0;
 	m->num_leaf_levels = -1;
+	m->num_written_levels = 0;
 	m->leaf_level = 0;
 	m->last_stored_vid = -1;
 	m->last_stored_eid = -1;
 	m->last_stored_vid_before_ref = -1;
 	m->last_stored_eid_before_ref = -1;
-	m->timing.num_timing = NUM_TIMING;
-	m->timing.next_time = 0;
-	m->timing.f = NULL;
 	m->is_chunked = 0;
 #if defined(WITH_PARALLEL_H5GRID)
 
@@ -280,7 +279,7 @@ release_elems (
 	TRY (h5_free (m->num_interior_elems));          m->num_interior_elems = NULL;
 	TRY (h5_free (m->num_interior_leaf_elems));     m->num_interior_leaf_elems = NULL;
 	TRY (h5_free (m->num_ghost_elems));             m->num_ghost_elems = NULL;
-	TRY (h5_free (m->map_elem_g2l.items));          m->map_elem_g2l.items = NULL;
+	TRY (h5priv_free_idxmap (&m->map_elem_g2l));
 	H5_RETURN (H5_SUCCESS);
 }
 
@@ -292,7 +291,7 @@ release_vertices (
 	TRY (h5_free (m->vertices));                    m->vertices = NULL;
 	TRY (h5_free (m->num_glb_vertices));            m->num_glb_vertices = NULL;
 	TRY (h5_free (m->num_loc_vertices));            m->num_loc_vertices = NULL;
-	TRY (h5_free (m->map_vertex_g2l.items));        m->map_vertex_g2l.items = NULL;
+	TRY (h5priv_free_idxmap (&m->map_vertex_g2l));
 	TRY (h5_free (m->first_b_vtx)); 				m->first_b_vtx = NULL;
 	TRY (h5_free (m->num_b_vtx)); 					m->num_b_vtx = NULL;
 	H5_RETURN (H5_SUCCESS);
@@ -313,75 +312,16 @@ release_memory (
 		TRY (h5_free (m->weights));
 	}
 #endif
+	TRY (h5tpriv_free_profile (m));
 	TRY (h5_free (m));
 	H5_RETURN (H5_SUCCESS);
 }
 
-h5_err_t
-write_timing (
-		h5t_mesh_t* const m
-) {
-	H5_CORE_API_ENTER (h5_err_t, "m=%p", m);
-	if (m->f->myproc == 0 && m->timing.f != NULL) {
-		FILE* file = fopen (m->timing.f,"a");
-		h5_time_t tmp =m->timing.measure[m->timing.num_timing-1]- m->timing.measure[0];
-		fprintf (file,"#writing timing \n "
-				" nprocs max_chunks num_elems tot_time init_mesh "
-				" reading_octree reading_chunks reading_weights "
-				" distributing_chunks reading_elems reading_vtx "
-				" internal_update ref pre_ref ref  boundary weights "
-				" init_glb_elems init_glb_vtx exchange_glb_structs "
-				" store_glb_struct post_ref close "
-				" write_weights write_chunks write_octree "
-				" calc_vtx_map vtx_hyperslap write_vertices write_elems "
-				"\n"
-				" %d %d %lld %4.4f",
-				m->f->nprocs, max_num_elems_p_chunk,
-				(long long int) m->num_glb_elems[m->num_leaf_levels-1],
-				tmp >=0 ? tmp: 0);
-
-		for (int i = 1; i < m->timing.num_timing; i++) {
-			tmp = m->timing.measure[i]- m->timing.measure[i-1] ;
-			fprintf (file," %4.4f ", tmp >=0 ? tmp: 0 );
-		}
-		fprintf (file,"\n");
-		fprintf (file, "# nprocs reading_octree_chunks distribute_chunks reading_elems"
-				" reading_vtx refinement postrefinement write_oct_chunks "
-				" vtx_hyperslaps write_vtx write_elems\n");
-		fprintf (file,"# %d %4.4f %4.4f %4.4f %4.4f %4.4f %4.4f %4.4f %4.4f %4.4f %4.4f \n\n",
-				m->f->nprocs,
-				m->timing.measure[4] - m->timing.measure[0],
-				m->timing.measure[5] - m->timing.measure[4],
-				m->timing.measure[6] - m->timing.measure[5],
-				m->timing.measure[8] - m->timing.measure[6],
-				m->timing.measure[11] - m->timing.measure[8],
-				m->timing.measure[18] - m->timing.measure[11],
-				m->timing.measure[22] - m->timing.measure[18],
-				m->timing.measure[24] - m->timing.measure[22],
-				m->timing.measure[25] - m->timing.measure[24],
-				m->timing.measure[26] - m->timing.measure[25]);
-		fclose (file);
-	}
-	H5_RETURN (H5_SUCCESS);
-}
-h5_err_t
-set_timing_file (
-		h5t_mesh_t* const m,
-		char* time_f
-		) {
-	H5_CORE_API_ENTER (h5_err_t, "m=%p", m);
-	m->timing.f = time_f;
-	H5_RETURN (H5_SUCCESS);
-}
 h5_err_t
 h5t_close_mesh (
         h5t_mesh_t* const m
         ) {
 	H5_CORE_API_ENTER (h5_err_t, "m=%p", m);
-#ifdef WITH_PARALLEL_H5GRID
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-#endif
 	// check if tagsets are still open
 	if (m->mtagsets && m->mtagsets->num_items > 0)
 		H5_RETURN_ERROR (
@@ -389,17 +329,44 @@ h5t_close_mesh (
 			"%s",
 			"Mesh cannot be closed: Mesh is referenced by open tagsets");
 
+	TRY (h5tpriv_profile_begin (m, "close_mesh"));
 	if (!(m->f->props->flags & H5_O_RDONLY)) {
 		TRY (h5tpriv_write_mesh (m));
 	}
 	TRY (hdf5_close_group (m->mesh_gid));
-#ifdef WITH_PARALLEL_H5GRID
-	TRY (write_timing (m));
-#endif
+	TRY (h5tpriv_profile_end (m, "close_mesh"));
+	TRY (h5tpriv_write_profile (m));
 	TRY (release_memory (m));
 	H5_RETURN (H5_SUCCESS);
 }
 
+h5_err_t
+h5t_set_profile_file (
+        h5t_mesh_t* const m,
+        const char* const filename
+        ) {
+	H5_CORE_API_ENTER (h5_err_t, "m=%p, filename=%s", m, filename);
+	H5_RETURN (h5tpriv_set_profile_file (m, filename));
+}
+
+h5_err_t
+h5t_begin_profile (
+        h5t_mesh_t* const m,
+        const char* const label
+        ) {
+	H5_CORE_API_ENTER (h5_err_t, "m=%p, label=%s", m, label);
+	H5_RETURN (h5tpriv_profile_begin (m, label));
+}
+
+h5_err_t
+h5t_end_profile (
+        h5t_mesh_t* const m,
+        const char* const label
+        ) {
+	H5_CORE_API_ENTER (h5_err_t, "m=%p, label=%s", m, label);
+	H5_RETURN (h5tpriv_profile_end (m, label));
+}
+
 h5_err_t
 h5t_set_level (
         h5t_mesh_t* const m,
@@ -425,6 +392,7 @@ h5t_set_mesh_changed (
         ) {
 	H5_CORE_API_ENTER (h5_err_t, "m=%p",m);
 	m->mesh_changed = 1;
+	m->num_written_levels = 0;	// write whole mesh
 	H5_RETURN (H5_SUCCESS);
 }
 
@@ -529,135 +529,124 @@ get_nbr_octants (
  */
 #endif
 
+int compare_oct_idx (const void *p_a, const void *p_b);
+
+/*
+ * Make global update because user data changed. Every proc keeps the
+ * userdata of all octants, thus changed userdata is gathered on all
+ * procs. Octant index and userdata are packed into one record, so
+ * indices and data are exchanged together.
+ */
 static h5_err_t
 update_userdata (
         h5t_octree_t* const octree
         ) {
 	H5_PRIV_FUNC_ENTER (h5_err_t, "octree=%p", octree);
-	h5_oct_idx_t* oct_idx;
-	TRY (oct_idx = h5_calloc (octree->current_oct_idx + 1, sizeof (*oct_idx)));
+	const size_t size_userdata = octree->size_userdata;
+	const size_t rec_size = sizeof (h5_oct_idx_t) + size_userdata;
+	char* userdata = (char*)octree->userdata;
+
+	// pack changed octants: index followed by userdata
 	h5_oct_idx_t nbr_loc_oct_changed = 0;
 	for (int i = 0; i <= octree->current_oct_idx; i++) {
 		if ((octree->octants[i].level_idx & (1 << OCT_CHG_USERDATA)) == (1 << OCT_CHG_USERDATA)) {
-			oct_idx[nbr_loc_oct_changed] = i;
 			nbr_loc_oct_changed++;
 		}
 	}
+	char* sendbuf;
+	TRY (sendbuf = h5_calloc (nbr_loc_oct_changed + 1, rec_size));
+	for (h5_oct_idx_t i = 0, k = 0; i <= octree->current_oct_idx; i++) {
+		if ((octree->octants[i].level_idx & (1 << OCT_CHG_USERDATA)) == (1 << OCT_CHG_USERDATA)) {
+			memcpy (&sendbuf[k*rec_size], &i, sizeof (i));
+			memcpy (&sendbuf[k*rec_size + sizeof (i)],
+			        &userdata[i*size_userdata],
+			        size_userdata);
+			k++;
+		}
+	}
 
 	// exchange the number of changed octants
 	int size;
+	int rank;
 	TRY (h5priv_mpi_comm_size (octree->comm, &size));
-	h5_int32_t* nbr_oct_changed;
-	TRY (nbr_oct_changed = h5_calloc (size, sizeof (*nbr_oct_changed)));
-
+	TRY (h5priv_mpi_comm_rank (octree->comm, &rank));
+	int* recv_counts;
+	int* recv_displs;
+	TRY (recv_counts = h5_calloc (size, sizeof (*recv_counts)));
+	TRY (recv_displs = h5_calloc (size, sizeof (*recv_displs)));
 	TRY (h5priv_mpi_allgather (&nbr_loc_oct_changed,
 	                          1,
 	                          MPI_INT,
-	                          nbr_oct_changed,
+	                          recv_counts,
 	                          1,
 	                          MPI_INT,
 	                          octree->comm));
-
-
-	// exchange the changed octant_id's
-	h5_oct_idx_t* changed_oct_idx;
-	h5_oct_idx_t* recv_displs;
-	h5_oct_idx_t* recv_counts = nbr_oct_changed;    // just for simpler naming
-	h5_oct_idx_t nbr_glb_oct_changed = nbr_oct_changed[0];
-
-	TRY (recv_displs = h5_calloc(size,sizeof(*recv_displs)));
-
-	recv_displs[0] = 0;
-
-	for (int i = 1; i < size; i++) {
-		recv_displs[i] = recv_displs[i-1] + nbr_oct_changed[i-1];
-		nbr_glb_oct_changed += nbr_oct_changed[i];
-	};
-	TRY (changed_oct_idx = h5_calloc (nbr_glb_oct_changed, sizeof (*changed_oct_idx)));
-	TRY (mpi_allgatherv (oct_idx,
-	                     nbr_loc_oct_changed,
-	                     MPI_INT,
-	                     changed_oct_idx,
-	                     recv_counts,
-	                     recv_displs,
-	                     MPI_INT,
-	                     octree->comm
-	                     ));
-
-	// check if an octant has been changed on multiple procs
-	h5_oct_idx_t oct_idx_to_check;
-	for (int i = 0; i < nbr_glb_oct_changed - 1; i++) {
-		oct_idx_to_check = changed_oct_idx[i];
-		for (int j = i + 1; j < nbr_glb_oct_changed; j++) {
-			if (oct_idx_to_check == changed_oct_idx[j]) {
+	h5_oct_idx_t nbr_glb_oct_changed = 0;
+	for (int i = 0; i < size; i++) {
+		recv_displs[i] = nbr_glb_oct_changed;
+		nbr_glb_oct_changed += recv_counts[i];
+	}
+
+	if (nbr_glb_oct_changed > 0) {
+		// exchange changed octants
+		char* recvbuf;
+		TRY (recvbuf = h5_calloc (nbr_glb_oct_changed, rec_size));
+		MPI_Datatype rec_type;
+		TRY (h5priv_mpi_type_contiguous (rec_size, MPI_BYTE, &rec_type));
+		TRY (mpi_allgatherv (
+		             sendbuf,
+		             nbr_loc_oct_changed,
+		             rec_type,
+		             recvbuf,
+		             recv_counts,
+		             recv_displs,
+		             rec_type,
+		             octree->comm
+		             ));
+		TRY (h5priv_mpi_type_free (&rec_type));
+
+		// check if an octant has been changed on multiple procs
+		h5_oct_idx_t* changed_oct_idx;
+		TRY (changed_oct_idx = h5_calloc (nbr_glb_oct_changed, sizeof (*changed_oct_idx)));
+		for (h5_oct_idx_t i = 0; i < nbr_glb_oct_changed; i++) {
+			memcpy (&changed_oct_idx[i], &recvbuf[i*rec_size], sizeof (*changed_oct_idx));
+		}
+		qsort (changed_oct_idx, nbr_glb_oct_changed, sizeof (*changed_oct_idx),
+		       compare_oct_idx);
+		for (h5_oct_idx_t i = 1; i < nbr_glb_oct_changed; i++) {
+			if (changed_oct_idx[i] == changed_oct_idx[i-1]) {
 				/*** an octant was changed twice! ***/
 				H5_RETURN_ERROR (
 					H5_ERR_INVAL,
 					"Multiple cores tried to update the same userdata with idx: %d",
-					oct_idx_to_check);
-			};
-		};
-	};
-	/*** exchange changed userdata ***/
-	// new mpi datatype for userdata
-	MPI_Datatype userdata_type;
-
-	TRY (h5priv_mpi_type_contiguous (octree->size_userdata, MPI_BYTE, &userdata_type));
-	TRY (h5priv_mpi_type_commit (&userdata_type));
-
-	void* sendbuf;
-	void* recvbuf;
-	TRY (sendbuf = h5_calloc (nbr_loc_oct_changed, octree->size_userdata));
-	TRY (recvbuf = h5_calloc (nbr_glb_oct_changed, octree->size_userdata));
-
-//	recv_counts[0] *=  octree->size_userdata;
-//	for (int i = 1; i < size; i++) {
-//		recv_displs[i] *=  octree->size_userdata;
-//		recv_counts[i] *=  octree->size_userdata;
-//	};
-	char* charp_to = (char*) sendbuf;
-	char* charp_from = (char*) octree->userdata;
-	// memcpy to send buffer
-	for (int i = 0; i < nbr_loc_oct_changed; i++) {
-		memcpy( &(charp_to[i*octree->size_userdata]),
-		        &(charp_from[oct_idx[i]*octree->size_userdata]),
-		        octree->size_userdata);
-	};
-
-	TRY (mpi_allgatherv (
-	            sendbuf,
-	            nbr_loc_oct_changed,
-	            userdata_type,
-	            recvbuf,
-	            recv_counts,
-	            recv_displs,
-	            userdata_type,
-	            octree->comm
-	            ));
-	// copy user data to local memory location
-	charp_to = octree->userdata;
-	charp_from = recvbuf;
-	//TODO could be improved by not copying the already local updated octants
-	for (int i = 0; i < nbr_glb_oct_changed; i++) {
-		memcpy( &(charp_to[changed_oct_idx[i] * octree->size_userdata]),
-		        &(charp_from[i * octree->size_userdata]),
-		        octree->size_userdata);
+					changed_oct_idx[i]);
+			}
+		}
+		TRY (h5_free (changed_oct_idx));
+
+		// copy user data of other procs to local memory location
+		h5_oct_idx_t first_own = recv_displs[rank];
+		h5_oct_idx_t last_own = first_own + recv_counts[rank];
+		for (h5_oct_idx_t i = 0; i < nbr_glb_oct_changed; i++) {
+			if (i >= first_own && i < last_own) {
+				continue;
+			}
+			h5_oct_idx_t oct_idx;
+			memcpy (&oct_idx, &recvbuf[i*rec_size], sizeof (oct_idx));
+			memcpy (&userdata[oct_idx*size_userdata],
+			        &recvbuf[i*rec_size + sizeof (oct_idx)],
+			        size_userdata);
+		}
+		TRY (h5_free (recvbuf));
 	}
 	// set changed user data to 0
 	for (int i = 0; i <= octree->current_oct_idx; i++) {
-		if (i == octree->nbr_alloc_oct) { h5_debug ("THIS shoul not happen");}
 		octree->octants[i].level_idx &= ~(1 << OCT_CHG_USERDATA);
 	}
-	// free memory
 
-	TRY (h5_free (oct_idx));
-	TRY (h5_free (nbr_oct_changed));
 	TRY (h5_free (sendbuf));
-	TRY (h5_free (recvbuf));
+	TRY (h5_free (recv_counts));
 	TRY (h5_free (recv_displs));
-	TRY (h5_free (changed_oct_idx));
-	//MPI_Type_free(&userdata_type);
-
 	H5_RETURN (H5_SUCCESS);
 };
 h5_err_t
@@ -1114,6 +1103,7 @@ free_oct (
 			TRY (h5_free (octree->userdata));
 		}
 		MPI_Type_free(&h5_oct_dta_types.mpi_octant);
+		TRY (h5_free (octree->leaves));
 		TRY (h5_free (octree->octants));
 		TRY (h5_free (octree));
 		octree = NULL;
@@ -1602,55 +1592,23 @@ end_refine_octants(
 }
 
 /*
- * compare func for qsort bsearch
+ * orientation of child octant containing point, same as in
+ * get_new_bounding_box()
  */
-int compare_points_x(const void *p_a, const void *p_b)
-{
-return ((*(h5_oct_point_t*)p_a).x - (*(h5_oct_point_t*)p_b).x) >= 0 ? 1 : 0;
-}
-int compare_points_y(const void *p_a, const void *p_b)
-{
-return ((*(h5_oct_point_t*)p_a).y - (*(h5_oct_point_t*)p_b).y) >= 0 ? 1 : 0;
-}
-int compare_points_z(const void *p_a, const void *p_b)
-{
-return ((*(h5_oct_point_t*)p_a).z - (*(h5_oct_point_t*)p_b).z) >= 0 ? 1 : 0;
-}
-int sort_points_x(const void *p_a, const void *p_b)
-{
-
-	if (((*(h5_oct_point_t*)p_a).x - (*(h5_oct_point_t*)p_b).x) < 0 )
-		return -1 ;
-	if (((*(h5_oct_point_t*)p_a).x - (*(h5_oct_point_t*)p_b).x) == 0 )
-		return 0;
-	if (((*(h5_oct_point_t*)p_a).x - (*(h5_oct_point_t*)p_b).x) > 0 )
-		return 1 ;
-	 return -1; // will never be executed
-}
-int sort_points_y(const void *p_a, const void *p_b)
-{
-	if (((*(h5_oct_point_t*)p_a).y - (*(h5_oct_point_t*)p_b).y) < 0 )
-		return -1 ;
-	if (((*(h5_oct_point_t*)p_a).y - (*(h5_oct_point_t*)p_b).y) == 0 )
-		return 0;
-	if (((*(h5_oct_point_t*)p_a).y - (*(h5_oct_point_t*)p_b).y) > 0 )
-		return 1 ;
-	 return -1; // will never be executed
-}
-int sort_points_z(const void *p_a, const void *p_b)
-{
-	if (((*(h5_oct_point_t*)p_a).z - (*(h5_oct_point_t*)p_b).z) < 0 )
-		return -1 ;
-	if (((*(h5_oct_point_t*)p_a).z - (*(h5_oct_point_t*)p_b).z) == 0 )
-		return 0;
-	if (((*(h5_oct_point_t*)p_a).z - (*(h5_oct_point_t*)p_b).z) > 0 )
-		return 1 ;
- return -1; // will never be executed
+static inline h5_oct_orient_t
+get_orient_of_point (
+	const h5_oct_point_t* const midpoint,
+	const h5_oct_point_t* const point
+	) {
+	return (point->x >= midpoint->x)
+		| (point->y >= midpoint->y) << 1
+		| (point->z >= midpoint->z) << 2;
 }
 
-
 /*
- * multidimensional sort of array of points
+ * Partition points into the 8 children of the octant with the given
+ * midpoint, points of child i start at split[i]. The points are counted
+ * per child in one pass and then permuted in place.
  */
 static h5_err_t
 sort_array (
@@ -1662,80 +1620,33 @@ sort_array (
 	) {
 	H5_PRIV_FUNC_ENTER (h5_err_t, "key=%p, points=%p, nbr_points=%d, split=%p, nbr_in_split=%p",
 			key, points, nbr_points, split, nbr_in_split);
-
-	// sort in z
-	comparison_fn_t compare;
-	compare.compare = compare_points_z;
-	split[0] = points;
-	qsort (points, nbr_points, sizeof (*points), sort_points_z);
-	split[4] = linsearch (key, points, nbr_points, sizeof (*points), compare);
-	if (split[4] == NULL) {
-		nbr_in_split[0] = nbr_points;
-	} else {
-		nbr_in_split[0] = split[4] - split[0];
-	}
-	nbr_in_split[4] = nbr_points - nbr_in_split[0];
-
-
-	// sort in y
-	compare.compare = compare_points_y;
-	qsort (split[0], nbr_in_split[0], sizeof (*points), sort_points_y);
-	qsort (split[4], nbr_in_split[4], sizeof (*points), sort_points_y);
-	split[2] = linsearch (key, split[0], nbr_in_split[0], sizeof (*points), compare);
-	split[6] = linsearch (key, split[4], nbr_in_split[4], sizeof (*points), compare);
-	if (split[2] == NULL) {
-		nbr_in_split[2] = 0;
-	} else {
-		nbr_in_split[2] = nbr_in_split[0] - (split[2] - split[0]);
-	}
-	nbr_in_split[0] -= nbr_in_split[2];
-
-	if (split[6] == NULL) {
-		nbr_in_split[6] = 0;
-	} else {
-		nbr_in_split[6] = nbr_in_split[4] - (split[6] - split[4]);
-	}
-	nbr_in_split[4] -= nbr_in_split[6];
-
-	// sort in x
-	compare.compare = compare_points_x;
-	qsort (split[0], nbr_in_split[0], sizeof (*points), sort_points_x);
-	qsort (split[2], nbr_in_split[2], sizeof (*points), sort_points_x);
-	qsort (split[4], nbr_in_split[4], sizeof (*points), sort_points_x);
-	qsort (split[6], nbr_in_split[6], sizeof (*points), sort_points_x);
-	split[1] = linsearch (key, split[0], nbr_in_split[0], sizeof (*points), compare);
-	split[3] = linsearch (key, split[2], nbr_in_split[2], sizeof (*points), compare);
-	split[5] = linsearch (key, split[4], nbr_in_split[4], sizeof (*points), compare);
-	split[7] = linsearch (key, split[6], nbr_in_split[6], sizeof (*points), compare);
-
-	if (split[1] == NULL) {
-		nbr_in_split[1] = 0;
-	} else {
-		nbr_in_split[1] = nbr_in_split[0] - (split[1] - split[0]);
-	}
-	nbr_in_split[0] -= nbr_in_split[1];
-
-	if (split[3] == NULL) {
-		nbr_in_split[3] = 0;
-	} else {
-		nbr_in_split[3] = nbr_in_split[2] - (split[3] - split[2]);
-	}
-	nbr_in_split[2] -= nbr_in_split[3];
-
-	if (split[5] == NULL) {
-		nbr_in_split[5] = 0;
-	} else {
-		nbr_in_split[5] = nbr_in_split[4] - (split[5] - split[4]);
-	}
-	nbr_in_split[4] -= nbr_in_split[5];
-
-	if (split[7] == NULL) {
-		nbr_in_split[7] = 0;
-	} else {
-		nbr_in_split[7] = nbr_in_split[6] - (split[7] - split[6]);
+	memset (nbr_in_split, 0, 8 * sizeof (*nbr_in_split));
+	for (h5_int32_t i = 0; i < nbr_points; i++) {
+		nbr_in_split[get_orient_of_point (key, &points[i])]++;
+	}
+	h5_int32_t next[8];
+	h5_int32_t end[8];
+	h5_int32_t start = 0;
+	for (int orient = 0; orient < 8; orient++) {
+		split[orient] = points + start;
+		next[orient] = start;
+		start += nbr_in_split[orient];
+		end[orient] = start;
+	}
+	// move each point to the next free slot of its child
+	for (int orient = 0; orient < 8; orient++) {
+		while (next[orient] < end[orient]) {
+			h5_oct_orient_t dest = get_orient_of_point (key, &points[next[orient]]);
+			if (dest == orient) {
+				next[orient]++;
+				continue;
+			}
+			h5_oct_point_t tmp = points[next[dest]];
+			points[next[dest]] = points[next[orient]];
+			points[next[orient]] = tmp;
+			next[dest]++;
+		}
 	}
-	nbr_in_split[6] -= nbr_in_split[7];
-
 	H5_RETURN (H5_SUCCESS);
 }
 /*
@@ -2023,9 +1934,287 @@ find_leafoctant_of_point (
 
 	H5_RETURN (ret_oct_idx);
 }
+
+/*
+ * Point-location index: the leaf octants sorted by their Morton key.
+ * The key of an octant is built from the orientations of the octant and
+ * its ancestors, 3 bits per level starting with the most significant
+ * bits. The leaves cover the bounding box without overlap, thus the leaf
+ * containing a point is the leaf with the greatest key not greater than
+ * the key of the point. The index is built on demand and rebuilt if
+ * octants have been added.
+ *
+ * This is not a linear octree: the index-linked octant array remains the
+ * storage of the octree and the index is an addition to it, used for
+ * point location only. Neighbour search (get_neighbors(), get_nca(),
+ * get_equal_sized_neigh()), iteration, partitioning and write_octree()
+ * work on the octant array.
+ */
+#define LEAF_KEY_MAX_DEPTH 21
+
+static int
+compare_leaf_key (
+	const void* p_a,
+	const void* p_b
+	) {
+	h5_uint64_t a = ((struct h5t_oct_leaf*)p_a)->key;
+	h5_uint64_t b = ((struct h5t_oct_leaf*)p_b)->key;
+	return (a > b) - (a < b);
+}
+
+static h5_err_t
+build_leaf_index (
+	h5t_octree_t* const octree
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "octree=%p", octree);
+	h5_oct_idx_t nbr_octants = octree->current_oct_idx + 1;
+	TRY (h5_free (octree->leaves));
+	octree->leaves = NULL;
+	octree->nbr_leaves = 0;
+	octree->leaf_depth = 0;
+	octree->leaves_of = octree->current_oct_idx + 1;
+
+	h5_uint64_t* keys;
+	TRY (keys = h5_calloc (nbr_octants, sizeof (*keys)));
+	h5_oct_idx_t nbr_leaves = octree->octants[0].child_idx == -1;
+	h5_oct_level_t depth = 0;
+	// children are always stored after their parent
+	for (h5_oct_idx_t i = 1; i < nbr_octants; i++) {
+		h5_oct_idx_t parent = get_parent (octree, i);
+		h5_oct_level_t level = get_oct_level (octree, i);
+		if (level > LEAF_KEY_MAX_DEPTH) {
+			// too deep for 64bit keys, use octree
+			TRY (h5_free (keys));
+			H5_LEAVE (H5_SUCCESS);
+		}
+		h5_uint64_t orient = i - get_children (octree, parent);
+		keys[i] = keys[parent] | orient << (3 * (LEAF_KEY_MAX_DEPTH - level));
+		if (octree->octants[i].child_idx == -1) {
+			nbr_leaves++;
+			if (level > depth)
+				depth = level;
+		}
+	}
+	TRY (octree->leaves = h5_calloc (nbr_leaves, sizeof (*octree->leaves)));
+	for (h5_oct_idx_t i = 0, j = 0; i < nbr_octants; i++) {
+		if (octree->octants[i].child_idx == -1) {
+			octree->leaves[j].key = keys[i];
+			octree->leaves[j].oct = i;
+			j++;
+		}
+	}
+	qsort (octree->leaves, nbr_leaves, sizeof (*octree->leaves), compare_leaf_key);
+	octree->nbr_leaves = nbr_leaves;
+	octree->leaf_depth = depth;
+	TRY (h5_free (keys));
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+ * Find leaf octant of point with binary search in the point-location
+ * index. Point must be inside bounding box of octree. Returns -1 if
+ * there is no index.
+ */
+static h5_oct_idx_t
+find_leaf_by_key (
+	h5t_octree_t* const octree,
+	const h5_oct_point_t* const point
+	) {
+	if (octree->leaves == NULL) {
+		return -1;
+	}
+	// key of point, midpoints are computed like in get_new_bounding_box()
+	h5_float64_t bb[6];
+	memcpy (bb, octree->bounding_box, sizeof (bb));
+	h5_uint64_t key = 0;
+	for (h5_oct_level_t level = 1; level <= octree->leaf_depth; level++) {
+		h5_float64_t xmid = (bb[0] + bb[3]) / 2;
+		h5_float64_t ymid = (bb[1] + bb[4]) / 2;
+		h5_float64_t zmid = (bb[2] + bb[5]) / 2;
+		h5_uint64_t orient = 0;
+		if (point->x >= xmid) {
+			orient |= 1;
+			bb[0] = xmid;
+		} else {
+			bb[3] = xmid;
+		}
+		if (point->y >= ymid) {
+			orient |= 2;
+			bb[1] = ymid;
+		} else {
+			bb[4] = ymid;
+		}
+		if (point->z >= zmid) {
+			orient |= 4;
+			bb[2] = zmid;
+		} else {
+			bb[5] = zmid;
+		}
+		key |= orient << (3 * (LEAF_KEY_MAX_DEPTH - level));
+	}
+	// last leaf with key <= key of point
+	h5_oct_idx_t low = 0;
+	h5_oct_idx_t high = octree->nbr_leaves;
+	while (high - low > 1) {
+		h5_oct_idx_t mid = low + (high - low) / 2;
+		if (octree->leaves[mid].key <= key) {
+			low = mid;
+		} else {
+			high = mid;
+		}
+	}
+	return octree->leaves[low].oct;
+}
+
+static h5_oct_idx_t
+find_leafoctant_of_point_indexed (
+	h5t_octree_t* octree,
+	h5_oct_idx_t oct_idx,
+	h5_float64_t* bounding_box,
+	h5_oct_point_t* point
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "octree=%p, oct_idx=%d, point=%p", octree, oct_idx, point);
+	// the index is valid only between refinements
+	if (oct_idx != 0 || octree->ref_oct_idx != -1) {
+		H5_LEAVE (find_leafoctant_of_point (octree, oct_idx, bounding_box, point));
+	}
+	if (!bounding_box_contains_point (octree->bounding_box, point)) {
+		H5_LEAVE (H5_ERR_INVAL);
+	}
+	if (octree->leaves_of != octree->current_oct_idx + 1) {
+		TRY (build_leaf_index (octree));
+	}
+	h5_oct_idx_t leaf = find_leaf_by_key (octree, point);
+	if (leaf < 0) {
+		H5_LEAVE (find_leafoctant_of_point (octree, oct_idx, bounding_box, point));
+	}
+	H5_RETURN (leaf);
+}
 h5_oct_idx_t
 H5t_find_leafoctant_of_point (h5t_octree_t* octree, h5_oct_idx_t oct_idx, h5_float64_t* bounding_box, h5_oct_point_t* point) {
-	return find_leafoctant_of_point (octree, oct_idx, bounding_box, point);
+	return find_leafoctant_of_point_indexed (octree, oct_idx, bounding_box, point);
+}
+
+/*
+ * Locate leaf octants of points in perm, all points must be inside the
+ * bounding box bb of octant oct_idx. At each level the points are
+ * bucketed by the orientation of the child containing them, thus every
+ * octant and its midpoint is computed once per group of points and the
+ * points end up sorted in Morton order of the octree.
+ */
+static void
+locate_points (
+	h5t_octree_t* const octree,
+	const h5_oct_idx_t oct_idx,
+	const h5_float64_t* const bb,
+	const h5_oct_point_t* const points,
+	h5_int32_t* const perm,		// indices of points to locate
+	h5_int32_t* const tmp,		// scratch space of same size
+	const h5_int32_t nbr_points,
+	h5_oct_idx_t* const leaf_octs
+	) {
+	h5_oct_idx_t child_idx = octree->octants[oct_idx].child_idx;
+	if (child_idx == -1) {
+		for (h5_int32_t i = 0; i < nbr_points; i++) {
+			leaf_octs[perm[i]] = oct_idx;
+		}
+		return;
+	}
+	const h5_float64_t mid[3] = {
+		(bb[0] + bb[3]) / 2,
+		(bb[1] + bb[4]) / 2,
+		(bb[2] + bb[5]) / 2 };
+	h5_int32_t count[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+	for (h5_int32_t i = 0; i < nbr_points; i++) {
+		const h5_oct_point_t* p = &points[perm[i]];
+		count[(p->x >= mid[0]) | (p->y >= mid[1]) << 1 | (p->z >= mid[2]) << 2]++;
+	}
+	h5_int32_t start[8];
+	h5_int32_t pos[8];
+	start[0] = pos[0] = 0;
+	for (int orient = 1; orient < 8; orient++) {
+		start[orient] = pos[orient] = start[orient-1] + count[orient-1];
+	}
+	for (h5_int32_t i = 0; i < nbr_points; i++) {
+		const h5_oct_point_t* p = &points[perm[i]];
+		tmp[pos[(p->x >= mid[0]) | (p->y >= mid[1]) << 1 | (p->z >= mid[2]) << 2]++] = perm[i];
+	}
+	memcpy (perm, tmp, nbr_points * sizeof (*perm));
+
+	for (int orient = 0; orient < 8; orient++) {
+		if (count[orient] == 0)
+			continue;
+		// same as get_new_bounding_box()
+		h5_float64_t new_bb[6];
+		new_bb[0] = (orient & 1) ? mid[0] : bb[0];
+		new_bb[3] = (orient & 1) ? bb[3] : mid[0];
+		new_bb[1] = (orient & 2) ? mid[1] : bb[1];
+		new_bb[4] = (orient & 2) ? bb[4] : mid[1];
+		new_bb[2] = (orient & 4) ? mid[2] : bb[2];
+		new_bb[5] = (orient & 4) ? bb[5] : mid[2];
+		locate_points (
+			octree, child_idx + orient, new_bb, points,
+			perm + start[orient], tmp + start[orient], count[orient],
+			leaf_octs);
+	}
+}
+
+/*
+ * Find leaf octants of many points. Points are processed in chunks
+ * of LOCATE_CHUNK_SIZE, chunks are independent and located in parallel
+ * if compiled with OpenMP.
+ */
+#define LOCATE_CHUNK_SIZE (1 << 12)
+
+static h5_err_t
+find_leafoctants_of_points (
+	h5t_octree_t* const octree,
+	const h5_int32_t nbr_points,
+	const h5_oct_point_t* const points,
+	h5_oct_idx_t* const leaf_octs
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "octree=%p, nbr_points=%d, points=%p, leaf_octs=%p",
+			    octree, nbr_points, points, leaf_octs);
+	const h5_float64_t* bb = octree->bounding_box;
+	for (h5_int32_t i = 0; i < nbr_points; i++) {
+		const h5_oct_point_t* p = &points[i];
+		if (!(bb[0] <= p->x && bb[3] > p->x &&
+		      bb[1] <= p->y && bb[4] > p->y &&
+		      bb[2] <= p->z && bb[5] > p->z)) {
+			H5_LEAVE (
+				h5_error (
+					H5_ERR_INVAL,
+					"Point (%g, %g, %g) is not contained in octree.",
+					p->x, p->y, p->z));
+		}
+	}
+	h5_int32_t* perm;
+	h5_int32_t* tmp;
+	TRY (perm = h5_calloc (nbr_points + 1, sizeof (*perm)));
+	TRY (tmp = h5_calloc (nbr_points + 1, sizeof (*tmp)));
+	for (h5_int32_t i = 0; i < nbr_points; i++) {
+		perm[i] = i;
+	}
+	h5_int32_t nbr_chunks = (nbr_points + LOCATE_CHUNK_SIZE - 1) / LOCATE_CHUNK_SIZE;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for (h5_int32_t chunk = 0; chunk < nbr_chunks; chunk++) {
+		h5_int32_t first = chunk * LOCATE_CHUNK_SIZE;
+		h5_int32_t num = nbr_points - first;
+		if (num > LOCATE_CHUNK_SIZE)
+			num = LOCATE_CHUNK_SIZE;
+		locate_points (
+			octree, 0, bb, points,
+			perm + first, tmp + first, num, leaf_octs);
+	}
+	TRY (h5_free (tmp));
+	TRY (h5_free (perm));
+	H5_RETURN (H5_SUCCESS);
+}
+h5_err_t
+H5t_find_leafoctants_of_points (h5t_octree_t* const octree, const h5_int32_t nbr_points, const h5_oct_point_t* const points, h5_oct_idx_t* const leaf_octs) {
+	return find_leafoctants_of_points (octree, nbr_points, points, leaf_octs);
 }
 
 
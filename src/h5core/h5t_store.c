@@ -17,6 +17,7 @@
 #include "private/h5t_store.h"
 #include "private/h5t_core.h"
 #include "private/h5t_io.h"
+#include "private/h5t_profile.h"
 #include "private/h5_file.h"
 #include "private/h5_mpi.h"
 
@@ -515,6 +516,48 @@ h5t_store_vertex (
 	H5_RETURN (local_idx);
 }
 
+/*!
+   Store \c num vertices at once. Like calling h5t_store_vertex()
+   \c num times, without the per call overhead.
+
+   \param[in]	m	mesh
+   \param[in]	num	number of vertices to store
+   \param[in]	glb_ids	global vertex ids from mesher or \c NULL
+   \param[in]	coords	coordinates, 3 values per vertex
+
+   \return local index of first stored vertex
+ */
+h5_loc_idx_t
+h5t_store_vertices (
+        h5t_mesh_t* const m,
+        const h5_size_t num,
+        const h5_glb_idx_t* const glb_ids,
+        const h5_float64_t* const coords
+        ) {
+	H5_CORE_API_ENTER (h5_loc_idx_t,
+	                   "m=%p, num=%llu, glb_ids=%p, coords=%p",
+	                   m,
+	                   (long long unsigned)num,
+	                   glb_ids,
+	                   coords);
+
+	// more than allocated? compare unsigned, num may not fit h5_loc_idx_t
+	h5_loc_idx_t avail =
+		m->num_loc_vertices[m->leaf_level] - m->last_stored_vid - 1;
+	if (avail < 0 || num > (h5_size_t)avail)
+		H5_LEAVE (HANDLE_H5_OVERFLOW_ERR(
+		                           m->num_loc_vertices[m->leaf_level]));
+
+	h5_loc_idx_t first = m->last_stored_vid + 1;
+	h5_loc_vertex_t* vertex = &m->vertices[first];
+	for (h5_size_t i = 0; i < num; i++, vertex++) {
+		vertex->idx = glb_ids ? glb_ids[i] : -1;  /* replaced later! */
+		memcpy (&vertex->P, &coords[3*i], sizeof (vertex->P));
+	}
+	m->last_stored_vid += (h5_loc_idx_t)num;
+	H5_RETURN (first);
+}
+
 h5_err_t
 h5t_end_store_vertices (
         h5t_mesh_t* const m
@@ -660,6 +703,85 @@ h5t_add_lvl0_cell (
 	TRY (h5tpriv_sort_local_vertex_indices (m, loc_vertex_indices, num_vertices));
 	H5_RETURN (m->last_stored_eid);
 }
+
+/*!
+   Store \c num elements on level 0 at once. Like calling
+   h5t_add_lvl0_cell() \c num times, without the per call overhead.
+
+   \param[in]	m		mesh
+   \param[in]	num		number of elements to store
+   \param[in]	vertex_indices	local vertex indices, number of vertices
+				of reference element per element
+   \param[in]	weights		weights, \c m->num_weights per element,
+				or \c NULL
+
+   \return local index of first stored element
+ */
+h5_loc_idx_t
+h5t_add_lvl0_cells (
+        h5t_mesh_t* const m,
+        const h5_size_t num,
+        const h5_loc_idx_t* vertex_indices,
+        const h5_weight_t* weights
+        ) {
+	H5_CORE_API_ENTER (h5_loc_idx_t,
+	                   "m=%p, num=%llu, vertex_indices=%p, weights=%p",
+	                   m,
+	                   (long long unsigned)num,
+	                   vertex_indices,
+	                   weights);
+	if (m->leaf_level != 0) {
+		H5_LEAVE (
+		        h5_error (
+		                H5_ERR_INVAL,
+		                "Elements can be added to level 0 only!"));
+	}
+	/*  more than allocated? compare unsigned, num may not fit h5_loc_idx_t */
+	h5_loc_idx_t avail = m->num_interior_elems[0] - m->last_stored_eid - 1;
+	if (avail < 0 || num > (h5_size_t)avail)
+		H5_LEAVE (
+		        HANDLE_H5_OVERFLOW_ERR (m->num_interior_elems[0]));
+
+	int num_vertices = h5tpriv_ref_elem_get_num_vertices (m);
+	h5_loc_idx_t num_loc_vertices = m->num_loc_vertices[0];
+	for (h5_size_t i = 0; i < num * num_vertices; i++) {
+		if (vertex_indices[i] < 0 || vertex_indices[i] >= num_loc_vertices) {
+			H5_LEAVE (
+			        h5_error (
+			                H5_ERR_INVAL,
+			                "Invalid local vertex index %lld "
+			                "of element %llu.",
+			                (long long)vertex_indices[i],
+			                (long long unsigned)(i / num_vertices)));
+		}
+	}
+
+	h5_loc_idx_t first = m->last_stored_eid + 1;
+	h5_loc_idx_t end = first + (h5_loc_idx_t)num;
+	for (h5_loc_idx_t elem_idx = first; elem_idx < end; elem_idx++) {
+		h5tpriv_set_loc_elem_parent_idx (m, elem_idx, -1);
+		h5tpriv_set_loc_elem_child_idx (m, elem_idx, -1);
+		h5tpriv_set_loc_elem_level_idx (m, elem_idx, 0);
+
+		h5_loc_idx_t* loc_vertex_indices =
+			h5tpriv_get_loc_elem_vertex_indices (m, elem_idx);
+		memcpy (loc_vertex_indices, vertex_indices,
+		        sizeof (*vertex_indices)*num_vertices);
+		TRY (h5tpriv_sort_local_vertex_indices (
+		             m, loc_vertex_indices, num_vertices));
+		vertex_indices += num_vertices;
+	}
+	if (weights != NULL && m->num_weights > 0) {
+		h5_weight_t* w = &m->weights[first * m->num_weights];
+		h5_size_t n = num * m->num_weights;
+		for (h5_size_t i = 0; i < n; i++) {
+			w[i] = weights[i] < 1 ? 1 : weights[i];
+		}
+	}
+	m->last_stored_eid = end - 1;
+	H5_RETURN (first);
+}
+
 /*
    Rebuild mapping of global element indices to their local indices.
  */
@@ -683,7 +805,7 @@ rebuild_map_elem_g2l (
 		item->loc_idx = loc_idx;
 		map->num_items++;
 	}
-	h5priv_sort_idxmap (map);
+	TRY (h5priv_sort_idxmap (map));
 	H5_RETURN (H5_SUCCESS);
 }
 
@@ -714,7 +836,7 @@ rebuild_map_elem_g2l_partial (
 		map->num_items++;
 	}
 	assert (map->size >= map->num_items);
-	h5priv_sort_idxmap (map);
+	TRY (h5priv_sort_idxmap (map));
 	H5_RETURN (H5_SUCCESS);
 }
 #endif
@@ -1083,8 +1205,7 @@ h5t_end_store_ckd_elems (
 		}
 		TRY (h5_free (vertices));
 		TRY (assign_global_vertex_indices (m));
-		TRY (h5_free (m->map_vertex_g2l.items));
-		m->map_vertex_g2l.items = NULL;
+		TRY (h5priv_free_idxmap (&m->map_vertex_g2l));
 		size_t size = m->num_loc_vertices[m->leaf_level]  + 128;
 		TRY (h5priv_new_idxmap (&m->map_vertex_g2l, size));
 		TRY (h5tpriv_rebuild_map_vertex_g2l (m, m->leaf_level, m->leaf_level));
@@ -1122,21 +1243,20 @@ h5t_end_store_ckd_elems (
 }
 
 #ifdef WITH_PARALLEL_H5GRID
-h5_err_t
-h5tpriv_find_oct_proc_of_point (
-		h5t_mesh_t* m,
-		h5_loc_idx_t loc_idx,
-		h5_oct_point_t* point,
-		h5_int32_t* proc
+/*
+   Set coordinates of point to centroid of element.
+ */
+static inline void
+get_centroid (
+		h5t_mesh_t* const m,
+		const h5_loc_idx_t loc_idx,
+		h5_oct_point_t* const point
 		) {
-	H5_PRIV_API_ENTER (h5_err_t, "m=%p, loc_idx=%lld, point=%p, proc=%d", m,  (long long int)loc_idx, point,*proc);
 	h5_loc_idx_t* indices = h5tpriv_get_loc_elem_vertex_indices (m, loc_idx);
-	h5_float64_t midpoint[3] = {0, 0, 0};
-	h5_float64_t P[3];
 	int num_vertices = h5tpriv_ref_elem_get_num_vertices (m);
-
+	h5_float64_t midpoint[3] = {0, 0, 0};
 	for (int j = 0; j < num_vertices; j++) {
-		TRY (h5t_get_vertex_coords_by_index (m, indices[j], P));
+		h5_float64_t* P = m->vertices[indices[j]].P;
 		midpoint[0] += P[0];
 		midpoint[1] += P[1];
 		midpoint[2] += P[2];
@@ -1144,7 +1264,17 @@ h5tpriv_find_oct_proc_of_point (
 	point->x = midpoint[0] / ((double) num_vertices);
 	point->y = midpoint[1] / ((double) num_vertices);
 	point->z = midpoint[2] / ((double) num_vertices);
+}
 
+h5_err_t
+h5tpriv_find_oct_proc_of_point (
+		h5t_mesh_t* m,
+		h5_loc_idx_t loc_idx,
+		h5_oct_point_t* point,
+		h5_int32_t* proc
+		) {
+	H5_PRIV_API_ENTER (h5_err_t, "m=%p, loc_idx=%lld, point=%p, proc=%d", m,  (long long int)loc_idx, point,*proc);
+	get_centroid (m, loc_idx, point);
 	point->elem = -1;
 	// check in which octant the new elems would be
 	TRY (point->oct = H5t_find_leafoctant_of_point (m->octree, 0, H5t_get_bounding_box (m->octree), point));
@@ -1161,9 +1291,25 @@ compare_midpoint_oct (
 	) {
 	return ((h5_oct_point_t*) p_a)->oct - ((h5_oct_point_t*) p_b)->oct;
 }
+
+static int
+compare_loc_id (
+	const void *p_a,
+	const void *p_b
+	) {
+	h5_loc_id_t a = *(h5_loc_id_t*) p_a;
+	h5_loc_id_t b = *(h5_loc_id_t*) p_b;
+	return (a > b) - (a < b);
+}
+
 /*
  * Update the marked_entities list such that it contains all elements that are
  * going to be refined with the current proc
+ *
+ * The work is done in passes over all candidates: select local elements
+ * which have not been refined yet, compute their centroids, locate the
+ * octants of the centroids and keep the elements in octants of this
+ * proc. The midpoint list must have space for all items in glb_list.
  */
 h5_err_t
 h5tpriv_mark_chk_elems_to_refine (
@@ -1174,38 +1320,52 @@ h5tpriv_mark_chk_elems_to_refine (
 	H5_PRIV_API_ENTER (h5_err_t, "m=%p, glb_list=%p", m, glb_list);
 	// clear marked_entities list
 	TRY (h5priv_free_loc_idlist (&m->marked_entities));
-	TRY (h5priv_alloc_loc_idlist (&m->marked_entities, MAX_NUM_ELEMS_TO_REFINE_LOCALLY));
 
-	h5_glb_idx_t glb_idx = -1;
-	h5_loc_idx_t loc_idx = -1;
-	h5_oct_point_t point;
-	int counter = 0;
-	// go through all elems
+	// select elements which are locally available and not refined already,
+	// glb_list is sorted thus duplicates are adjacent
+	h5_loc_idx_t* candidates;
+	TRY (candidates = h5_calloc (glb_list->num_items + 1, sizeof (*candidates)));
+	size_t num_candidates = 0;
 	for (int i = 0; i < glb_list->num_items; i++) {
-		glb_idx = glb_list->items[i];
-
-		// check if element is locally available (if not some other proc needs to refine it)
-		loc_idx = h5t_map_glb_elem_idx2loc(m, glb_idx);
-		if (loc_idx >= 0) {
-			// check in which octant the element is
-			h5_int32_t proc = -1;
-			TRY (h5tpriv_find_oct_proc_of_point (m, loc_idx, &point, &proc));  //TODO maybe use hash table here!!!
-
-			if (proc == m->f->myproc &&										// needs to be in my octant
-					h5priv_find_in_loc_idlist(m->marked_entities, loc_idx) < 0 && // not already in list
-					h5tpriv_get_loc_elem_child_idx (m, loc_idx) == -1) {  	// not refined already
-				// element is in octant of this proc, add to marked list
-				TRY (h5priv_search_in_loc_idlist (&m->marked_entities, loc_idx));
-
-				midpoint_list[counter].x = point.x;
-				midpoint_list[counter].y = point.y;
-				midpoint_list[counter].z = point.z;
-				midpoint_list[counter].oct = point.oct;
-				midpoint_list[counter].elem = h5tpriv_get_loc_elem_glb_idx(m, loc_idx);
-				counter++;
-			}
-		}
+		if (i > 0 && glb_list->items[i] == glb_list->items[i-1])
+			continue;
+		// if not local some other proc needs to refine it
+		h5_loc_idx_t loc_idx = h5t_map_glb_elem_idx2loc (m, glb_list->items[i]);
+		if (loc_idx < 0 || h5tpriv_get_loc_elem_child_idx (m, loc_idx) != -1)
+			continue;
+		candidates[num_candidates++] = loc_idx;
+	}
+
+	// centroids of candidates
+	for (size_t i = 0; i < num_candidates; i++) {
+		get_centroid (m, candidates[i], &midpoint_list[i]);
+		midpoint_list[i].elem = h5tpriv_get_loc_elem_glb_idx (m, candidates[i]);
+	}
+
+	// octants of centroids
+	h5_oct_idx_t* octs;
+	TRY (octs = h5_calloc (num_candidates + 1, sizeof (*octs)));
+	TRY (H5t_find_leafoctants_of_points (
+		     m->octree, (h5_int32_t)num_candidates, midpoint_list, octs));
+	for (size_t i = 0; i < num_candidates; i++) {
+		midpoint_list[i].oct = octs[i];
+	}
+	TRY (h5_free (octs));
+
+	// keep elements in octants of this proc
+	TRY (h5priv_alloc_loc_idlist (&m->marked_entities, num_candidates + 1));
+	h5_loc_idlist_t* marked = m->marked_entities;
+	int counter = 0;
+	for (size_t i = 0; i < num_candidates; i++) {
+		if (H5t_get_proc (m->octree, midpoint_list[i].oct) != m->f->myproc)
+			continue;
+		midpoint_list[counter++] = midpoint_list[i];
+		marked->items[marked->num_items++] = candidates[i];
 	}
+	TRY (h5_free (candidates));
+
+	// marked_entities must be sorted
+	qsort (marked->items, marked->num_items, sizeof (*marked->items), compare_loc_id);
 	// sort midpoint list such that they are aligned according to octants
 	qsort (midpoint_list, counter, sizeof (*midpoint_list), compare_midpoint_oct);
 	H5_RETURN (H5_SUCCESS);
@@ -1985,7 +2145,7 @@ init_glb_vtx_struct_chk (
 		}
 	}
 	TRY (h5priv_hdestroy (&htab));
-	TRY (h5_free (map->items));
+	TRY (h5priv_free_idxmap (map));
 	TRY (h5tpriv_sort_vertex_list (vtx_list, *num_vtx));
 	H5_RETURN (H5_SUCCESS);
 }
@@ -2273,6 +2433,7 @@ h5t_post_refine_chk (
         ) {
 	H5_CORE_API_ENTER (h5_err_t, "m=%p", m);
 	h5_debug("post_refine_chk");
+	TRY (h5tpriv_profile_begin (m, "exchange_boundary_edges"));
 	// get boundary edges
 	h5_edge_list_t* b_edges = h5tpriv_init_edge_list (
 		h5tpriv_ref_elem_get_num_edges(m) * m->marked_entities->num_items);
@@ -2328,8 +2489,8 @@ h5t_post_refine_chk (
 	// this is replacing TRY (h5t_end_store_vertices (m));
 	// since we need a special assign glb_idx
 
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
+	TRY (h5tpriv_profile_end (m, "exchange_boundary_edges"));
+	TRY (h5tpriv_profile_begin (m, "assign_elem_indices"));
 
 	// get elem ranges
 	h5_glb_idx_t* elem_range = NULL;
@@ -2366,8 +2527,8 @@ h5t_post_refine_chk (
 		// exchange weights
 		TRY (exchange_weights (m, elem_range));
 	}
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
+	TRY (h5tpriv_profile_end (m, "assign_elem_indices"));
+	TRY (h5tpriv_profile_begin (m, "init_glb_elems"));
 	// get list of new chunks
 	h5_chk_idx_t* chk_send_list = NULL;
 	int counter = 0;
@@ -2390,8 +2551,8 @@ h5t_post_refine_chk (
 	TRY (glb_elems = h5tpriv_alloc_glb_elems(m, num_glb_elems));
 	TRY (h5tpriv_init_glb_elems_struct_chk(m, glb_elems, chk_send_list, counter));
 
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
+	TRY (h5tpriv_profile_end (m, "init_glb_elems"));
+	TRY (h5tpriv_profile_begin (m, "init_glb_vertices"));
 	// create list of glb_vtx
 	h5_glb_vertex_t* glb_vtx = NULL;
 	h5_int32_t num_glb_vtx = 0;
@@ -2404,8 +2565,8 @@ h5t_post_refine_chk (
 	TRY (h5tpriv_get_list_of_chunks_to_read(m, &chk_list_read, &num_chk_list_read));
 	TRY (get_list_of_chunks_to_retrieve (m, chk_list_read, &num_chk_list_read));
 
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
+	TRY (h5tpriv_profile_end (m, "init_glb_vertices"));
+	TRY (h5tpriv_profile_begin (m, "exchange_glb_structs"));
 	// exchange cells and vertices
 	h5_glb_elem_t* tot_glb_elems = NULL;
 	h5_glb_vertex_t* tot_glb_vtx = NULL;
@@ -2416,15 +2577,14 @@ h5t_post_refine_chk (
 			glb_vtx, num_glb_vtx,
 			&tot_glb_vtx, &num_tot_glb_vtx));
 	TRY (h5_free (glb_elems)); // doesn't that create mem leak?
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
+	TRY (h5tpriv_profile_end (m, "exchange_glb_structs"));
+	TRY (h5tpriv_profile_begin (m, "store_exchanged_elems"));
 
 	h5_debug("store exchanged elems");
 	// store elems & vertices
 	TRY (store_exchanged_elems (m, chk_list_read, num_chk_list_read, tot_glb_elems, num_tot_glb_elems, tot_glb_vtx, num_tot_glb_vtx));
 
-	TRY (h5priv_mpi_barrier (m->f->props->comm));
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
+	TRY (h5tpriv_profile_end (m, "store_exchanged_elems"));
 
 	// set variables elems
 	m->num_glb_elems[m->leaf_level] = m->num_glb_elems[m->leaf_level - 1] + num_tot_glb_elems ;
@@ -2500,40 +2660,61 @@ h5t_begin_refine_elems (
 	H5_RETURN (H5_SUCCESS);
 }
 
-h5_err_t
-h5t_end_refine_elems (
+static h5_err_t
+end_refine_elems (
         h5t_mesh_t* const m
         ) {
-	H5_CORE_API_ENTER (h5_err_t, "m=%p", m);
+	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p", m);
 	if (m->is_chunked) {
 #ifdef WITH_PARALLEL_H5GRID		
-		TRY (h5priv_mpi_barrier (m->f->props->comm));
-                m->timing.measure[m->timing.next_time++] = MPI_Wtime();
 		h5_glb_idxlist_t* glb_list = NULL;
 		h5_oct_point_t* midpoints = NULL;
+		TRY (h5tpriv_profile_begin (m, "refine"));
+		TRY (h5tpriv_profile_begin (m, "pre_refine"));
 		TRY (h5t_pre_refine_chk (m, &glb_list, &midpoints));
-		TRY (h5priv_mpi_barrier (m->f->props->comm));
-                m->timing.measure[m->timing.next_time++] = MPI_Wtime();
+		TRY (h5tpriv_profile_end (m, "pre_refine"));
+		TRY (h5tpriv_profile_begin (m, "refine_marked_elems"));
 		TRY (h5t_refine_marked_elems_chk (m, glb_list, midpoints));
-		TRY (h5priv_mpi_barrier (m->f->props->comm));
-                m->timing.measure[m->timing.next_time++] = MPI_Wtime();
+		TRY (h5tpriv_profile_end (m, "refine_marked_elems"));
 		TRY (h5_free (midpoints));
 		midpoints = NULL;
+		TRY (h5tpriv_profile_begin (m, "post_refine"));
 		TRY (h5t_post_refine_chk (m, glb_list));
+		TRY (h5tpriv_profile_end (m, "post_refine"));
+		TRY (h5tpriv_profile_end (m, "refine"));
 		m->mesh_changed = 1;
-		TRY (h5priv_mpi_barrier (m->f->props->comm));
-                m->timing.measure[m->timing.next_time++] = MPI_Wtime();
 #endif
 	} else {
+		TRY (h5tpriv_profile_begin (m, "refine"));
+		TRY (h5tpriv_profile_begin (m, "pre_refine"));
 		TRY (h5t_pre_refine (m));
+		TRY (h5tpriv_profile_end (m, "pre_refine"));
+		TRY (h5tpriv_profile_begin (m, "refine_marked_elems"));
 		TRY (h5t_refine_marked_elems (m));
+		TRY (h5tpriv_profile_end (m, "refine_marked_elems"));
+		TRY (h5tpriv_profile_begin (m, "post_refine"));
 		TRY (h5t_post_refine (m));
+		TRY (h5tpriv_profile_end (m, "post_refine"));
+		TRY (h5tpriv_profile_end (m, "refine"));
 		m->mesh_changed = 1;
 	}
 
 	H5_RETURN (H5_SUCCESS);
 }
 
+h5_err_t
+h5t_end_refine_elems (
+        h5t_mesh_t* const m
+        ) {
+	H5_CORE_API_ENTER (h5_err_t, "m=%p", m);
+	int depth = h5tpriv_profile_depth (m);
+	if (end_refine_elems (m) < 0) {
+		TRY (h5tpriv_profile_unwind (m, depth));
+		H5_LEAVE (H5_ERR);
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
 #if defined(WITH_PARALLEL_H5GRID)
 h5_err_t
 h5tpriv_init_chunks (
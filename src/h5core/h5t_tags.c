@@ -46,12 +46,12 @@ read_dataset (
 	TRY (mspace_id = (*set_mspace)(m, dset_id));
 	TRY (dspace_id = (*set_dspace)(m, dset_id));
 	TRY (h5priv_start_throttle (f));
-	TRY (hdf5_read_dataset (
+	TRY (h5priv_trace_read (
+	             f, __func__,
 	             dset_id,
 	             dsinfo->type_id,
 	             mspace_id,
 	             dspace_id,
-	             f->props->xfer_prop,
 	             data));
 	TRY (h5priv_end_throttle (f));
 	TRY (hdf5_close_dataspace (dspace_id));
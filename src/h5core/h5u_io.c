@@ -11,6 +11,8 @@
 #include "private/h5_hdf5.h"
 #include "private/h5_model.h"
 #include "private/h5_io.h"
+#include "private/h5_mmap.h"
+#include "private/h5_prefetch.h"
 #include "private/h5u_types.h"
 
 #include "h5core/h5_model.h"
@@ -75,38 +77,26 @@ h5upriv_close_file (
 	H5_RETURN (H5_SUCCESS);
 }
 
-h5_err_t
-h5u_read_dataset (
-	const h5_file_t fh,	/*!< [in] Handle to open file */
-	char* const name,	/*!< [in] Name to associate dataset with */
-	void* data,		/*!< [out] Array of data */
-	const h5_types_t type
+/*
+  Get memory and disk space for reading a dataset according to the
+  current view. Returns the number of elements to be read.
+ */
+static inline h5_ssize_t
+select_view_for_reading (
+	const h5_file_p f,
+	const char* const name,
+	const hid_t dataset_id,
+	hid_t* const memspace_id,
+	hid_t* const space_id
 	) {
-        h5_file_p f = (h5_file_p)fh;
-	H5_CORE_API_ENTER (h5_err_t,
-			   "f=%p, name='%s', data=%p, type=%lld",
-	                   f, name, data, (long long int)type);
-	check_iteration_is_readable (f);
-
-	TRY (h5priv_normalize_dataset_name (name));
-	hid_t hdf5_type;
-	TRY (hdf5_type = h5priv_map_enum_to_normalized_type (type));
-	if ( f->iteration_gid < 0 ) {
-		TRY (h5_set_iteration ((h5_file_t)f, f->iteration_idx));
-	}
-
-	hid_t dataset_id;
-	TRY (dataset_id = hdf5_open_dataset_by_name (f->iteration_gid, name));
-
-	
+	H5_INLINE_FUNC_ENTER (h5_ssize_t);
 	/* default spaces, if not using a view selection */
-	hid_t memspace_id = H5S_ALL;
-	hid_t space_id;
-	TRY (space_id = hdf5_get_dataset_space (dataset_id));
+	*memspace_id = H5S_ALL;
+	TRY (*space_id = hdf5_get_dataset_space (dataset_id));
 
 	/* get the number of elements on disk for the datset */
 	hsize_t ndisk;
-	TRY (ndisk = hdf5_get_npoints_of_dataspace (space_id));
+	TRY (ndisk = hdf5_get_npoints_of_dataspace (*space_id));
 	hsize_t nread;
 	if (f->u->diskshape != H5S_ALL) {
 		TRY (nread = hdf5_get_selected_npoints_of_dataspace (f->u->diskshape));
@@ -115,9 +105,9 @@ h5u_read_dataset (
 		 * exceed the size of the dataset */
 		if (nread <= ndisk) {
 			/* we no longer need the dataset space... */
-			TRY (hdf5_close_dataspace(space_id));
+			TRY (hdf5_close_dataspace(*space_id));
 			/* ...because it's safe to use the view selection */
-			space_id = f->u->diskshape;
+			*space_id = f->u->diskshape;
 		} else {
 			/* the view selection is too big?
 			 * fall back to using the dataset space */
@@ -141,7 +131,7 @@ h5u_read_dataset (
 		/* make sure the memory space selected by the view has
 		 * enough capacity for the read */
 		if (nmem >= nread) {
-			memspace_id = f->u->memshape;
+			*memspace_id = f->u->memshape;
 		} else {
 			/* the view selection is too small?
 			 * fall back to using H5S_ALL */
@@ -150,18 +140,55 @@ h5u_read_dataset (
 			        "elements selected (%lld) than are available "
 			        "in memory (%lld).",
 			        name, (long long)nread, (long long)nmem );
-			memspace_id = H5S_ALL;
+			*memspace_id = H5S_ALL;
 		}
 	}
-	TRY (h5priv_start_throttle (f));
-	TRY (hdf5_read_dataset (
-	             dataset_id,
-	             hdf5_type,
-	             memspace_id,
-	             space_id,
-	             f->props->xfer_prop,
-	             data ));
-	TRY (h5priv_end_throttle (f));
+
+	H5_RETURN ((h5_ssize_t)nread);
+}
+
+h5_err_t
+h5u_read_dataset (
+	const h5_file_t fh,	/*!< [in] Handle to open file */
+	char* const name,	/*!< [in] Name to associate dataset with */
+	void* data,		/*!< [out] Array of data */
+	const h5_types_t type
+	) {
+        h5_file_p f = (h5_file_p)fh;
+	H5_CORE_API_ENTER (h5_err_t,
+			   "f=%p, name='%s', data=%p, type=%lld",
+	                   f, name, data, (long long int)type);
+	check_iteration_is_readable (f);
+
+	TRY (h5priv_normalize_dataset_name (name));
+	hid_t hdf5_type;
+	TRY (hdf5_type = h5priv_map_enum_to_normalized_type (type));
+	if ( f->iteration_gid < 0 ) {
+		TRY (h5_set_iteration ((h5_file_t)f, f->iteration_idx));
+	}
+
+	hid_t dataset_id;
+	TRY (dataset_id = hdf5_open_dataset_by_name (f->iteration_gid, name));
+
+	
+	hid_t memspace_id;
+	hid_t space_id;
+	TRY (select_view_for_reading (
+		     f, name, dataset_id, &memspace_id, &space_id));
+	h5_err_t prefetched;
+	TRY (prefetched = h5priv_read_prefetched (
+		     f, dataset_id, hdf5_type, memspace_id, space_id, data));
+	if (!prefetched) {
+		TRY (h5priv_start_throttle (f));
+		TRY (h5priv_trace_read (
+			     f, __func__,
+			     dataset_id,
+			     hdf5_type,
+			     memspace_id,
+			     space_id,
+			     data ));
+		TRY (h5priv_end_throttle (f));
+	}
 	if (space_id != f->u->diskshape) {
 		TRY (hdf5_close_dataspace (space_id));
 	}
@@ -171,6 +198,92 @@ h5u_read_dataset (
 	H5_RETURN (H5_SUCCESS);
 }
 
+/*!
+  Map dataset into memory.
+
+  For read-only files, a contiguous dataset whose type needs no
+  conversion is not read, instead a pointer into a read-only mapping of
+  the file is returned. All other datasets are read into a buffer
+  allocated by the library. In both cases the pointer must be released
+  with h5u_unmap_dataset().
+
+  \return number of elements or error code
+*/
+h5_ssize_t
+h5u_map_dataset (
+	const h5_file_t fh,	/*!< [in] Handle to open file */
+	char* const name,	/*!< [in] Name of dataset */
+	const h5_types_t type,	/*!< [in] Type of data */
+	const void** data	/*!< [out] Pointer to data */
+	) {
+        h5_file_p f = (h5_file_p)fh;
+	H5_CORE_API_ENTER (h5_ssize_t,
+			   "f=%p, name='%s', type=%lld, data=%p",
+	                   f, name, (long long int)type, data);
+	check_iteration_is_readable (f);
+
+	TRY (h5priv_normalize_dataset_name (name));
+	hid_t hdf5_type;
+	TRY (hdf5_type = h5priv_map_enum_to_normalized_type (type));
+	if ( f->iteration_gid < 0 ) {
+		TRY (h5_set_iteration ((h5_file_t)f, f->iteration_idx));
+	}
+
+	hid_t dataset_id;
+	TRY (dataset_id = hdf5_open_dataset_by_name (f->iteration_gid, name));
+	hid_t memspace_id;
+	hid_t space_id;
+	h5_ssize_t nread;
+	TRY (nread = select_view_for_reading (
+		     f, name, dataset_id, &memspace_id, &space_id));
+	h5_err_t mapped;
+	TRY (mapped = h5priv_map_dataset (
+		     f, dataset_id, hdf5_type, space_id, data));
+	if (!mapped && nread > 0) {
+		h5_debug ("Dataset '%s' cannot be mapped, reading it.", name);
+		h5_ssize_t type_size;
+		TRY (type_size = hdf5_get_sizeof_type (hdf5_type));
+		void* buf;
+		TRY (buf = h5_alloc (NULL, nread * type_size));
+		hsize_t dims[1] = { (hsize_t)nread };
+		TRY (memspace_id = hdf5_create_dataspace (1, dims, NULL));
+		TRY (h5priv_start_throttle (f));
+		TRY (h5priv_trace_read (
+			     f, __func__,
+			     dataset_id,
+			     hdf5_type,
+			     memspace_id,
+			     space_id,
+			     buf));
+		TRY (h5priv_end_throttle (f));
+		TRY (hdf5_close_dataspace (memspace_id));
+		TRY (h5priv_add_mapped_copy (f, buf));
+		*data = buf;
+	}
+	if (space_id != f->u->diskshape) {
+		TRY (hdf5_close_dataspace (space_id));
+	}
+	TRY (hdf5_close_dataset (dataset_id));
+
+	H5_RETURN (nread);
+}
+
+/*!
+  Release pointer returned by h5u_map_dataset().
+
+  \return	H5_SUCCESS or error code
+*/
+h5_err_t
+h5u_unmap_dataset (
+	const h5_file_t fh,	/*!< [in] Handle to open file */
+	const void* const data	/*!< [in] Pointer returned by h5u_map_dataset() */
+	) {
+        h5_file_p f = (h5_file_p)fh;
+	H5_CORE_API_ENTER (h5_err_t, "f=%p, data=%p", f, data);
+	CHECK_FILEHANDLE (f);
+	H5_RETURN (h5priv_unmap_dataset (f, data));
+}
+
 h5_err_t
 h5u_write (
 	const h5_file_t fh,	/*!< IN: Handle to open file */
@@ -185,12 +298,12 @@ h5u_write (
 	TRY (h5priv_start_throttle (f));
 	hid_t hdf5_type;
 	TRY (hdf5_type = h5priv_map_enum_to_normalized_type (type));
-	TRY (hdf5_write_dataset (
+	TRY (h5priv_trace_write (
+	             f, __func__,
 	             dset_id,
 	             hdf5_type,
 	             f->u->memshape,
 	             f->u->diskshape,
-	             f->props->xfer_prop,
 	             data));
 	TRY (h5priv_end_throttle (f));
 	f->empty = 0;
@@ -254,5 +367,6 @@ h5u_write_dataset (
 	hid_t dset_id;
 	TRY (dset_id = h5u_open_dataset (fh, name, type));
 	TRY (h5u_write (fh, dset_id, type, data));
+	TRY (hdf5_close_dataset (dset_id));
 	H5_RETURN (H5_SUCCESS);
 }
@@ -0,0 +1,148 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+#include <string.h>
+
+#include "h5core/h5_syscall.h"
+
+#include "private/h5_log.h"
+#include "private/h5_arena.h"
+
+#define ARENA_BLOCK_SIZE	(1 << 20)
+#define ARENA_ALIGN		16
+
+struct h5_arena_block {
+	struct h5_arena_block* prev;
+	size_t		size;		// usable bytes in data
+	size_t		used;		// allocated bytes in data
+	char*		data;		// aligned memory following header
+};
+
+static inline size_t
+align (
+	const size_t size
+	) {
+	return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+/*
+  Allocate zeroed memory from arena. Objects larger than a quarter of
+  the block size get a block of their own.
+ */
+void_p
+h5priv_arena_alloc (
+	h5_arena_t* const a,
+	const size_t size
+	) {
+	H5_PRIV_API_ENTER (void_p, "a=%p, size=%zu", a, size);
+	size_t asize = align (size);
+	struct h5_arena_block* b = a->block;
+	if (b == NULL || b->used + asize > b->size) {
+		size_t bsize = asize > ARENA_BLOCK_SIZE / 4 ?
+			asize : ARENA_BLOCK_SIZE;
+		TRY (b = h5_calloc (1, align (sizeof (*b)) + bsize));
+		b->data = (char*)b + align (sizeof (*b));
+		b->size = bsize;
+		if (asize > ARENA_BLOCK_SIZE / 4 && a->block != NULL) {
+			// keep bumping in the current block
+			b->prev = a->block->prev;
+			a->block->prev = b;
+		} else {
+			b->prev = a->block;
+			a->block = b;
+		}
+		a->reserved += (h5_int64_t)bsize;
+		a->num_blocks++;
+	}
+	void* ptr = b->data + b->used;
+	b->used += asize;
+	if (b == a->block)
+		a->last = ptr;
+	a->allocs++;
+	a->bytes += (h5_int64_t)size;
+	H5_RETURN (ptr);
+}
+
+/*
+  Grow object allocated from arena. The last object in the current
+  block is resized in place, otherwise a new object is allocated and the
+  old one is left in the arena. Objects are never shrunk.
+ */
+void_p
+h5priv_arena_realloc (
+	h5_arena_t* const a,
+	void* const ptr,
+	const size_t old_size,
+	const size_t size
+	) {
+	H5_PRIV_API_ENTER (void_p, "a=%p, ptr=%p, old_size=%zu, size=%zu",
+			   a, ptr, old_size, size);
+	if (ptr == NULL) {
+		H5_LEAVE (h5priv_arena_alloc (a, size));
+	}
+	if (size <= old_size) {
+		H5_LEAVE (ptr);
+	}
+	struct h5_arena_block* b = a->block;
+	if (ptr == a->last) {
+		size_t offset = (size_t)((char*)ptr - b->data);
+		if (offset + align (size) <= b->size) {
+			b->used = offset + align (size);
+			a->bytes += (h5_int64_t)(size - old_size);
+			H5_LEAVE (ptr);
+		}
+	}
+	void* new_ptr;
+	TRY (new_ptr = h5priv_arena_alloc (a, size));
+	memcpy (new_ptr, ptr, old_size < size ? old_size : size);
+	H5_RETURN (new_ptr);
+}
+
+/*
+  Give back object. Only the last object in the current block can be
+  reused, others are released with the arena.
+ */
+void
+h5priv_arena_free (
+	h5_arena_t* const a,
+	void* const ptr
+	) {
+	if (ptr != NULL && ptr == a->last) {
+		struct h5_arena_block* b = a->block;
+		size_t offset = (size_t)((char*)ptr - b->data);
+		memset (ptr, 0, b->used - offset);
+		b->used = offset;
+		a->last = NULL;
+	}
+}
+
+/*
+  Release all memory of arena and log statistics.
+ */
+h5_err_t
+h5priv_release_arena (
+	h5_arena_t* const a,
+	const char* const name
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "a=%p, name=%s", a, name);
+	if (a->num_blocks > 0) {
+		h5_debug ("Arena %s: %lld allocations, %lld bytes requested, "
+			  "%lld bytes in %lld blocks",
+			  name, (long long)a->allocs, (long long)a->bytes,
+			  (long long)a->reserved, (long long)a->num_blocks);
+	}
+	struct h5_arena_block* b = a->block;
+	while (b != NULL) {
+		struct h5_arena_block* prev = b->prev;
+		TRY (h5_free (b));
+		b = prev;
+	}
+	memset (a, 0, sizeof (*a));
+	H5_RETURN (H5_SUCCESS);
+}
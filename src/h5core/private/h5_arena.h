@@ -0,0 +1,47 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+#ifndef __PRIVATE_H5_ARENA_H
+#define __PRIVATE_H5_ARENA_H
+
+#include "h5core/h5_types.h"
+
+struct h5_arena_block;
+
+/*
+  Bump allocator for many small objects with the same lifetime. Memory
+  is taken from large blocks and released all at once with
+  h5priv_release_arena(). Initialize with zeros.
+ */
+typedef struct h5_arena {
+	struct h5_arena_block* block;	// current block, links to previous
+	void*		last;		// last allocation in current block
+	h5_int64_t	allocs;		// number of allocations
+	h5_int64_t	bytes;		// bytes requested
+	h5_int64_t	reserved;	// bytes in blocks
+	h5_int64_t	num_blocks;	// number of blocks
+} h5_arena_t;
+
+void_p
+h5priv_arena_alloc (
+	h5_arena_t* const, const size_t);
+
+void_p
+h5priv_arena_realloc (
+	h5_arena_t* const, void* const, const size_t, const size_t);
+
+void
+h5priv_arena_free (
+	h5_arena_t* const, void* const);
+
+h5_err_t
+h5priv_release_arena (
+	h5_arena_t* const, const char* const);
+
+#endif
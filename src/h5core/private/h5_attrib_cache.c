@@ -0,0 +1,522 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+/*
+  In-memory cache of attribute information.
+
+  If enabled with the file property H5_ATTRIB_CACHE, name, type and
+  number of elements of all attributes of an object (file root,
+  iteration group or field group) are read the first time an attribute
+  of this object is queried. Values up to MAX_CACHED_VALUE_SIZE bytes
+  are read as well. Objects are looked up by their path in a string
+  keyed hash table, attributes by their name in a hash table per
+  object. Writing attributes to an object marks the cached entry of
+  this object as invalid, it will be re-read on the next query.
+
+  The entries of an attribute table (see private/h5_attribs.c) are
+  presented as ordinary attributes and their values are always cached.
+  Objects with an attribute table are therefore cached even without
+  the property. For other objects all functions fall back to the
+  uncached implementation in private/h5_attribs.h then.
+ */
+
+#include <string.h>
+
+#include "h5core/h5_syscall.h"
+
+#include "private/h5_attrib_cache.h"
+#include "private/h5_attribs.h"
+#include "private/h5_file.h"
+#include "private/h5_hsearch.h"
+
+#define MAX_CACHED_VALUE_SIZE	1024
+#define MIN_TABLE_SIZE		31
+
+struct cached_attrib {
+	char*		key;		// attribute name, must be first member
+	h5_int64_t	type;		// H5hut type enumeration
+	h5_size_t	nelem;		// number of elements
+	size_t		size;		// size of value in bytes
+	void*		value;		// cached value or NULL
+};
+
+struct cached_object {
+	char*		key;		// path of object, must be first member
+	int		valid;		// cleared if object has been modified
+	h5_size_t	num_attribs;
+	struct cached_attrib* attribs;	// ordered by attribute index
+	h5_hashtable_t	names;		// attribute name -> entry in attribs
+};
+
+struct h5_attrib_cache {
+	h5_hashtable_t	objects;	// object path -> struct cached_object
+};
+
+/*
+  Entries of the name tables are owned by the attribute array of the
+  object.
+ */
+static h5_err_t
+keep_entry (
+	const void* __entry
+	) {
+	UNUSED_ARGUMENT (__entry);
+	return H5_SUCCESS;
+}
+
+static h5_err_t
+release_object_content (
+	struct cached_object* const obj
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "obj=%p", obj);
+	obj->valid = 0;
+	if (obj->names.ctrl) {
+		TRY (h5priv_hdestroy (&obj->names));
+	}
+	memset (&obj->names, 0, sizeof (obj->names));
+	for (h5_size_t i = 0; i < obj->num_attribs; i++) {
+		TRY (h5_free (obj->attribs[i].key));
+		TRY (h5_free (obj->attribs[i].value));
+	}
+	TRY (h5_free (obj->attribs));
+	obj->attribs = NULL;
+	obj->num_attribs = 0;
+	H5_RETURN (H5_SUCCESS);
+}
+
+static h5_err_t
+release_object (
+	const void* __entry
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "__entry=%p", __entry);
+	struct cached_object* obj = *(struct cached_object**)__entry;
+	TRY (release_object_content (obj));
+	TRY (h5_free (obj->key));
+	TRY (h5_free (obj));
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Load attribute with given index. Return 0 if it is the attribute
+  table, which is not loaded, otherwise 1.
+ */
+static h5_err_t
+load_attrib (
+	const hid_t id,
+	const h5_size_t idx,
+	struct cached_attrib* const a
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t,
+			    "id=%lld, idx=%llu, a=%p",
+			    (long long int)id, (long long unsigned)idx, a);
+	hid_t attrib_id;
+	TRY (attrib_id = hdf5_open_attribute_by_idx (id, (unsigned int)idx));
+	h5_ssize_t len;
+	TRY (len = hdf5_get_attribute_name (attrib_id, 0, NULL));
+	TRY (a->key = h5_calloc (1, len + 1));
+	TRY (hdf5_get_attribute_name (attrib_id, len + 1, a->key));
+	if (strcmp (a->key, H5_ATTRIB_TABLE_NAME) == 0) {
+		TRY (h5_free (a->key));
+		a->key = NULL;
+		TRY (hdf5_close_attribute (attrib_id));
+		H5_LEAVE (0);
+	}
+
+	hid_t type_id;
+	TRY (type_id = hdf5_get_attribute_type (attrib_id));
+	TRY (a->type = h5priv_map_hdf5_type_to_enum (type_id));
+	hid_t space_id;
+	TRY (space_id = hdf5_get_attribute_dataspace (attrib_id));
+	h5_ssize_t npoints;
+	TRY (npoints = hdf5_get_npoints_of_dataspace (space_id));
+	TRY (hdf5_close_dataspace (space_id));
+	size_t type_size = H5Tget_size (type_id);
+	hid_t mem_type_id;
+	TRY (mem_type_id = h5priv_normalize_type (type_id));
+	if (mem_type_id == H5_STRING) {
+		a->nelem = type_size;
+		mem_type_id = type_id;
+	} else {
+		a->nelem = npoints;
+	}
+	a->size = (size_t)npoints * type_size;
+	if (a->size <= MAX_CACHED_VALUE_SIZE) {
+		TRY (a->value = h5_calloc (1, a->size + 1));
+		TRY (hdf5_read_attribute (attrib_id, mem_type_id, a->value));
+	}
+	TRY (hdf5_close_type (type_id));
+	TRY (hdf5_close_attribute (attrib_id));
+	H5_RETURN (1);
+}
+
+static h5_err_t
+load_table_entry (
+	const h5_attrib_t* const entry,
+	struct cached_attrib* const a
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "entry=%p, a=%p", entry, a);
+	TRY (a->key = h5_strdup (entry->name));
+	a->type = entry->type;
+	a->nelem = entry->nelem;
+	h5_ssize_t size;
+	TRY (size = h5priv_get_attrib_value_size (entry));
+	a->size = (size_t)size;
+	TRY (a->value = h5_calloc (1, a->size + 1));
+	memcpy (a->value, entry->value, a->size);
+	H5_RETURN (H5_SUCCESS);
+}
+
+static h5_err_t
+load_object (
+	const hid_t id,
+	struct cached_object* const obj
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t,
+			    "id=%lld, obj=%p",
+			    (long long int)id, obj);
+	TRY (release_object_content (obj));
+	h5_ssize_t num_attribs;
+	TRY (num_attribs = hdf5_get_num_attribute (id));
+	h5_attrib_t* table;
+	h5_ssize_t num_table;
+	TRY (num_table = h5priv_read_attrib_table (id, &table));
+	TRY (obj->attribs = h5_calloc (
+		     num_attribs + num_table + 1, sizeof (*obj->attribs)));
+	TRY (h5priv_hcreate_string_keyed (
+		     MIN_TABLE_SIZE + ((num_attribs + num_table) << 2) / 3,
+		     &obj->names,
+		     keep_entry));
+	for (h5_ssize_t i = 0; i < num_attribs; i++) {
+		struct cached_attrib* a = &obj->attribs[obj->num_attribs++];
+		h5_err_t loaded;
+		TRY (loaded = load_attrib (id, i, a));
+		if (!loaded) {
+			obj->num_attribs--;
+			continue;
+		}
+		TRY (h5priv_hsearch (a, H5_ENTER, NULL, &obj->names));
+	}
+	for (h5_ssize_t i = 0; i < num_table; i++) {
+		struct cached_attrib* a = &obj->attribs[obj->num_attribs++];
+		TRY (load_table_entry (&table[i], a));
+		TRY (h5priv_hsearch (a, H5_ENTER, NULL, &obj->names));
+	}
+	TRY (h5_free (table));
+	obj->valid = 1;
+	h5_debug ("Cached %lld attributes of '%s'.",
+		  (long long)obj->num_attribs, obj->key);
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline h5_err_t
+get_object_path (
+	const hid_t id,
+	char** const path
+	) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	h5_ssize_t len;
+	TRY (len = hdf5_get_object_path (id, NULL, 0));
+	TRY (*path = h5_calloc (1, len + 1));
+	TRY (hdf5_get_object_path (id, *path, len + 1));
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline h5_err_t
+find_object (
+	struct h5_attrib_cache* const c,
+	const char* const path,
+	struct cached_object** const obj
+	) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	struct cached_object item;
+	memset (&item, 0, sizeof (item));
+	item.key = (char*)path;
+	void* entry = NULL;
+	TRY (h5priv_hsearch (&item, H5_FIND, &entry, &c->objects));
+	*obj = entry;
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Return cached object for given HDF5 object or NULL if the cache is
+  disabled and the object has no attribute table.
+ */
+static h5_err_t
+get_object (
+	const h5_file_p f,
+	const hid_t id,
+	struct cached_object** const result
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t,
+			    "f=%p, id=%lld, result=%p",
+			    f, (long long int)id, result);
+	*result = NULL;
+	if (!(f->props->flags & H5_ATTRIB_CACHE)) {
+		h5_err_t has_table;
+		TRY (has_table = hdf5_attribute_exists (
+			     id, H5_ATTRIB_TABLE_NAME));
+		if (!has_table) {
+			H5_LEAVE (H5_SUCCESS);
+		}
+	}
+	struct h5_attrib_cache* c = f->attrib_cache;
+	if (c == NULL) {
+		TRY (c = h5_calloc (1, sizeof (*c)));
+		TRY (h5priv_hcreate_string_keyed (
+			     MIN_TABLE_SIZE, &c->objects, release_object));
+		f->attrib_cache = c;
+	}
+	char* path;
+	TRY (get_object_path (id, &path));
+	struct cached_object* obj;
+	TRY (find_object (c, path, &obj));
+	if (obj) {
+		TRY (h5_free (path));
+	} else {
+		TRY (obj = h5_calloc (1, sizeof (*obj)));
+		obj->key = path;
+		TRY (h5priv_hsearch (obj, H5_ENTER, NULL, &c->objects));
+	}
+	if (!obj->valid) {
+		TRY (load_object (id, obj));
+	}
+	*result = obj;
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline h5_err_t
+find_attrib (
+	struct cached_object* const obj,
+	const char* const name,
+	struct cached_attrib** const a
+	) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	struct cached_attrib item;
+	memset (&item, 0, sizeof (item));
+	item.key = (char*)name;
+	void* entry = NULL;
+	TRY (h5priv_hsearch (&item, H5_FIND, &entry, &obj->names));
+	*a = entry;
+	H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5priv_cached_attrib_exists (
+	const h5_file_p f,
+	const hid_t id,
+	const char* const attrib_name
+	) {
+	H5_PRIV_API_ENTER (h5_err_t,
+			   "f=%p, id=%lld, attrib_name='%s'",
+			   f, (long long int)id, attrib_name);
+	struct cached_object* obj;
+	TRY (get_object (f, id, &obj));
+	if (obj == NULL) {
+		H5_LEAVE (hdf5_attribute_exists (id, attrib_name));
+	}
+	struct cached_attrib* a;
+	TRY (find_attrib (obj, attrib_name, &a));
+	H5_RETURN (a != NULL);
+}
+
+h5_ssize_t
+h5priv_cached_get_num_attribs (
+	const h5_file_p f,
+	const hid_t id
+	) {
+	H5_PRIV_API_ENTER (h5_ssize_t,
+			   "f=%p, id=%lld",
+			   f, (long long int)id);
+	struct cached_object* obj;
+	TRY (get_object (f, id, &obj));
+	if (obj == NULL) {
+		H5_LEAVE (hdf5_get_num_attribute (id));
+	}
+	H5_RETURN ((h5_ssize_t)obj->num_attribs);
+}
+
+h5_err_t
+h5priv_cached_get_attrib_info_by_idx (
+	const h5_file_p f,
+	const hid_t id,			/*!< HDF5 object ID */
+	const h5_size_t attrib_idx,	/*!< index of attribute */
+	char* const attrib_name,	/*!< OUT: name of attribute */
+	const h5_size_t len_attrib_name,/*!< buffer length */
+	h5_int64_t* const attrib_type,	/*!< OUT: H5 type of attribute */
+	h5_size_t* const attrib_nelem	/*!< OUT: number of elements */
+	) {
+	H5_PRIV_API_ENTER (h5_err_t,
+			   "f=%p, id=%lld, "
+			   "attrib_idx=%llu, "
+			   "attrib_name=%p, len_attrib_name=%llu, "
+			   "attrib_type=%p, attrib_nelem=%p",
+			   f, (long long int)id,
+			   (long long unsigned)attrib_idx,
+			   attrib_name,
+			   (long long unsigned)len_attrib_name,
+			   attrib_type, attrib_nelem);
+	struct cached_object* obj;
+	TRY (get_object (f, id, &obj));
+	if (obj == NULL) {
+		H5_LEAVE (
+			h5priv_get_attrib_info_by_idx (
+				id,
+				attrib_idx,
+				attrib_name, len_attrib_name,
+				attrib_type, attrib_nelem));
+	}
+	if (attrib_idx >= obj->num_attribs) {
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"Cannot open attribute '%llu' of '%s'.",
+			(long long unsigned)attrib_idx,
+			obj->key);
+	}
+	struct cached_attrib* a = &obj->attribs[attrib_idx];
+	if (attrib_name && len_attrib_name > 0) {
+		strncpy (attrib_name, a->key, len_attrib_name - 1);
+		attrib_name[len_attrib_name - 1] = '\0';
+	}
+	if (attrib_type) {
+		*attrib_type = a->type;
+	}
+	if (attrib_nelem) {
+		*attrib_nelem = a->nelem;
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5priv_cached_get_attrib_info_by_name (
+	const h5_file_p f,
+	const hid_t id,			/*!< IN: HDF5 object ID */
+	const char* const attrib_name,	/*!< IN: name of attribute */
+	h5_int64_t* const attrib_type,	/*!< OUT: H5 type of attribute */
+	h5_size_t* const attrib_nelem	/*!< OUT: number of elements */
+	) {
+	H5_PRIV_API_ENTER (h5_err_t,
+			   "f=%p, id=%lld, "
+			   "attrib_name=%s,"
+			   "attrib_type=%p, attrib_nelem=%p",
+			   f, (long long int)id,
+			   attrib_name,
+			   attrib_type, attrib_nelem);
+	struct cached_object* obj;
+	TRY (get_object (f, id, &obj));
+	if (obj == NULL) {
+		H5_LEAVE (
+			h5priv_get_attrib_info_by_name (
+				id,
+				attrib_name,
+				attrib_type, attrib_nelem));
+	}
+	struct cached_attrib* a;
+	TRY (find_attrib (obj, attrib_name, &a));
+	if (a == NULL) {
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"Cannot open attribute '%s' of '%s'.",
+			attrib_name,
+			obj->key);
+	}
+	if (attrib_type) {
+		*attrib_type = a->type;
+	}
+	if (attrib_nelem) {
+		*attrib_nelem = a->nelem;
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5priv_cached_read_attrib (
+	const h5_file_p f,
+	const hid_t id,			/*!< HDF5 object ID */
+	const char* const attrib_name,	/*!< name of HDF5 attribute to read */
+	const h5_types_t attrib_type,	/*!< H5hut enum type of attribute */
+	void* const attrib_value	/*!< OUT: attribute value */
+	) {
+	H5_PRIV_API_ENTER (h5_err_t,
+			   "f=%p, id=%lld, attrib_name='%s', attrib_type=%lld, "
+			   "attrib_value=%p",
+			   f, (long long int)id,
+			   attrib_name,
+			   (long long int)attrib_type,
+			   attrib_value);
+	struct cached_object* obj;
+	TRY (get_object (f, id, &obj));
+	struct cached_attrib* a = NULL;
+	if (obj) {
+		TRY (find_attrib (obj, attrib_name, &a));
+	}
+	if (a == NULL || a->value == NULL) {
+		H5_LEAVE (
+			h5priv_read_attrib (
+				id,
+				attrib_name,
+				attrib_type,
+				attrib_value));
+	}
+	hid_t normalized_type;
+	TRY (normalized_type = h5priv_map_enum_to_normalized_type (attrib_type));
+	hid_t normalized_file_type;
+	TRY (normalized_file_type = h5priv_map_enum_to_normalized_type (
+		     (h5_types_t)a->type));
+	if (normalized_file_type != normalized_type)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"Attribute '%s' has type '%s' but "
+			"was requested as '%s'.",
+			attrib_name,
+			hdf5_get_type_name (normalized_file_type),
+			hdf5_get_type_name (normalized_type));
+	memcpy (attrib_value, a->value, a->size);
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Mark the cached information of an object as invalid. Must be called
+  after attributes of the object have been written.
+ */
+h5_err_t
+h5priv_invalidate_attrib_cache (
+	const h5_file_p f,
+	const hid_t id
+	) {
+	H5_PRIV_API_ENTER (h5_err_t,
+			   "f=%p, id=%lld",
+			   f, (long long int)id);
+	if (f->attrib_cache == NULL) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	char* path;
+	TRY (get_object_path (id, &path));
+	struct cached_object* obj;
+	TRY (find_object (f->attrib_cache, path, &obj));
+	if (obj) {
+		TRY (release_object_content (obj));
+	}
+	TRY (h5_free (path));
+	H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5priv_free_attrib_cache (
+	const h5_file_p f
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "f=%p", f);
+	struct h5_attrib_cache* c = f->attrib_cache;
+	if (c == NULL) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	TRY (h5priv_hdestroy (&c->objects));
+	TRY (h5_free (c));
+	f->attrib_cache = NULL;
+	H5_RETURN (H5_SUCCESS);
+}
@@ -0,0 +1,46 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+#ifndef __PRIVATE_H5_ATTRIB_CACHE_H
+#define __PRIVATE_H5_ATTRIB_CACHE_H
+
+#include "private/h5_types.h"
+
+h5_err_t
+h5priv_cached_attrib_exists (
+	const h5_file_p, const hid_t, const char* const);
+
+h5_ssize_t
+h5priv_cached_get_num_attribs (
+	const h5_file_p, const hid_t);
+
+h5_err_t
+h5priv_cached_get_attrib_info_by_idx (
+	const h5_file_p, const hid_t, const h5_size_t,
+	char* const, const h5_size_t, h5_int64_t* const, h5_size_t* const);
+
+h5_err_t
+h5priv_cached_get_attrib_info_by_name (
+	const h5_file_p, const hid_t, const char* const,
+	h5_int64_t* const, h5_size_t* const);
+
+h5_err_t
+h5priv_cached_read_attrib (
+	const h5_file_p, const hid_t, const char* const,
+	const h5_types_t, void* const);
+
+h5_err_t
+h5priv_invalidate_attrib_cache (
+	const h5_file_p, const hid_t);
+
+h5_err_t
+h5priv_free_attrib_cache (
+	const h5_file_p);
+
+#endif
@@ -0,0 +1,634 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+/*
+  Write and read sets of attributes.
+
+  An attribute table is stored in one compound attribute named
+  H5_ATTRIB_TABLE_NAME with one element per entry, holding name, type
+  and value of the entry. Since a compound type has a fixed set of
+  members, there is a variable length member for each type and only the
+  member matching the type of the entry is used. Thus writing a table
+  costs one create, write and close of an attribute, independent of the
+  number of entries, while HDF5 still converts values between byte
+  orders.
+
+  Names are unique among the entries of the table and the ordinary
+  attributes of an object: writing a table deletes ordinary attributes
+  with the same name, writing a single attribute removes the entry from
+  the table, see h5priv_remove_table_attrib(). For queries of single
+  attributes the attribute cache presents the entries of the table as
+  ordinary attributes, see private/h5_attrib_cache.c.
+
+  Reading iterates once over the attribute list of the object, decodes
+  the table and returns all attributes in a single allocation.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "h5core/h5_syscall.h"
+
+#include "private/h5_attribs.h"
+
+#define ALIGN8(n)	(((n) + 7) & ~(size_t)7)
+
+/*
+  Types of table values. The value of an entry is stored in the
+  variable length member with the index of its type.
+ */
+#define NUM_TABLE_TYPES	9
+
+static const h5_types_t table_types[NUM_TABLE_TYPES] = {
+	H5_STRING_T,
+	H5_INT16_T,
+	H5_UINT16_T,
+	H5_INT32_T,
+	H5_UINT32_T,
+	H5_INT64_T,
+	H5_UINT64_T,
+	H5_FLOAT32_T,
+	H5_FLOAT64_T
+};
+
+static const char* const table_type_names[NUM_TABLE_TYPES] = {
+	"string",
+	"int16",
+	"uint16",
+	"int32",
+	"uint32",
+	"int64",
+	"uint64",
+	"float32",
+	"float64"
+};
+
+struct table_entry {
+	char*		name;
+	h5_int64_t	type;
+	hvl_t		values[NUM_TABLE_TYPES];
+};
+
+/*
+  Return index of the table member for values of given type.
+ */
+static inline h5_err_t
+get_table_type_idx (
+	const h5_int64_t type
+	) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	hid_t normalized_type;
+	TRY (normalized_type = h5priv_map_enum_to_normalized_type (
+		     (h5_types_t)type));
+	ret_value = H5_ERR;
+	for (int i = 0; i < NUM_TABLE_TYPES; i++) {
+		if (h5priv_map_enum_to_normalized_type (table_types[i])
+		    == normalized_type) {
+			ret_value = i;
+			break;
+		}
+	}
+	if (ret_value < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Invalid attribute type %lld",
+			(long long)type);
+	H5_RETURN (ret_value);
+}
+
+/*
+  Size of the value of an attribute table entry in bytes.
+ */
+h5_ssize_t
+h5priv_get_attrib_value_size (
+	const h5_attrib_t* const a
+	) {
+	H5_PRIV_API_ENTER (h5_ssize_t, "a=%p", a);
+	hid_t type_id;
+	TRY (type_id = h5priv_map_enum_to_normalized_type (
+		     (h5_types_t)a->type));
+	h5_ssize_t size;
+	TRY (size = hdf5_get_sizeof_type (type_id));
+	H5_RETURN (size * (h5_ssize_t)a->nelem);
+}
+
+static hid_t
+create_table_type (
+	void
+	) {
+	H5_PRIV_FUNC_ENTER (hid_t, "%s", "void");
+	hid_t type_id;
+	TRY (type_id = hdf5_create_type (
+		     H5T_COMPOUND, sizeof (struct table_entry)));
+	hid_t member_type_id;
+	TRY (member_type_id = hdf5_create_string_type (H5T_VARIABLE));
+	TRY (hdf5_insert_type (
+		     type_id, "name",
+		     HOFFSET (struct table_entry, name), member_type_id));
+	TRY (hdf5_close_type (member_type_id));
+	TRY (hdf5_insert_type (
+		     type_id, "type",
+		     HOFFSET (struct table_entry, type), H5_INT64));
+	for (int i = 0; i < NUM_TABLE_TYPES; i++) {
+		hid_t base_type_id;
+		TRY (base_type_id = h5priv_map_enum_to_normalized_type (
+			     table_types[i]));
+		TRY (member_type_id = hdf5_create_vlen_type (base_type_id));
+		TRY (hdf5_insert_type (
+			     type_id, table_type_names[i],
+			     HOFFSET (struct table_entry, values) +
+			     i * sizeof (hvl_t),
+			     member_type_id));
+		TRY (hdf5_close_type (member_type_id));
+	}
+	H5_RETURN (type_id);
+}
+
+/*
+  Read the attribute table of object id, which must exist, into a
+  single allocation. Return the number of entries.
+ */
+static h5_ssize_t
+read_table (
+	const hid_t id,
+	h5_attrib_t** const attribs
+	) {
+	H5_PRIV_FUNC_ENTER (h5_ssize_t,
+			    "id=%lld, attribs=%p",
+			    (long long int)id, attribs);
+	hid_t attrib_id;
+	TRY (attrib_id = hdf5_open_attribute_by_name (
+		     id, H5_ATTRIB_TABLE_NAME));
+	hid_t space_id;
+	TRY (space_id = hdf5_get_attribute_dataspace (attrib_id));
+	h5_ssize_t num_entries;
+	TRY (num_entries = hdf5_get_npoints_of_dataspace (space_id));
+	hid_t type_id;
+	TRY (type_id = create_table_type ());
+	struct table_entry* entries;
+	TRY (entries = h5_calloc (num_entries + 1, sizeof (*entries)));
+	TRY (hdf5_read_attribute (attrib_id, type_id, entries));
+
+	size_t table_size = ALIGN8 (num_entries * sizeof (h5_attrib_t));
+	size_t size = table_size;
+	for (h5_ssize_t i = 0; i < num_entries; i++) {
+		int idx;
+		TRY (idx = get_table_type_idx (entries[i].type));
+		h5_attrib_t a = {NULL, entries[i].type, entries[i].values[idx].len};
+		h5_ssize_t value_size;
+		TRY (value_size = h5priv_get_attrib_value_size (&a));
+		size += ALIGN8 (strlen (entries[i].name) + 1) +
+			ALIGN8 (value_size);
+	}
+	char* buf;
+	TRY (buf = h5_calloc (1, size + 1));
+	h5_attrib_t* table = (h5_attrib_t*)buf;
+	char* next = buf + table_size;
+	for (h5_ssize_t i = 0; i < num_entries; i++) {
+		h5_attrib_t* a = &table[i];
+		int idx;
+		TRY (idx = get_table_type_idx (entries[i].type));
+		size_t len = strlen (entries[i].name) + 1;
+		memcpy (next, entries[i].name, len);
+		a->name = next;
+		next += ALIGN8 (len);
+		a->type = table_types[idx];
+		a->nelem = entries[i].values[idx].len;
+		h5_ssize_t value_size;
+		TRY (value_size = h5priv_get_attrib_value_size (a));
+		if (value_size > 0) {
+			memcpy (next, entries[i].values[idx].p, value_size);
+		}
+		a->value = next;
+		next += ALIGN8 (value_size);
+	}
+	TRY (hdf5_reclaim_vlen (type_id, space_id, entries));
+	TRY (h5_free (entries));
+	TRY (hdf5_close_type (type_id));
+	TRY (hdf5_close_dataspace (space_id));
+	TRY (hdf5_close_attribute (attrib_id));
+	*attribs = table;
+	H5_RETURN (num_entries);
+}
+
+/*
+  Read the attribute table of object id into a single allocation, which
+  must be released with h5_free(). Return the number of entries or 0
+  and NULL if the object has no table.
+ */
+h5_ssize_t
+h5priv_read_attrib_table (
+	const hid_t id,
+	h5_attrib_t** const attribs
+	) {
+	H5_PRIV_API_ENTER (h5_ssize_t,
+			   "id=%lld, attribs=%p",
+			   (long long int)id, attribs);
+	*attribs = NULL;
+	h5_err_t exists;
+	TRY (exists = hdf5_attribute_exists (id, H5_ATTRIB_TABLE_NAME));
+	if (!exists) {
+		H5_LEAVE (0);
+	}
+	H5_RETURN (read_table (id, attribs));
+}
+
+/*
+  Write the attribute table of object id, replacing an existing table.
+ */
+static h5_err_t
+write_table (
+	const hid_t id,
+	const h5_attrib_t* const* const attribs,
+	const h5_size_t num_attribs,
+	const int exists
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t,
+			    "id=%lld, attribs=%p, num_attribs=%llu, exists=%d",
+			    (long long int)id, attribs,
+			    (long long unsigned)num_attribs, exists);
+	if (exists) {
+		TRY (hdf5_delete_attribute (id, H5_ATTRIB_TABLE_NAME));
+	}
+	if (num_attribs == 0) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	struct table_entry* entries;
+	TRY (entries = h5_calloc (num_attribs, sizeof (*entries)));
+	for (h5_size_t i = 0; i < num_attribs; i++) {
+		const h5_attrib_t* a = attribs[i];
+		int idx;
+		TRY (idx = get_table_type_idx (a->type));
+		entries[i].name = (char*)a->name;
+		entries[i].type = table_types[idx];
+		entries[i].values[idx].len = a->nelem;
+		entries[i].values[idx].p = (void*)a->value;
+	}
+	hid_t type_id;
+	TRY (type_id = create_table_type ());
+	hsize_t dims = num_attribs;
+	hid_t space_id;
+	TRY (space_id = hdf5_create_dataspace (1, &dims, NULL));
+	hid_t attrib_id;
+	TRY (attrib_id = hdf5_create_attribute (
+		     id,
+		     H5_ATTRIB_TABLE_NAME,
+		     type_id,
+		     space_id,
+		     H5P_DEFAULT, H5P_DEFAULT));
+	TRY (hdf5_write_attribute (attrib_id, type_id, entries));
+	TRY (hdf5_close_attribute (attrib_id));
+	TRY (hdf5_close_dataspace (space_id));
+	TRY (hdf5_close_type (type_id));
+	TRY (h5_free (entries));
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Names of the attributes attached to an object before writing a table.
+ */
+struct attrib_names {
+	char** names;
+	int num_names;
+};
+
+static herr_t
+add_attrib_name (
+	hid_t loc_id,
+	const char* name,
+	const H5A_info_t* info,
+	void* op_data
+	) {
+	UNUSED_ARGUMENT (loc_id);
+	UNUSED_ARGUMENT (info);
+	struct attrib_names* names = (struct attrib_names*)op_data;
+	char* s = h5_strdup (name);
+	if (s == NULL)
+		return -1;
+	names->names[names->num_names++] = s;
+	return 0;
+}
+
+static int
+cmp_attrib_names (
+	const void* a,
+	const void* b
+	) {
+	return strcmp (*(char* const*)a, *(char* const*)b);
+}
+
+/*
+  Get the sorted names of the num_attribs attributes of object id with
+  one iteration.
+ */
+static h5_err_t
+get_attrib_names (
+	const hid_t id,
+	const int num_attribs,
+	struct attrib_names* const names
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t,
+			    "id=%lld, num_attribs=%d, names=%p",
+			    (long long int)id, num_attribs, names);
+	TRY (names->names = h5_calloc (num_attribs, sizeof (char*)));
+	TRY (hdf5_iterate_attributes (id, add_attrib_name, names));
+	qsort (names->names, names->num_names, sizeof (char*),
+	       cmp_attrib_names);
+	H5_RETURN (H5_SUCCESS);
+}
+
+static h5_err_t
+free_attrib_names (
+	struct attrib_names* const names
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "names=%p", names);
+	for (int i = 0; i < names->num_names; i++) {
+		TRY (h5_free (names->names[i]));
+	}
+	TRY (h5_free (names->names));
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline int
+has_attrib_name (
+	const struct attrib_names* const names,
+	const char* const name
+	) {
+	return names->num_names > 0 &&
+		bsearch (&name, names->names, names->num_names,
+			 sizeof (char*), cmp_attrib_names) != NULL;
+}
+
+/*
+  Return index of the entry with given name or -1.
+ */
+static inline h5_ssize_t
+find_entry (
+	const h5_attrib_t* const* const attribs,
+	const h5_size_t num_attribs,
+	const char* const name
+	) {
+	for (h5_size_t i = 0; i < num_attribs; i++) {
+		if (strcmp (attribs[i]->name, name) == 0)
+			return (h5_ssize_t)i;
+	}
+	return -1;
+}
+
+/*
+  Merge the entries with an existing table of the object: entries
+  replace table entries with the same name in place, the others are
+  appended. Only if the object already has attributes, we have to read
+  their names - with one iteration - and the existing table. Otherwise
+  writing the table costs H5Acreate, H5Awrite and H5Aclose only.
+ */
+h5_err_t
+h5priv_write_attribs (
+	const hid_t id,			/*!< HDF5 object ID */
+	const h5_attrib_t* const attribs,/*!< attribute table */
+	const h5_size_t num_attribs,	/*!< number of entries */
+	const int append		/*!< don't overwrite attributes */
+	) {
+	H5_PRIV_API_ENTER (h5_err_t,
+			   "id=%lld, attribs=%p, num_attribs=%llu, append=%d",
+			   (long long int)id,
+			   attribs,
+			   (long long unsigned)num_attribs,
+			   append);
+	for (h5_size_t i = 0; i < num_attribs; i++) {
+		if (strcmp (attribs[i].name, H5_ATTRIB_TABLE_NAME) == 0) {
+			H5_RETURN_ERROR (
+				H5_ERR_INVAL,
+				"Attribute name '%s' is reserved",
+				attribs[i].name);
+		}
+	}
+	struct attrib_names names = {NULL, 0};
+	h5_attrib_t* table = NULL;
+	h5_ssize_t num_table = 0;
+	int num_existing;
+	TRY (num_existing = hdf5_get_num_attribute (id));
+	if (num_existing > 0) {
+		TRY (get_attrib_names (id, num_existing, &names));
+	}
+	int has_table = has_attrib_name (&names, H5_ATTRIB_TABLE_NAME);
+	if (has_table) {
+		TRY (num_table = read_table (id, &table));
+	}
+	const h5_attrib_t** merged;
+	TRY (merged = h5_calloc (num_table + num_attribs + 1, sizeof (*merged)));
+	h5_size_t num_merged = 0;
+	for (h5_ssize_t i = 0; i < num_table; i++) {
+		merged[num_merged++] = &table[i];
+	}
+	for (h5_size_t i = 0; i < num_attribs; i++) {
+		const h5_attrib_t* a = &attribs[i];
+		h5_ssize_t j = find_entry (merged, num_merged, a->name);
+		int exists = j >= 0 || has_attrib_name (&names, a->name);
+		if (exists && append) {
+			H5_RETURN_ERROR (
+				H5_ERR,
+				"Cannot overwrite attribute %s/%s",
+				hdf5_get_objname (id), a->name);
+		}
+		if (j >= 0) {
+			merged[j] = a;
+			continue;
+		}
+		if (exists) {
+			// names must be unique among table and attributes
+			TRY (hdf5_delete_attribute (id, a->name));
+		}
+		merged[num_merged++] = a;
+	}
+	TRY (write_table (id, merged, num_merged, has_table));
+	TRY (h5_free (merged));
+	TRY (h5_free (table));
+	TRY (free_attrib_names (&names));
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Remove the entry with given name from the attribute table of object
+  id. Must be called before an ordinary attribute with this name is
+  written. In append mode an existing entry is an error.
+ */
+h5_err_t
+h5priv_remove_table_attrib (
+	const hid_t id,			/*!< HDF5 object ID */
+	const char* const attrib_name,	/*!< name of attribute */
+	const int append		/*!< don't overwrite attributes */
+	) {
+	H5_PRIV_API_ENTER (h5_err_t,
+			   "id=%lld, attrib_name='%s', append=%d",
+			   (long long int)id, attrib_name, append);
+	if (strcmp (attrib_name, H5_ATTRIB_TABLE_NAME) == 0) {
+		H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"Attribute name '%s' is reserved",
+			attrib_name);
+	}
+	h5_attrib_t* table;
+	h5_ssize_t num_table;
+	TRY (num_table = h5priv_read_attrib_table (id, &table));
+	const h5_attrib_t** entries;
+	TRY (entries = h5_calloc (num_table + 1, sizeof (*entries)));
+	h5_size_t num_entries = 0;
+	for (h5_ssize_t i = 0; i < num_table; i++) {
+		if (strcmp (table[i].name, attrib_name) != 0) {
+			entries[num_entries++] = &table[i];
+		}
+	}
+	if ((h5_ssize_t)num_entries < num_table) {
+		if (append) {
+			H5_RETURN_ERROR (
+				H5_ERR,
+				"Cannot overwrite attribute %s/%s",
+				hdf5_get_objname (id), attrib_name);
+		}
+		TRY (write_table (id, entries, num_entries, 1));
+	}
+	TRY (h5_free (entries));
+	TRY (h5_free (table));
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  State of the attribute iteration. In the first pass we only count
+  attributes and sum up the required memory, in the second pass the
+  table is filled.
+ */
+struct read_attribs_state {
+	h5_attrib_t* attribs;		// NULL in first pass
+	char* next;			// next free byte in second pass
+	h5_size_t num_attribs;
+	size_t size;
+	int has_table;
+};
+
+static herr_t
+count_attrib (
+	hid_t loc_id,
+	const char* name,
+	const H5A_info_t* info,
+	void* op_data
+	) {
+	UNUSED_ARGUMENT (loc_id);
+	struct read_attribs_state* state = (struct read_attribs_state*)op_data;
+	if (strcmp (name, H5_ATTRIB_TABLE_NAME) == 0) {
+		state->has_table = 1;
+		return 0;
+	}
+	state->num_attribs++;
+	state->size += ALIGN8 (strlen (name) + 1) + ALIGN8 (info->data_size);
+	return 0;
+}
+
+static herr_t
+read_attrib (
+	hid_t loc_id,
+	const char* name,
+	const H5A_info_t* info,
+	void* op_data
+	) {
+	H5_PRIV_FUNC_ENTER (herr_t,
+			    "loc_id=%lld, name='%s', info=%p, op_data=%p",
+			    (long long int)loc_id, name, info, op_data);
+	if (strcmp (name, H5_ATTRIB_TABLE_NAME) == 0) {
+		H5_LEAVE (0);
+	}
+	struct read_attribs_state* state = (struct read_attribs_state*)op_data;
+	h5_attrib_t* a = &state->attribs[state->num_attribs];
+
+	size_t len = strlen (name) + 1;
+	memcpy (state->next, name, len);
+	a->name = state->next;
+	state->next += ALIGN8 (len);
+
+	hid_t attrib_id;
+	TRY (attrib_id = hdf5_open_attribute_by_name (loc_id, name));
+	hid_t file_type_id;
+	TRY (file_type_id = hdf5_get_attribute_type (attrib_id));
+	TRY (a->type = h5priv_map_hdf5_type_to_enum (file_type_id));
+	hid_t mem_type_id;
+	if (a->type == H5_STRING_T) {
+		mem_type_id = file_type_id;
+		a->nelem = info->data_size;
+	} else {
+		TRY (mem_type_id = h5priv_normalize_type (file_type_id));
+		hid_t space_id;
+		TRY (space_id = hdf5_get_attribute_dataspace (attrib_id));
+		TRY (a->nelem = hdf5_get_npoints_of_dataspace (space_id));
+		TRY (hdf5_close_dataspace (space_id));
+	}
+	TRY (hdf5_read_attribute (attrib_id, mem_type_id, state->next));
+	a->value = state->next;
+	state->next += ALIGN8 (info->data_size);
+	TRY (hdf5_close_type (file_type_id));
+	TRY (hdf5_close_attribute (attrib_id));
+	state->num_attribs++;
+	H5_RETURN (0);
+}
+
+/*
+  Ordinary attributes are returned first, followed by the entries of
+  the attribute table.
+ */
+h5_ssize_t
+h5priv_read_attribs (
+	const hid_t id,			/*!< HDF5 object ID */
+	h5_attrib_t** const attribs	/*!< OUT: attribute table */
+	) {
+	H5_PRIV_API_ENTER (h5_ssize_t,
+			   "id=%lld, attribs=%p",
+			   (long long int)id, attribs);
+	struct read_attribs_state state;
+	memset (&state, 0, sizeof (state));
+	TRY (hdf5_iterate_attributes (id, count_attrib, &state));
+	h5_attrib_t* table = NULL;
+	h5_ssize_t num_table = 0;
+	if (state.has_table) {
+		TRY (num_table = read_table (id, &table));
+	}
+	for (h5_ssize_t i = 0; i < num_table; i++) {
+		h5_ssize_t value_size;
+		TRY (value_size = h5priv_get_attrib_value_size (&table[i]));
+		state.size += ALIGN8 (strlen (table[i].name) + 1) +
+			ALIGN8 (value_size);
+	}
+	size_t table_size = ALIGN8 (
+		(state.num_attribs + num_table) * sizeof (h5_attrib_t));
+	char* buf;
+	TRY (buf = h5_calloc (1, table_size + state.size + 1));
+	state.attribs = (h5_attrib_t*)buf;
+	state.next = buf + table_size;
+	state.num_attribs = 0;
+	if (hdf5_iterate_attributes (id, read_attrib, &state) < 0) {
+		h5_free (table);
+		h5_free (buf);
+		H5_LEAVE (H5_ERR);
+	}
+	for (h5_ssize_t i = 0; i < num_table; i++) {
+		h5_attrib_t* a = &state.attribs[state.num_attribs++];
+		size_t len = strlen (table[i].name) + 1;
+		memcpy (state.next, table[i].name, len);
+		a->name = state.next;
+		state.next += ALIGN8 (len);
+		a->type = table[i].type;
+		a->nelem = table[i].nelem;
+		h5_ssize_t value_size;
+		TRY (value_size = h5priv_get_attrib_value_size (&table[i]));
+		memcpy (state.next, table[i].value, value_size);
+		a->value = state.next;
+		state.next += ALIGN8 (value_size);
+	}
+	TRY (h5_free (table));
+	*attribs = state.attribs;
+	H5_RETURN ((h5_ssize_t)state.num_attribs);
+}
@@ -14,6 +14,28 @@
 #include "private/h5_model.h"
 #include "private/h5_hdf5.h"
 
+// name of the compound attribute storing an attribute table
+#define H5_ATTRIB_TABLE_NAME	"__attribs__"
+
+h5_err_t
+h5priv_write_attribs (
+	const hid_t, const h5_attrib_t* const, const h5_size_t, const int);
+
+h5_err_t
+h5priv_remove_table_attrib (
+	const hid_t, const char* const, const int);
+
+h5_ssize_t
+h5priv_read_attribs (
+	const hid_t, h5_attrib_t** const);
+
+h5_ssize_t
+h5priv_read_attrib_table (
+	const hid_t, h5_attrib_t** const);
+
+h5_ssize_t
+h5priv_get_attrib_value_size (
+	const h5_attrib_t* const);
 
 static inline hid_t
 h5priv_get_normalized_attribute_type (
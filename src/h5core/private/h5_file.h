@@ -11,11 +11,21 @@
 #define H5_VFD_MPIO_COLLECTIVE  0x00000040
 #define H5_VFD_CORE		0x00000080
 
+#define H5_COLL_METADATA	0x00000100
+#define H5_STAGE_ASYNC		0x00000200
+#define H5_PREFETCH		0x00000400
+#define H5_ATTACH_STRIPED	0x00000800
+
+#define H5_CORE_VFD_INCREMENT	(1024*1024)
+
 #define H5_FLUSH_FILE		0x00001000
 #define H5_FLUSH_ITERATION	0x00002000
 #define H5_FLUSH_DATASET	0x00004000
 
 #define H5_FS_LUSTRE		0x00010000
+#define H5_FS_TUNE		0x00020000
+#define H5_IO_TRACE		0x00040000
+#define H5_ATTRIB_CACHE		0x00080000
 
 static inline int
 is_valid_file_handle(h5_file_p f) {
@@ -0,0 +1,297 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <sys/statfs.h>
+#endif
+
+#include "h5core/h5_syscall.h"
+
+#include "private/h5_file.h"
+#include "private/h5_fs.h"
+#include "private/h5_hdf5.h"
+#include "private/h5_lustre.h"
+#include "private/h5_mpi.h"
+
+#define LUSTRE_SUPER_MAGIC	0x0BD00BD0
+#define GPFS_SUPER_MAGIC	0x47504653
+#define BEEGFS_SUPER_MAGIC	0x19830326
+
+#define BTREE_IK_MAX		32767
+
+/*
+  A file system tuner detects a specific file system by its magic
+  number, queries its block or stripe size and sets MPI-IO hints.
+  Alignment and B-tree K are derived from the block size for all
+  file systems.
+ */
+typedef struct {
+	const char* name;
+	long magic;
+	h5_err_t (*query)(const char* const, const struct stat* const,
+			  h5_fs_info_t* const);
+#ifdef H5_HAVE_PARALLEL
+	h5_err_t (*set_hints)(MPI_Info, const h5_fs_info_t* const);
+#endif
+} h5_fs_tuner_t;
+
+static h5_err_t
+query_st_blksize (
+	const char* const path,
+	const struct stat* const st,
+	h5_fs_info_t* const info
+	) {
+	UNUSED_ARGUMENT (path);
+	info->block_size = (h5_int64_t)st->st_blksize;
+	info->stripe_count = 0;
+	return H5_SUCCESS;
+}
+
+static h5_err_t
+query_lustre (
+	const char* const path,
+	const struct stat* const st,
+	h5_fs_info_t* const info
+	) {
+#ifdef H5_USE_LUSTRE
+	UNUSED_ARGUMENT (st);
+	return h5priv_get_lustre_stripe_info (
+		path, &info->block_size, &info->stripe_count);
+#else
+	// Lustre reports the stripe size as preferred I/O block size
+	return query_st_blksize (path, st, info);
+#endif
+}
+
+#ifdef H5_HAVE_PARALLEL
+static inline h5_err_t
+set_hint (
+	MPI_Info info,
+	const char* const key,
+	const char* const value
+	) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	h5_debug ("Setting MPI-IO hint %s=%s", key, value);
+	if (MPI_Info_set (info, (char*)key, (char*)value) != MPI_SUCCESS)
+		H5_RETURN_ERROR (
+			H5_ERR_MPI,
+			"Cannot set MPI-IO hint %s=%s",
+			key, value);
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline h5_err_t
+set_hint_int (
+	MPI_Info info,
+	const char* const key,
+	const h5_int64_t value
+	) {
+	char s[32];
+	snprintf (s, sizeof (s), "%lld", (long long)value);
+	return set_hint (info, key, s);
+}
+
+static h5_err_t
+set_hints_lustre (
+	MPI_Info info,
+	const h5_fs_info_t* const fs
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "info=?, fs=%p", fs);
+	TRY (set_hint (info, "romio_cb_write", "enable"));
+	TRY (set_hint (info, "romio_ds_write", "disable"));
+	TRY (set_hint_int (info, "cb_buffer_size", fs->block_size));
+	if (fs->stripe_count > 0) {
+		// one aggregator per OST
+		TRY (set_hint_int (info, "cb_nodes", fs->stripe_count));
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
+static h5_err_t
+set_hints_gpfs (
+	MPI_Info info,
+	const h5_fs_info_t* const fs
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "info=?, fs=%p", fs);
+	TRY (set_hint (info, "IBM_largeblock_io", "true"));
+	TRY (set_hint (info, "romio_ds_write", "disable"));
+	TRY (set_hint_int (info, "cb_buffer_size", fs->block_size));
+	H5_RETURN (H5_SUCCESS);
+}
+
+static h5_err_t
+set_hints_beegfs (
+	MPI_Info info,
+	const h5_fs_info_t* const fs
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "info=?, fs=%p", fs);
+	TRY (set_hint (info, "romio_cb_write", "enable"));
+	TRY (set_hint_int (info, "cb_buffer_size", fs->block_size));
+	H5_RETURN (H5_SUCCESS);
+}
+#define TUNER(name, magic, query, hints)	{ name, magic, query, hints }
+#else
+#define TUNER(name, magic, query, hints)	{ name, magic, query }
+#endif
+
+static const h5_fs_tuner_t tuners[] = {
+	TUNER ("Lustre", LUSTRE_SUPER_MAGIC, query_lustre, set_hints_lustre),
+	TUNER ("GPFS", GPFS_SUPER_MAGIC, query_st_blksize, set_hints_gpfs),
+	TUNER ("BeeGFS", BEEGFS_SUPER_MAGIC, query_st_blksize, set_hints_beegfs)
+};
+#define NUM_TUNERS	(sizeof (tuners) / sizeof (tuners[0]))
+
+/*
+  Detect the file system of 'filename' or, if the file doesn't exist
+  yet, of its directory. Return the index of the matching tuner or -1.
+ */
+static inline h5_err_t
+detect_fs (
+	const char* const filename,
+	h5_int64_t* const tuner_idx,
+	h5_fs_info_t* const fs
+	) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	*tuner_idx = -1;
+#if defined(__linux__)
+	char* path;
+	TRY (path = h5_strdup (filename));
+	struct stat st;
+	if (stat (path, &st) < 0) {
+		char* slash = strrchr (path, '/');
+		if (slash == NULL) {
+			strcpy (path, ".");
+		} else if (slash == path) {
+			slash[1] = '\0';
+		} else {
+			*slash = '\0';
+		}
+	}
+	struct statfs sfs;
+	if (stat (path, &st) < 0 || statfs (path, &sfs) < 0) {
+		h5_warn ("Cannot detect file system of '%s': %s",
+			 path, strerror (errno));
+		TRY (h5_free (path));
+		H5_LEAVE (H5_SUCCESS);
+	}
+	for (size_t i = 0; i < NUM_TUNERS; i++) {
+		if ((long)sfs.f_type == tuners[i].magic) {
+			TRY (tuners[i].query (path, &st, fs));
+			*tuner_idx = (h5_int64_t)i;
+			break;
+		}
+	}
+	TRY (h5_free (path));
+#else
+	UNUSED_ARGUMENT (filename);
+	UNUSED_ARGUMENT (fs);
+#endif
+	H5_RETURN (H5_SUCCESS);
+}
+
+#ifdef H5_HAVE_PARALLEL
+static inline h5_err_t
+set_mpio_hints (
+	const h5_file_p f,
+	const h5_fs_tuner_t* const tuner,
+	const h5_fs_info_t* const fs
+	) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	if (f->props->flags & H5_VFD_CORE) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	MPI_Info info;
+	if (MPI_Info_create (&info) != MPI_SUCCESS)
+		H5_RETURN_ERROR (
+			H5_ERR_MPI,
+			"%s",
+			"Cannot create MPI info object");
+	if (tuner->set_hints (info, fs) < 0 ||
+	    hdf5_set_fapl_mpio_property (
+		    f->props->access_prop, f->props->comm, info) < 0) {
+		MPI_Info_free (&info);
+		H5_LEAVE (H5_ERR);
+	}
+	MPI_Info_free (&info);
+	H5_RETURN (H5_SUCCESS);
+}
+#endif
+
+/*
+  Detect the file system the file will be stored on and tune alignment,
+  B-tree K and MPI-IO hints accordingly. The detection is done on
+  the first process only, the result is broadcasted to all other
+  processes. If the detection fails, the error is broadcasted too, so
+  all processes fail together.
+
+  An alignment set explicitly via file property is kept.
+ */
+h5_err_t
+h5priv_tune_for_fs (
+	const h5_file_p f,
+	const char* const filename
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "f=%p, filename='%s'", f, filename);
+	if (!(f->props->flags & (H5_FS_TUNE | H5_FS_LUSTRE))) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	// buf[0]: index of tuner, -1 if no tuner matches, -2 on error
+	h5_int64_t buf[3] = {-1, 0, 0};
+	h5_fs_info_t fs = {0, 0};
+	if (f->myproc == 0) {
+		if (detect_fs (filename, &buf[0], &fs) < 0) {
+			buf[0] = -2;
+		}
+		buf[1] = fs.block_size;
+		buf[2] = fs.stripe_count;
+	}
+#ifdef H5_HAVE_PARALLEL
+	TRY (h5priv_mpi_bcast (buf, 3, MPI_LONG_LONG, 0, f->props->comm));
+#endif
+	if (buf[0] == -2) {
+		H5_RETURN_ERROR (
+			H5_ERR_INTERNAL,
+			"Cannot detect file system of '%s'.",
+			filename);
+	}
+	if (buf[0] < 0 || buf[1] <= 0) {
+		h5_info ("No file system specific tuning for '%s'.", filename);
+		H5_LEAVE (H5_SUCCESS);
+	}
+	const h5_fs_tuner_t* tuner = &tuners[buf[0]];
+	fs.block_size = buf[1];
+	fs.stripe_count = buf[2];
+	h5_info ("Found %s file system with block size %lld bytes "
+		 "and stripe count %lld.",
+		 tuner->name,
+		 (long long)fs.block_size, (long long)fs.stripe_count);
+
+	if (f->props->align == 0) {
+		f->props->align = fs.block_size;
+		h5_info ("Setting alignment to %s block size.", tuner->name);
+	} else {
+		h5_info ("Keeping alignment of %lld bytes set by property.",
+			 (long long)f->props->align);
+	}
+
+	// chunk B-tree node of rank 3 datasets fills one block
+	hsize_t btree_ik = fs.block_size > 4096 ? (fs.block_size - 4096) / 96 : 1;
+	if (btree_ik > BTREE_IK_MAX)
+		btree_ik = BTREE_IK_MAX;
+	h5_info ("Setting HDF5 btree ik to %llu.", (unsigned long long)btree_ik);
+	TRY (hdf5_set_btree_ik_property (f->props->create_prop, btree_ik));
+
+#ifdef H5_HAVE_PARALLEL
+	TRY (set_mpio_hints (f, tuner, &fs));
+#endif
+	H5_RETURN (H5_SUCCESS);
+}
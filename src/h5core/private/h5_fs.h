@@ -0,0 +1,27 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+#ifndef __PRIVATE_H5_FS_H
+#define __PRIVATE_H5_FS_H
+
+#include "private/h5_types.h"
+
+/*
+  File system properties detected by a file system tuner.
+ */
+typedef struct {
+	h5_int64_t block_size;		// stripe or block size in bytes
+	h5_int64_t stripe_count;	// number of stripes, 0 if unknown
+} h5_fs_info_t;
+
+h5_err_t
+h5priv_tune_for_fs (
+	const h5_file_p, const char* const);
+
+#endif
@@ -335,7 +335,7 @@ const char *
 hdf5_get_objname (
         hid_t id
         ) {
-	static char objname[256];
+	static H5_THREAD_LOCAL char objname[256];
 
 	// memset ( objname, 0, sizeof(objname) );
 	if (id == -1) {
@@ -311,6 +311,27 @@ hdf5_get_num_objs_in_group (
 }
 
 
+/*!
+   H5Iget_name() wrapper. Returns the length of the path of the object.
+ */
+static inline h5_ssize_t
+hdf5_get_object_path (
+        const hid_t obj_id,
+        char* const name,
+        const size_t size
+        ) {
+	HDF5_WRAPPER_ENTER (h5_ssize_t,
+			    "obj_id=%lld, name=%p, size=%zu",
+			    (long long int)obj_id, name, size);
+	ssize_t len = H5Iget_name (obj_id, name, size);
+	if (len <= 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"Cannot get path of object %lld.",
+			(long long int)obj_id);
+	H5_RETURN (len);
+}
+
 static inline h5_ssize_t
 hdf5_get_objname_by_idx (
         hid_t loc_id,
@@ -465,6 +486,26 @@ hdf5_get_selected_npoints_of_dataspace (
 	H5_RETURN (size);
 }
 
+/*!
+   H5Sget_select_bounds() wrapper.
+ */
+static inline h5_err_t
+hdf5_get_selection_bounds (
+        const hid_t space_id,
+        hsize_t* const start,
+        hsize_t* const end
+        ) {
+	HDF5_WRAPPER_ENTER (h5_err_t,
+			    "space_id=%lld, start=%p, end=%p",
+			    (long long int)space_id, start, end);
+	if (H5Sget_select_bounds (space_id, start, end) < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"%s",
+			"Cannot determine bounds of selection in dataspace.");
+	H5_RETURN (H5_SUCCESS);
+}
+
 static inline h5_ssize_t
 hdf5_get_npoints_of_dataspace (
         hid_t space_id
@@ -518,6 +559,76 @@ hdf5_close_dataspace (
 	H5_RETURN (H5_SUCCESS);
 }
 
+#if H5_VERSION_GE(1,8,11)
+/*!
+   H5Dgather() wrapper: copy the elements selected in \c space_id from
+   \c src_buf, which is described by the extent of \c space_id, to the
+   contiguous buffer \c dst_buf.
+ */
+static inline h5_err_t
+hdf5_gather_selection (
+        const hid_t space_id,
+        const void* const src_buf,
+        const hid_t type_id,
+        const size_t dst_size,
+        void* const dst_buf
+        ) {
+	HDF5_WRAPPER_ENTER (h5_err_t,
+			    "space_id=%lld, src_buf=%p, type_id=%lld, "
+			    "dst_size=%zu, dst_buf=%p",
+			    (long long int)space_id, src_buf,
+			    (long long int)type_id, dst_size, dst_buf);
+	if (H5Dgather (space_id, src_buf, type_id, dst_size, dst_buf,
+		       NULL, NULL) < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"%s",
+			"Cannot gather selected elements.");
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline herr_t
+hdf5_scatter_selection_op (
+	const void** src_buf,
+	size_t* src_buf_bytes_used,
+	void* op_data
+	) {
+	// hand out the whole source buffer at once
+	const void** src = (const void**)op_data;
+	*src_buf = src[0];
+	*src_buf_bytes_used = (size_t)src[1];
+	return 0;
+}
+
+/*!
+   H5Dscatter() wrapper: copy \c src_size bytes of contiguous elements
+   from \c src_buf to the elements selected in \c space_id of
+   \c dst_buf, which is described by the extent of \c space_id.
+ */
+static inline h5_err_t
+hdf5_scatter_selection (
+        const void* const src_buf,
+        const size_t src_size,
+        const hid_t type_id,
+        const hid_t space_id,
+        void* const dst_buf
+        ) {
+	HDF5_WRAPPER_ENTER (h5_err_t,
+			    "src_buf=%p, src_size=%zu, type_id=%lld, "
+			    "space_id=%lld, dst_buf=%p",
+			    src_buf, src_size, (long long int)type_id,
+			    (long long int)space_id, dst_buf);
+	const void* src[2] = { src_buf, (const void*)src_size };
+	if (H5Dscatter (hdf5_scatter_selection_op, src, type_id,
+			space_id, dst_buf) < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"%s",
+			"Cannot scatter elements to selection.");
+	H5_RETURN (H5_SUCCESS);
+}
+#endif
+
 /****** D a t a s e t ********************************************************/
 /*!
    H5Dopen wrapper.
@@ -709,6 +820,40 @@ hdf5_get_dataset_type (
 	H5_RETURN (datatype_id);
 }
 
+/*!
+   H5Dget_offset() wrapper. The offset is set to \c HADDR_UNDEF if the
+   dataset isn't stored contiguously or storage hasn't been allocated
+   yet.
+ */
+static inline h5_err_t
+hdf5_get_dataset_offset (
+        const hid_t dataset_id,
+        haddr_t* const offset
+        ) {
+	HDF5_WRAPPER_ENTER (h5_err_t,
+	                    "dataset_id=%lld (%s), offset=%p",
+	                    (long long int)dataset_id,
+	                    hdf5_get_objname(dataset_id),
+	                    offset);
+	*offset = H5Dget_offset (dataset_id);
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*!
+   H5Dget_storage_size() wrapper. Returns 0 if no storage has been
+   allocated.
+ */
+static inline h5_ssize_t
+hdf5_get_dataset_storage_size (
+        const hid_t dataset_id
+        ) {
+	HDF5_WRAPPER_ENTER (h5_ssize_t,
+	                    "dataset_id=%lld (%s)",
+	                    (long long int)dataset_id,
+	                    hdf5_get_objname(dataset_id));
+	H5_RETURN ((h5_ssize_t)H5Dget_storage_size (dataset_id));
+}
+
 static inline h5_err_t
 hdf5_set_dataset_extent (
         hid_t dataset_id,
@@ -890,6 +1035,25 @@ hdf5_create_string_type(
 	H5_RETURN (type_id);
 }
 
+static inline hid_t
+hdf5_create_vlen_type (
+        const hid_t base_type_id
+        ) {
+	HDF5_WRAPPER_ENTER (hid_t,
+	                    "base_type_id=%lld (%s)",
+	                    (long long int)base_type_id,
+	                    hdf5_get_type_name (base_type_id));
+	hid_t type_id = H5Tvlen_create (base_type_id);
+	if (type_id < 0) {
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"Can't create variable length datatype with base "
+			"type %s",
+			hdf5_get_type_name (base_type_id));
+	}
+	H5_RETURN (type_id);
+}
+
 static inline h5_err_t
 hdf5_insert_type (
         hid_t type_id,
@@ -940,6 +1104,30 @@ hdf5_get_sizeof_type (
 	H5_RETURN (size);
 }
 
+/*!
+   H5Tequal() wrapper.
+
+   Result:
+   TRUE		if both types are equal
+   FALSE	otherwise
+   H5_FAILURE	on error
+ */
+static inline h5_err_t
+hdf5_is_equal_type (
+        const hid_t dtype_id1,
+        const hid_t dtype_id2
+        ) {
+	HDF5_WRAPPER_ENTER (h5_err_t,
+			    "dtype_id1=%lld, dtype_id2=%lld",
+			    (long long int)dtype_id1, (long long int)dtype_id2);
+	htri_t equal = H5Tequal (dtype_id1, dtype_id2);
+	if (equal < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"Cannot compare types %lld and %lld.",
+			(long long int)dtype_id1, (long long int)dtype_id2);
+	H5_RETURN (equal);
+}
 
 static inline h5_err_t
 hdf5_close_type (
@@ -957,6 +1145,33 @@ hdf5_close_type (
 	H5_RETURN (H5_SUCCESS);
 }
 
+/*!
+  Release the memory HDF5 allocated for variable length data read into
+  buf.
+ */
+static inline h5_err_t
+hdf5_reclaim_vlen (
+        const hid_t type_id,
+        const hid_t space_id,
+        void* const buf
+        ) {
+	HDF5_WRAPPER_ENTER (h5_err_t,
+			    "type_id=%lld, space_id=%lld, buf=%p",
+			    (long long int)type_id, (long long int)space_id,
+			    buf);
+#if H5_VERSION_GE(1,12,0)
+	herr_t herr = H5Treclaim (type_id, space_id, H5P_DEFAULT, buf);
+#else
+	herr_t herr = H5Dvlen_reclaim (type_id, space_id, H5P_DEFAULT, buf);
+#endif
+	if (herr < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"%s",
+			"Cannot release variable length data.");
+	H5_RETURN (H5_SUCCESS);
+}
+
 /****** P r o p e r t y ******************************************************/
 
 static inline hid_t
@@ -1013,6 +1228,47 @@ hdf5_set_chunk_property (
 	H5_RETURN (H5_SUCCESS);
 }
 
+/*!
+   H5Pset_deflate() wrapper.
+ */
+static inline h5_err_t
+hdf5_set_deflate_property (
+        const hid_t plist,
+        const unsigned int level
+        ) {
+	HDF5_WRAPPER_ENTER (h5_err_t,
+	                    "plist=%lld, level=%u",
+	                    (long long int)plist, level);
+	if (H5Pset_deflate (plist, level) < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"%s",
+			"Cannot add deflate filter to property list.");
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*!
+   H5Zfilter_avail() wrapper.
+
+   Result:
+   TRUE		if filter is available
+   FALSE	otherwise
+   H5_FAILURE	on error
+ */
+static inline h5_err_t
+hdf5_filter_avail (
+        const H5Z_filter_t filter
+        ) {
+	HDF5_WRAPPER_ENTER (h5_err_t, "filter=%d", (int)filter);
+	htri_t avail = H5Zfilter_avail (filter);
+	if (avail < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"Cannot query availability of filter %d.",
+			(int)filter);
+	H5_RETURN (avail);
+}
+
 static inline h5_err_t
 hdf5_get_chunk_property (
         hid_t plist,
@@ -1139,6 +1395,83 @@ hdf5_get_mdc_property (
 	H5_RETURN (H5_SUCCESS);
 }
 
+#if defined(H5_HAVE_PARALLEL) && H5_VERSION_GE(1,10,0)
+static inline h5_err_t
+hdf5_set_all_coll_metadata_ops (
+        hid_t fapl_id,
+        hbool_t is_collective
+        ) {
+	HDF5_WRAPPER_ENTER (h5_err_t,
+			    "fapl_id=%lld, is_collective=%d",
+			    (long long int)fapl_id, (int)is_collective);
+	if (H5Pset_all_coll_metadata_ops (fapl_id, is_collective) < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"%s",
+			"Cannot set collective metadata reads in"
+			" the file access property list.");
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline h5_err_t
+hdf5_set_coll_metadata_write (
+        hid_t fapl_id,
+        hbool_t is_collective
+        ) {
+	HDF5_WRAPPER_ENTER (h5_err_t,
+			    "fapl_id=%lld, is_collective=%d",
+			    (long long int)fapl_id, (int)is_collective);
+	if (H5Pset_coll_metadata_write (fapl_id, is_collective) < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"%s",
+			"Cannot set collective metadata writes in"
+			" the file access property list.");
+	H5_RETURN (H5_SUCCESS);
+}
+#endif
+
+#if H5_VERSION_GE(1,10,1)
+static inline h5_err_t
+hdf5_set_file_space_page_strategy (
+        hid_t fcpl_id,
+        hsize_t page_size
+        ) {
+	HDF5_WRAPPER_ENTER (h5_err_t,
+			    "fcpl_id=%lld, page_size=%llu",
+			    (long long int)fcpl_id, page_size);
+	if (H5Pset_file_space_strategy (
+		    fcpl_id, H5F_FSPACE_STRATEGY_PAGE, 0, (hsize_t)1) < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"%s",
+			"Cannot set paged file space strategy in"
+			" the file creation property list.");
+	if (H5Pset_file_space_page_size (fcpl_id, page_size) < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"Cannot set file space page size to %llu",
+			page_size);
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline h5_err_t
+hdf5_set_page_buffer_size (
+        hid_t fapl_id,
+        size_t buf_size
+        ) {
+	HDF5_WRAPPER_ENTER (h5_err_t,
+			    "fapl_id=%lld, buf_size=%zu",
+			    (long long int)fapl_id, buf_size);
+	if (H5Pset_page_buffer_size (fapl_id, buf_size, 0, 0) < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"Cannot set page buffer size to %zu",
+			buf_size);
+	H5_RETURN (H5_SUCCESS);
+}
+#endif
+
 static inline h5_err_t
 hdf5_set_btree_ik_property (
         const hid_t fcpl_id,
@@ -1207,6 +1540,21 @@ hdf5_set_fapl_core (
         H5_RETURN (H5_SUCCESS);
 }
 
+static inline h5_err_t
+hdf5_set_fapl_sec2 (
+        hid_t fapl_id
+        ) {
+	HDF5_WRAPPER_ENTER (h5_err_t,
+			    "fapl_id=%lld",
+			    (long long int)fapl_id);
+        if (H5Pset_fapl_sec2 (fapl_id))
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"%s",
+			"Cannot set property to use the H5FD_SEC2 driver.");
+        H5_RETURN (H5_SUCCESS);
+}
+
 static inline h5_err_t
 hdf5_close_property (
         hid_t prop
@@ -1275,6 +1623,27 @@ hdf5_get_object_ids (
 	H5_RETURN (ret_value);
 }
 	
+/*!
+   H5Fget_name() wrapper.
+ */
+static inline h5_ssize_t
+hdf5_get_filename (
+        const hid_t obj_id,
+        char* const name,
+        const size_t size
+        ) {
+	HDF5_WRAPPER_ENTER (h5_ssize_t,
+			    "obj_id=%lld, name=%p, size=%zu",
+			    (long long int)obj_id, name, size);
+	ssize_t len = H5Fget_name (obj_id, name, size);
+	if (len < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"Cannot get name of file of object %lld.",
+			(long long int)obj_id);
+	H5_RETURN (len);
+}
+
 static inline h5_err_t
 hdf5_close_file (
         hid_t file_id
@@ -1350,6 +1719,24 @@ hdf5_flush (
 
 /****** E r r o r h a n d l i n g ********************************************/
 
+static inline ssize_t
+hdf5_get_file_image (
+        hid_t file_id,
+        void* buf,
+        size_t size
+        ) {
+	HDF5_WRAPPER_ENTER (ssize_t,
+			    "file_id=%lld, buf=%p, size=%zu",
+	                    (long long int)file_id, buf, size);
+	ssize_t image_size = H5Fget_file_image (file_id, buf, size);
+	if (image_size < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"Cannot get image of file '%s'.",
+			hdf5_get_objname (file_id));
+	H5_RETURN (image_size);
+}
+
 static inline h5_err_t
 hdf5_set_errorhandler (
         hid_t estack_id,
@@ -1560,6 +1947,29 @@ hdf5_get_num_attribute (
 	H5_RETURN (num);
 }
 
+/*
+  Wrapper for H5Aiterate2. Attributes are visited in native order.
+ */
+static inline h5_err_t
+hdf5_iterate_attributes (
+        hid_t loc_id,
+        H5A_operator2_t op,
+        void* op_data
+        ) {
+	HDF5_WRAPPER_ENTER (h5_err_t,
+	                    "loc_id=%lld (%s), op=%p, op_data=%p",
+	                    (long long int)loc_id, hdf5_get_objname (loc_id),
+	                    (void*)op, op_data);
+	hsize_t idx = 0;
+	if (H5Aiterate2 (loc_id, H5_INDEX_NAME, H5_ITER_NATIVE,
+			 &idx, op, op_data) < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"Cannot iterate over attributes of '%s'.",
+			hdf5_get_objname (loc_id));
+	H5_RETURN (H5_SUCCESS);
+}
+
 static inline herr_t
 hdf5_delete_attribute (
         hid_t loc_id,
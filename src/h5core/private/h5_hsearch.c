@@ -1,23 +1,3 @@
-/* Copyright (C) 1993,1995-1997,2002,2005,2007,2008
-   Free Software Foundation, Inc.
-   This file is part of the GNU C Library.
-   Contributed by Ulrich Drepper <drepper@gnu.ai.mit.edu>, 1993.
-
-   The GNU C Library is free software; you can redistribute it and/or
-   modify it under the terms of the GNU Lesser General Public
-   License as published by the Free Software Foundation; either
-   version 2.1 of the License, or (at your option) any later version.
-
-   The GNU C Library is distributed in the hope that it will be useful,
-   but WITHOUT ANY WARRANTY; without even the implied warranty of
-   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
-   Lesser General Public License for more details.
-
-   You should have received a copy of the GNU Lesser General Public
-   License along with the GNU C Library; if not, write to the Free
-   Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
-   02111-1307 USA.  */
-
 /*
   Copyright (c) 2006-2016, The Regents of the University of California,
   through Lawrence Berkeley National Laboratory (subject to receipt of any
@@ -27,10 +7,30 @@
   License: see file COPYING in top level of source distribution.
 */
 
+/*
+  Open addressing hash table in the style of Swiss tables.
+
+  Each slot has a control byte, which is either CTRL_EMPTY,
+  CTRL_DELETED or the 7 lowest bits of the (mixed) hash value of the
+  entry stored in the slot. Slots are probed in aligned groups of
+  GROUP_SIZE control bytes, all bytes of a group are compared with the
+  hash tag at once (with SSE2 if available). The compare function is
+  only called for slots with matching tag. Groups are visited with
+  triangular probing, which visits all groups of a table with a power
+  of 2 number of groups.
+
+  The table grows automatically if more than 7/8 of the slots are used,
+  thus the size given to h5priv_hcreate() and h5priv_hgrow() is only a
+  hint to avoid rehashing when the number of entries is known.
+ */
+
 #include <errno.h>
 #include <string.h>
 #include <assert.h>
 #include <stddef.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "private/h5_log.h"
 #include "private/h5_hsearch.h"
@@ -38,42 +38,172 @@
 #include "h5core/h5_types.h"
 #include "h5core/h5_syscall.h"
 
+#define GROUP_SIZE	16
+#define CTRL_EMPTY	((uint8_t)0x80)
+#define CTRL_DELETED	((uint8_t)0xfe)
+#define NO_SLOT		((size_t)-1)
 
-/* [Aho,Sethi,Ullman] Compilers: Principles, Techniques and Tools, 1986
-   [Knuth]            The Art of Computer Programming, part 3 (6.4)  */
+/*
+  Mix the hash value computed by the user given function, the lowest
+  7 bits are used as tag, the remaining bits select the first group.
+ */
+static inline uint64_t
+mix_hash (
+	const unsigned int hval
+	) {
+	uint64_t h = hval;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
 
+static inline unsigned int
+lowest_bit (
+	const unsigned int mask
+	) {
+#ifdef __GNUC__
+	return (unsigned int)__builtin_ctz (mask);
+#else
+	unsigned int i = 0;
+	while (!(mask & (1u << i)))
+		i++;
+	return i;
+#endif
+}
 
-/* The reentrant version has no static variables to maintain the state.
-   Instead the interface of all functions is extended to take an argument
-   which describes the current status.  */
-typedef struct _ENTRY {
-	unsigned int used;
-	void* entry;
-} _ENTRY;
+/*
+  Bit mask of control bytes in group equal to given byte.
+ */
+static inline unsigned int
+match_byte (
+	const uint8_t* const group,
+	const uint8_t byte
+	) {
+#ifdef __SSE2__
+	__m128i ctrl = _mm_loadu_si128 ((const __m128i*)group);
+	return (unsigned int)_mm_movemask_epi8 (
+		_mm_cmpeq_epi8 (ctrl, _mm_set1_epi8 ((char)byte)));
+#else
+	unsigned int mask = 0;
+	for (unsigned int i = 0; i < GROUP_SIZE; i++)
+		mask |= (unsigned int)(group[i] == byte) << i;
+	return mask;
+#endif
+}
 
+/*
+  Bit mask of empty or deleted slots in group.
+ */
+static inline unsigned int
+match_free (
+	const uint8_t* const group
+	) {
+#ifdef __SSE2__
+	return (unsigned int)_mm_movemask_epi8 (
+		_mm_loadu_si128 ((const __m128i*)group));
+#else
+	unsigned int mask = 0;
+	for (unsigned int i = 0; i < GROUP_SIZE; i++)
+		mask |= (unsigned int)(group[i] >> 7) << i;
+	return mask;
+#endif
+}
 
-/* For the used double hash method the table size has to be a prime. To
-   correct the user given table size we need a prime test.  This trivial
-   algorithm is adequate because
-   a)  the code is (most probably) called a few times per program run and
-   b)  the number is small because the table must fit in the core  */
-static int
-isprime (const unsigned int number) {
-	/* no even number will be passed */
-	unsigned int div = 3;
+/*
+  Find slot of item. If the item is not in the table, NO_SLOT is returned
+  and the first free slot in the probe sequence is stored in free_slot.
+ */
+static inline size_t
+find_slot (
+	const h5_hashtable_t* const htab,
+	const void* const item,
+	const uint64_t hash,
+	size_t* const free_slot
+	) {
+	const uint8_t tag = (uint8_t)(hash & 0x7f);
+	const size_t mask = htab->size / GROUP_SIZE - 1;
+	size_t group = (size_t)(hash >> 7) & mask;
+	*free_slot = NO_SLOT;
+	for (size_t step = 1; step <= mask + 1; step++) {
+		const uint8_t* ctrl = htab->ctrl + group * GROUP_SIZE;
+		unsigned int match = match_byte (ctrl, tag);
+		while (match) {
+			size_t slot = group * GROUP_SIZE + lowest_bit (match);
+			if (htab->compare (item, htab->entries[slot]) == 0)
+				return slot;
+			match &= match - 1;
+		}
+		if (*free_slot == NO_SLOT) {
+			unsigned int free = match_free (ctrl);
+			if (free)
+				*free_slot = group * GROUP_SIZE + lowest_bit (free);
+		}
+		if (match_byte (ctrl, CTRL_EMPTY))
+			break;
+		group = (group + step) & mask;
+	}
+	return NO_SLOT;
+}
 
-	while (div * div < number && number % div != 0)
-		div += 2;
+/*
+  Number of slots needed for nel entries.
+ */
+static inline size_t
+table_size (
+	const size_t nel
+	) {
+	size_t size = GROUP_SIZE;
+	while (size - size / 8 < nel)
+		size <<= 1;
+	return size;
+}
 
-	return number % div != 0;
+/*
+  Move all entries into new arrays with given number of slots.
+ */
+static h5_err_t
+rehash (
+	h5_hashtable_t* const htab,
+	const size_t size
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "htab=%p, size=%zu", htab, size);
+	h5_hashtable_t new_htab = *htab;
+	new_htab.size = size;
+	new_htab.filled = 0;
+	new_htab.deleted = 0;
+	TRY (new_htab.ctrl = h5_alloc (NULL, size));
+	memset (new_htab.ctrl, CTRL_EMPTY, size);
+	TRY (new_htab.entries = h5_calloc (size, sizeof (new_htab.entries[0])));
+	const size_t mask = size / GROUP_SIZE - 1;
+	for (size_t i = 0; i < htab->size; i++) {
+		if (htab->ctrl[i] & 0x80)
+			continue;
+		void* entry = htab->entries[i];
+		uint64_t hash = mix_hash (htab->compute_hash (entry));
+		size_t group = (size_t)(hash >> 7) & mask;
+		unsigned int free;
+		for (size_t step = 1;
+		     (free = match_free (new_htab.ctrl + group * GROUP_SIZE)) == 0;
+		     step++) {
+			group = (group + step) & mask;
+		}
+		size_t slot = group * GROUP_SIZE + lowest_bit (free);
+		new_htab.ctrl[slot] = (uint8_t)(hash & 0x7f);
+		new_htab.entries[slot] = entry;
+		new_htab.filled++;
+	}
+	TRY (h5_free (htab->ctrl));
+	TRY (h5_free (htab->entries));
+	*htab = new_htab;
+	H5_RETURN (H5_SUCCESS);
 }
 
-/* Before using the hash table we must allocate memory for it.
-   Test for an existing table are done. We allocate one element
-   more as the found prime number says. This is done for more effective
-   indexing as explained in the comment for the hsearch function.
-   The contents of the table is zeroed, especially the field used
-   becomes zero.  */
+/*
+  Create hash table for about nel entries.
+ */
 h5_err_t
 h5priv_hcreate (
         size_t nel,
@@ -92,71 +222,35 @@ h5priv_hcreate (
 	if (htab == NULL) {
 		H5_LEAVE (h5_error_internal ());
 	}
-	/* Change nel to the first prime number not smaller as nel. */
-	nel |= 1;      /* make odd */
-	while (!isprime (nel))
-		nel += 2;
-
-	htab->size = nel;
-	htab->filled = 0;
+	memset (htab, 0, sizeof (*htab));
 	htab->compare = compare;
 	htab->compute_hash = compute_hash;
 	htab->free_entry = free_entry;
-
-	/* allocate memory and zero out */
-	TRY (htab->table = (_ENTRY *) h5_calloc (
-	             htab->size + 1, sizeof (_ENTRY)));
-
-	/* everything went alright */
+	TRY (rehash (htab, table_size (nel)));
 	H5_RETURN (H5_SUCCESS);
 }
 
 /*
-   Resize hash table. Actually we create a new hash table with the specified
-   size and copy the old data.
+   Make room for nel more entries. This is only required to avoid
+   repeated rehashing if the number of entries to add is known.
  */
 h5_err_t
 h5priv_hgrow (
-        size_t nel,             // number of entries to grow
+        size_t nel,             // number of entries to add
         h5_hashtable_t* htab    // hash table to resize
         ) {
 	H5_PRIV_API_ENTER (h5_err_t,
 	                   "nel=%llu, htab=%p",
 	                   (long long unsigned)nel, htab);
 	if (htab == NULL) {
-		h5_error_internal ();
+		H5_LEAVE (h5_error_internal ());
 	}
-	nel += htab->size; // new size
-
-	// create new hash table
-	h5_hashtable_t __htab;
-	memset (&__htab, 0, sizeof (__htab));
-	h5_debug ("Resize hash table from %zu to %zu elements.", htab->size, nel);
-	TRY (h5priv_hcreate (nel, &__htab, htab->compare,
-	                     htab->compute_hash, htab->free_entry));
-	if (htab->table != NULL) {
-		h5_debug ("New hash table created, filling ...");
-
-		// add all entries to new hash table
-		unsigned int idx;
-		for (idx = 1; idx <= htab->size; idx++) {
-			if (htab->table[idx].used) {
-				void* ventry;
-				TRY (h5priv_hsearch (
-				             htab->table[idx].entry,
-				             H5_ENTER,
-				             &ventry,
-				             &__htab));
-				if (idx % 1000000 == 0) {
-					h5_debug (".");
-				}
-			}
-		}
-		/* Free used memory.  */
-		TRY (h5_free (htab->table));
-		h5_debug ("Old hash table removed");
+	size_t size = table_size (htab->filled + nel);
+	if (size > htab->size) {
+		h5_debug ("Resize hash table from %zu to %zu slots.",
+			  htab->size, size);
+		TRY (rehash (htab, size));
 	}
-	*htab = __htab;
 	H5_RETURN (H5_SUCCESS);
 }
 
@@ -166,24 +260,29 @@ hwalk (
         h5_err_t (*visit)(const void *item)
         ) {
 	H5_PRIV_FUNC_ENTER (h5_err_t, "htab=%p, visit=%p", htab, visit);
-	unsigned int idx = 1;
-	for (idx = 1; idx < htab->size; idx++) {
-		if (htab->table[idx].used) {
-			TRY ((*visit)(&htab->table[idx].entry));
+	for (size_t idx = 0; idx < htab->size; idx++) {
+		if (!(htab->ctrl[idx] & 0x80)) {
+			TRY ((*visit)(&htab->entries[idx]));
 		}
 	}
 	H5_RETURN (H5_SUCCESS);
 }
 
+/*
+  Return next entry starting at position idx and advance idx. Start
+  with idx 1 (or 0), NULL is returned after the last entry. The table
+  must not be modified during traversal.
+ */
 void*
 h5priv_htraverse (
         struct hsearch_data* htab,
         unsigned int* idx
         ) {
-	assert (*idx > 0);
-	for (; *idx < htab->size; (*idx)++) {
-		if (htab->table[*idx].used) {
-			void* result = htab->table[*idx].entry;
+	if (*idx == 0)
+		*idx = 1;
+	for (; *idx <= htab->size; (*idx)++) {
+		if (!(htab->ctrl[*idx - 1] & 0x80)) {
+			void* result = htab->entries[*idx - 1];
 			(*idx)++;
 			return result;
 		}
@@ -191,7 +290,6 @@ h5priv_htraverse (
 	return NULL;
 }
 
-
 /* After using the hash table it has to be destroyed. The used memory can
    be freed and the local static variable can be marked as not used.  */
 h5_err_t
@@ -204,31 +302,32 @@ h5priv_hdestroy (
 		H5_LEAVE (h5_error_internal ());
 	}
 	/* Free used memory.  */
-	if (htab->free_entry) {
+	if (htab->free_entry && htab->ctrl) {
 		TRY (hwalk (htab, htab->free_entry));
 	}
-	TRY (h5_free (htab->table));
+	TRY (h5_free (htab->ctrl));
+	TRY (h5_free (htab->entries));
 
-	/* the sign for an existing table is an value != NULL in htable */
-	htab->table = NULL;
+	/* the sign for an existing table is an value != NULL in ctrl */
+	htab->ctrl = NULL;
+	htab->entries = NULL;
+	htab->size = 0;
+	htab->filled = 0;
+	htab->deleted = 0;
 	H5_RETURN (H5_SUCCESS);
 }
 
+/*
+  Search item in table.
 
+  H5_FIND:	return entry equal to item in retval
+  H5_ENTER:	like H5_FIND, if there is no such entry add item and
+		return it
+  H5_REMOVE:	like H5_FIND, remove entry found from table
 
-/* This is the search function. It uses double hashing with open addressing.
-   The argument item.key has to be a pointer to an zero terminated, most
-   probably strings of chars. The function for generating a number of the
-   strings is simple but fast. It can be replaced by a more complex function
-   like ajw (see [Aho,Sethi,Ullman]) if the needs are shown.
-
-   We use an trick to speed up the lookup. The table is created by hcreate
-   with one more element available. This enables us to use the index zero
-   special. This index will never be used because we store the first hash
-   index in the field used where zero means not used. Every other value
-   means used. The used field can be used as a first fast comparison for
-   equality of the stored and the parameter value. This helps to prevent
-   unnecessary expensive calls of strcmp.  */
+  If the item is not found (and not entered) H5_NOK is returned and
+  retval is set to NULL.
+ */
 h5_err_t
 h5priv_hsearch (
         void* item,
@@ -239,79 +338,48 @@ h5priv_hsearch (
 	H5_PRIV_API_ENTER (h5_err_t,
 	                   "item=%p, action=%d, retval=%p, htab=%p",
 	                   item, (int)action, retval, htab);
-	unsigned int hval;
-	unsigned int idx;
-
-	/* Compute an value for the given key. Perhaps use a better method. */
-	hval = htab->compute_hash(item);
-
-	/* First hash function: simply take the modul but prevent zero. */
-	idx = hval % htab->size + 1;
+	if (action == H5_ENTER &&
+	    (htab->filled + htab->deleted + 1) * 8 > htab->size * 7) {
+		// grow if mainly filled with entries, otherwise drop deleted
+		size_t size = htab->size;
+		if ((htab->filled + 1) * 16 > size * 7)
+			size <<= 1;
+		TRY (rehash (htab, size));
+	}
+	uint64_t hash = mix_hash (htab->compute_hash (item));
+	size_t free_slot = NO_SLOT;
+	size_t slot = htab->size > 0 ?
+		find_slot (htab, item, hash, &free_slot) : NO_SLOT;
 
-	if (htab->table[idx].used) {
-		/* Further action might be required according to the action
-		   value. */
-		if (htab->table[idx].used == hval
-		    && (htab->compare (item, htab->table[idx].entry) == 0) ) {
-			if (retval) {
-				*retval = htab->table[idx].entry;
-			}
-			H5_LEAVE (H5_SUCCESS);
+	if (slot != NO_SLOT) {
+		if (retval) {
+			*retval = htab->entries[slot];
 		}
-
-		/* Second hash function, as suggested in [Knuth] */
-		unsigned int hval2 = 1 + hval % (htab->size - 2);
-		unsigned int first_idx = idx;
-
-		do {
-			/* Because SIZE is prime this guarantees to step
-			   through all available indices.  */
-			if (idx <= hval2)
-				idx = htab->size + idx - hval2;
-			else
-				idx -= hval2;
-
-			/* If we visited all entries leave the loop
-			   unsuccessfully.  */
-			if (idx == first_idx)
-				break;
-
-			/* If entry is found use it. */
-			if (htab->table[idx].used == hval
-			    && (htab->compare (
-			                item, htab->table[idx].entry) == 0) ) {
-				if (retval) {
-					*retval = htab->table[idx].entry;
-				}
-				H5_LEAVE (H5_SUCCESS);
-			}
-		} while (htab->table[idx].used);
+		if (action == H5_REMOVE) {
+			htab->ctrl[slot] = CTRL_DELETED;
+			htab->entries[slot] = NULL;
+			htab->filled--;
+			htab->deleted++;
+		}
+		H5_LEAVE (H5_SUCCESS);
 	}
-
-	/* An empty bucket has been found. */
 	if (action == H5_ENTER) {
-		/* If table is full and another entry should be entered return
-		   with error.  */
-		if (htab->filled == htab->size) {
+		if (free_slot == NO_SLOT) {
 			if (retval) {
 				*retval = NULL;
 			}
 			H5_LEAVE (h5_error_internal ());
 		}
-
-		htab->table[idx].used  = hval;
-		htab->table[idx].entry = item;
-
-		++htab->filled;
-
+		if (htab->ctrl[free_slot] == CTRL_DELETED) {
+			htab->deleted--;
+		}
+		htab->ctrl[free_slot] = (uint8_t)(hash & 0x7f);
+		htab->entries[free_slot] = item;
+		htab->filled++;
 		if (retval) {
-			*retval = htab->table[idx].entry;
+			*retval = item;
 		}
 		H5_LEAVE (H5_SUCCESS);
-	} else if (action == H5_REMOVE) {
-		htab->table[idx].used = 0;              /* mark as unused, but */
-		*retval = htab->table[idx].entry;       /* return ptr to entry */
-		H5_LEAVE (H5_SUCCESS);
 	}
 	if (retval) *retval = NULL;
 	h5_debug ("Key not found in hash table.");
@@ -352,7 +420,7 @@ free_string_keyed (
         const void* __entry
         ) {
 	H5_PRIV_FUNC_ENTER (h5_err_t, "__entry=%p", __entry);
-	h5_hitem_string_keyed_t* entry = (h5_hitem_string_keyed_t*) __entry;
+	h5_hitem_string_keyed_t* entry = *(h5_hitem_string_keyed_t**) __entry;
 	TRY (h5_free (entry->key));
 	TRY (h5_free (entry));
 	H5_RETURN (H5_SUCCESS);
@@ -12,10 +12,16 @@
 
 #include "h5core/h5_types.h"
 
+/*
+  Open addressing hash table with one control byte per slot. Slots are
+  probed in groups of 16 control bytes, the table grows automatically.
+ */
 typedef struct hsearch_data {
-	struct _ENTRY *table;
-	size_t size;
-	size_t filled;
+	uint8_t* ctrl;		// control bytes: empty, deleted or hash tag
+	void** entries;
+	size_t size;		// number of slots, power of 2
+	size_t filled;		// number of entries
+	size_t deleted;		// number of slots of removed entries
 	int (*compare)(const void*, const void*);
 	unsigned int (*compute_hash)(const void*);
 	h5_err_t (*free_entry)(const void*);
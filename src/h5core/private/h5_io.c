@@ -80,12 +80,12 @@ h5priv_write_dataset_by_name (
 	TRY (memspace_id = (*set_memspace)(m, 0));
 	TRY (diskspace_id = (*set_diskspace)(m, dataspace_id));
 	TRY (h5priv_start_throttle (f));
-	TRY (hdf5_write_dataset (
+	TRY (h5priv_trace_write (
+	             f, __func__,
 	             dset_id,
 	             dsinfo->type_id,
 	             memspace_id,
 	             diskspace_id,
-	             f->props->xfer_prop,
 	             data));
 	TRY (h5priv_end_throttle (f));
 	TRY (hdf5_close_dataspace (diskspace_id));
@@ -137,14 +137,54 @@ h5priv_write_dataset_by_name_id (
 	}
 
 	TRY (h5priv_start_throttle (f));
-	TRY (hdf5_write_dataset (
+	TRY (h5priv_trace_write (
+	             f, __func__,
 	             dset_id,
 	             dsinfo->type_id,
 	             memspace_id,
 	             diskspace_id,
-	             f->props->xfer_prop,
 	             data));
 	TRY (h5priv_end_throttle (f));
 
 	H5_RETURN (H5_SUCCESS);
 }
+
+/*!
+   Get file offset and size of the raw data of a dataset which can be
+   accessed directly, i.e. bypassing HDF5.
+
+   Result:
+   TRUE		if the dataset is stored contiguously - thus unfiltered -,
+		storage has been allocated and the stored type doesn't
+		need conversion to the corresponding native type.
+   FALSE	otherwise
+   H5_FAILURE	on error
+ */
+h5_err_t
+h5priv_get_contiguous_storage (
+	const hid_t dataset,
+	haddr_t* const offset,
+	h5_ssize_t* const size
+	) {
+	H5_PRIV_API_ENTER (h5_err_t,
+			   "dataset=%lld (%s), offset=%p, size=%p",
+			   (long long int)dataset, hdf5_get_objname (dataset),
+			   offset, size);
+	TRY (hdf5_get_dataset_offset (dataset, offset));
+	TRY (*size = hdf5_get_dataset_storage_size (dataset));
+	if (*offset == HADDR_UNDEF || *size == 0) {
+		H5_LEAVE (0);
+	}
+	hid_t type;
+	TRY (type = hdf5_get_dataset_type (dataset));
+	H5T_class_t tclass;
+	TRY (tclass = hdf5_get_class_type (type));
+	h5_err_t is_native = 0;
+	if (tclass == H5T_INTEGER || tclass == H5T_FLOAT) {
+		hid_t ntype;
+		TRY (ntype = h5priv_normalize_type (type));
+		TRY (is_native = hdf5_is_equal_type (type, ntype));
+	}
+	TRY (hdf5_close_type (type));
+	H5_RETURN (is_native);
+}
@@ -61,4 +61,8 @@ h5priv_normalize_dataset_name (
 	char* const name
 	);
 
+h5_err_t
+h5priv_get_contiguous_storage (
+	const hid_t, haddr_t* const, h5_ssize_t* const);
+
 #endif
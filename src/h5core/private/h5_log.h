@@ -14,12 +14,26 @@
 #include "h5core/h5_log.h"
 #include "private/h5_init.h"
 
+/*
+  With NDEBUG or H5_NO_PRIVATE_TRACE defined, core and private functions
+  don't touch the call stack and the debug mask at all. Only the public
+  API entry keeps its bookkeeping, so error messages still report the
+  API function called by the user. __log__ is a compile time constant
+  in this case and the logging code in H5_RETURN() is removed by the
+  compiler.
+ */
 #if defined(NDEBUG)
 
 #define __FUNC_ENTER(type, mask, fmt, ...)	\
 	type ret_value = (type)H5_ERR;
 
-#else   // NDEBUG not defined
+#elif defined(H5_NO_PRIVATE_TRACE)
+
+#define __FUNC_ENTER(type, mask, fmt, ...)	\
+	type ret_value = (type)H5_ERR;		\
+	const int __log__ = 0;
+
+#else   // NDEBUG and H5_NO_PRIVATE_TRACE not defined
 
 #define __FUNC_ENTER(type, mask, fmt, ...)				\
 	type ret_value = (type)H5_ERR;					\
@@ -49,7 +63,7 @@
 
 #else
 #define H5_INLINE_FUNC_ENTER(type)			\
-	type ret_value = (type)H5_ERR; int __log__ = 0;
+	type ret_value = (type)H5_ERR; const int __log__ = 0;
 #endif
 	
 #define HDF5_WRAPPER_ENTER(type, fmt, ...)			\
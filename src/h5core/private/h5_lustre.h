@@ -12,8 +12,10 @@
 
 #include "h5core/h5_types.h"
 
+#ifdef H5_USE_LUSTRE
 h5_err_t
-h5_optimize_for_lustre (
-	const h5_file_t, const char*);
+h5priv_get_lustre_stripe_info (
+	const char* const, h5_int64_t* const, h5_int64_t* const);
+#endif
 
 #endif
@@ -159,6 +159,86 @@ h5priv_remove_strlist (
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/*
+  Global to local index maps.
+
+  The items of a map are kept sorted by global index, since callers
+  iterate over them in this order. Maps with at least
+  IDXMAP_HASH_THRESHOLD items get an additional open addressing hash
+  index with linear probing when they are sorted. The hash index is
+  used as long as the number of items doesn't change, otherwise
+  lookups fall back to binary search. Code modifying the items
+  directly must call h5priv_sort_idxmap() afterwards, like before.
+ */
+#define IDXMAP_HASH_THRESHOLD	1024
+
+static inline h5_size_t
+hash_slot (
+	const h5_glb_idx_t glb_idx,
+	const h5_size_t mask
+	) {
+	return (((uint64_t)glb_idx * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+static inline int
+hash_is_valid (
+	const h5_idxmap_t* const map
+	) {
+	return map->hash != NULL && map->hash_items == map->num_items;
+}
+
+/*
+  Return position of global index in map or -1 using the hash index.
+ */
+static inline h5_loc_idx_t
+hash_lookup (
+	const h5_idxmap_t* const map,
+	const h5_glb_idx_t glb_idx
+	) {
+	h5_size_t mask = map->hash_size - 1;
+	h5_size_t slot = hash_slot (glb_idx, mask);
+	h5_loc_idx_t pos;
+	while ((pos = map->hash[slot]) != 0) {
+		if (map->items[pos-1].glb_idx == glb_idx)
+			return pos - 1;
+		slot = (slot + 1) & mask;
+	}
+	return -1;
+}
+
+static h5_err_t
+build_hash (
+	h5_idxmap_t* const map
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "map=%p", map);
+	if (map->num_items < IDXMAP_HASH_THRESHOLD) {
+		TRY (h5_free (map->hash));
+		map->hash = NULL;
+		map->hash_size = 0;
+		H5_LEAVE (H5_SUCCESS);
+	}
+	// load factor <= 0.5
+	h5_size_t hash_size = IDXMAP_HASH_THRESHOLD;
+	while (hash_size < 2 * map->num_items)
+		hash_size <<= 1;
+	if (hash_size != map->hash_size) {
+		TRY (h5_free (map->hash));
+		TRY (map->hash = h5_calloc (hash_size, sizeof (map->hash[0])));
+		map->hash_size = hash_size;
+	} else {
+		memset (map->hash, 0, hash_size * sizeof (map->hash[0]));
+	}
+	h5_size_t mask = hash_size - 1;
+	for (h5_size_t i = 0; i < map->num_items; i++) {
+		h5_size_t slot = hash_slot (map->items[i].glb_idx, mask);
+		while (map->hash[slot] != 0)
+			slot = (slot + 1) & mask;
+		map->hash[slot] = (h5_loc_idx_t)(i + 1);
+	}
+	map->hash_items = map->num_items;
+	H5_RETURN (H5_SUCCESS);
+}
+
 h5_err_t
 h5priv_new_idxmap (
         h5_idxmap_t* map,
@@ -170,6 +250,20 @@ h5priv_new_idxmap (
 	TRY (map->items = h5_calloc (size, sizeof (map->items[0])));
 	map->size = size;
 	map->num_items = 0;
+	map->hash = NULL;
+	map->hash_size = 0;
+	map->hash_items = 0;
+	H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5priv_free_idxmap (
+        h5_idxmap_t* map
+        ) {
+	H5_PRIV_API_ENTER (h5_err_t, "map=%p", map);
+	TRY (h5_free (map->items));
+	TRY (h5_free (map->hash));
+	memset (map, 0, sizeof (*map));
 	H5_RETURN (H5_SUCCESS);
 }
 
@@ -206,11 +300,31 @@ h5priv_insert_idxmap (
 	H5_RETURN (H5_SUCCESS);
 }
 
+static inline h5_loc_idx_t
+bsearch_idxmap (
+        const h5_idxmap_t* const map,
+        const h5_glb_idx_t value
+        ) {
+	register h5_loc_idx_t low = 0;
+	register h5_loc_idx_t high = map->num_items - 1;
+	while (low <= high) {
+		register h5_loc_idx_t mid = (low + high) / 2;
+		register h5_glb_idx_t diff = map->items[mid].glb_idx - value;
+		if ( diff > 0 )
+			high = mid - 1;
+		else if ( diff < 0 )
+			low = mid + 1;
+		else
+			return mid;  // found
+	}
+	return -(low+1);  // not found
+}
+
 /*!
 
    \ingroup h5_core
 
-   binary search in id map.
+   search in id map.
 
    \return index in array if found, othwise \c -(result+1) is the index
    where \c value must be inserted.
@@ -224,48 +338,94 @@ h5priv_search_idxmap (
 	H5_PRIV_API_ENTER (h5_err_t,
 	                   "map=%p, value=%lld",
 	                   map, (long long)value);
-	register h5_loc_idx_t low = 0;
-	register h5_loc_idx_t high = map->num_items - 1;
-	while (low <= high) {
-		register h5_loc_idx_t mid = (low + high) / 2;
-		register h5_glb_idx_t diff = map->items[mid].glb_idx - value;
-		if ( diff > 0 )
-			high = mid - 1;
-		else if ( diff < 0 )
-			low = mid + 1;
-		else
-			H5_LEAVE (mid);  // found
+	if (hash_is_valid (map)) {
+		h5_loc_idx_t pos = hash_lookup (map, value);
+		if (pos >= 0)
+			H5_LEAVE (pos);
 	}
-	H5_RETURN (-(low+1));  // not found
+	// not found or no hash index: compute insert position
+	H5_RETURN (bsearch_idxmap (map, value));
+}
+
+/*!
+
+   \ingroup h5_core
+
+   Lookup in id map without computing the insert position.
+
+   \return index in array if found, otherwise \c -1.
+
+ */
+h5_loc_idx_t
+h5priv_find_idxmap (
+        h5_idxmap_t* map,
+        h5_glb_idx_t value
+        ) {
+	H5_PRIV_API_ENTER (h5_err_t,
+	                   "map=%p, value=%lld",
+	                   map, (long long)value);
+	if (hash_is_valid (map)) {
+		H5_LEAVE (hash_lookup (map, value));
+	}
+	h5_loc_idx_t pos = bsearch_idxmap (map, value);
+	H5_RETURN (pos >= 0 ? pos : -1);
 }
 
-//static int
-//cmp_idxmap_items (
-//        const void* _item1,
-//        const void* _item2
-//        ) {
-//	h5_idxmap_el_t* item1 = (h5_idxmap_el_t*)_item1;
-//	h5_idxmap_el_t* item2 = (h5_idxmap_el_t*)_item2;
-//
-//	if (item1->glb_idx < item2->glb_idx) return -1;
-//	if (item1->glb_idx > item2->glb_idx) return 1;
-//
-//	return 0;
-//}
-static inline int  //faster version
+static int
 cmp_idxmap_items (
         const void* _item1,
         const void* _item2
         ) {
-	return ((h5_idxmap_el_t*)_item1)->glb_idx - ((h5_idxmap_el_t*)_item2)->glb_idx;
+	h5_glb_idx_t idx1 = ((h5_idxmap_el_t*)_item1)->glb_idx;
+	h5_glb_idx_t idx2 = ((h5_idxmap_el_t*)_item2)->glb_idx;
+	return (idx1 > idx2) - (idx1 < idx2);
 }
 
+/*
+  Sort map and rebuild hash index.
+
+  Maps are usually rebuilt by appending the items of new entities to a
+  sorted map. In this case only the appended items are sorted and
+  merged into the sorted part, which is O(n + k log k) instead of
+  O(n log n) for k new items.
+ */
 h5_err_t
 h5priv_sort_idxmap (
         h5_idxmap_t* map
         ) {
 	H5_PRIV_API_ENTER (h5_err_t, "map=%p", map);
-	qsort ( map->items, map->num_items, sizeof (map->items[0]),
-	        cmp_idxmap_items);
+	h5_size_t n = map->num_items;
+	h5_idxmap_el_t* items = map->items;
+
+	// length of sorted prefix
+	h5_size_t num_sorted = n > 0 ? 1 : 0;
+	while (num_sorted < n &&
+	       items[num_sorted-1].glb_idx <= items[num_sorted].glb_idx)
+		num_sorted++;
+
+	if (num_sorted < n / 2) {
+		qsort (items, n, sizeof (items[0]), cmp_idxmap_items);
+	} else if (num_sorted < n) {
+		h5_size_t k = n - num_sorted;
+		qsort (&items[num_sorted], k, sizeof (items[0]),
+		       cmp_idxmap_items);
+		if (items[num_sorted-1].glb_idx > items[num_sorted].glb_idx) {
+			// merge from the end, appended items in buffer
+			h5_idxmap_el_t* tail;
+			TRY (tail = h5_alloc (NULL, k * sizeof (tail[0])));
+			memcpy (tail, &items[num_sorted], k * sizeof (tail[0]));
+			h5_size_t i = num_sorted;
+			h5_size_t j = k;
+			h5_size_t dst = n;
+			while (j > 0) {
+				if (i > 0 && items[i-1].glb_idx > tail[j-1].glb_idx)
+					items[--dst] = items[--i];
+				else
+					items[--dst] = tail[--j];
+			}
+			TRY (h5_free (tail));
+		}
+	}
+	TRY (build_hash (map));
 	H5_RETURN (H5_SUCCESS);
 }
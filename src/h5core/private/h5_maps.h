@@ -195,6 +195,11 @@ h5priv_grow_idxmap (
 	H5_RETURN (H5_SUCCESS);
 }
 
+h5_err_t
+h5priv_free_idxmap (
+        h5_idxmap_t *map
+        );
+
 h5_err_t
 h5priv_insert_idxmap (
         h5_idxmap_t *map,
@@ -208,6 +213,12 @@ h5priv_search_idxmap (
         h5_glb_idx_t value
         );
 
+h5_loc_idx_t
+h5priv_find_idxmap (
+        h5_idxmap_t *map,
+        h5_glb_idx_t value
+        );
+
 h5_err_t
 h5priv_sort_idxmap (
         h5_idxmap_t *map
@@ -0,0 +1,250 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+/*
+  Zero-copy read access to datasets of read-only files.
+
+  On first use the whole file is mapped read-only and shared, so
+  processes on the same node inspecting the same file share the page
+  cache. For a contiguous dataset whose type needs no conversion a
+  pointer into the mapping is returned. All other datasets are read
+  into a buffer, which is tracked here and released on unmapping.
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "h5core/h5_syscall.h"
+
+#include "private/h5_file.h"
+#include "private/h5_hdf5.h"
+#include "private/h5_io.h"
+#include "private/h5_model.h"
+#include "private/h5_mmap.h"
+
+struct h5_mmap_copy {
+	struct h5_mmap_copy* next;
+	void*		data;
+};
+
+struct h5_mmap {
+	char*		base;		// mapping of whole file or NULL
+	size_t		size;
+	struct h5_mmap_copy* copies;	// buffers of datasets read normally
+};
+
+static inline h5_err_t
+get_mmap (
+	const h5_file_p f
+	) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	if (f->mmap == NULL) {
+		TRY (f->mmap = h5_calloc (1, sizeof (*f->mmap)));
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
+static h5_err_t
+map_file (
+	const h5_file_p f
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "f=%p", f);
+	struct h5_mmap* m = f->mmap;
+	h5_ssize_t len;
+	TRY (len = hdf5_get_filename (f->file, NULL, 0));
+	char* filename;
+	TRY (filename = h5_calloc (1, len + 1));
+	TRY (hdf5_get_filename (f->file, filename, len + 1));
+	int fd = open (filename, O_RDONLY);
+	struct stat st;
+	void* base = MAP_FAILED;
+	int err = 0;
+	if (fd < 0 || fstat (fd, &st) < 0) {
+		err = errno;
+	} else {
+		base = mmap (NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		err = errno;
+	}
+	if (fd >= 0)
+		close (fd);
+	if (base == MAP_FAILED) {
+		TRY (h5_free (filename));
+		H5_RETURN_ERROR (
+			H5_ERR_INTERNAL,
+			"Cannot map file: %s",
+			strerror (err));
+	}
+	h5_info ("Mapped %lld bytes of file '%s'.",
+		 (long long)st.st_size, filename);
+	TRY (h5_free (filename));
+	m->base = base;
+	m->size = (size_t)st.st_size;
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Get pointer to the elements selected in 'diskspace' of a dataset.
+  Only a contiguous range of a one-dimensional dataset can be mapped.
+
+  Result:
+  TRUE		if dataset has been mapped
+  FALSE		if the dataset must be read with H5Dread()
+  H5_FAILURE	on error
+ */
+h5_err_t
+h5priv_map_dataset (
+	const h5_file_p f,
+	const hid_t dataset,
+	const hid_t type,
+	const hid_t diskspace,
+	const void** const ptr
+	) {
+	H5_PRIV_API_ENTER (h5_err_t,
+			   "f=%p, dataset=%lld, type=%lld, diskspace=%lld, ptr=%p",
+			   f, (long long)dataset, (long long)type,
+			   (long long)diskspace, ptr);
+	*ptr = NULL;
+	if (is_writable (f) || (f->props->flags & H5_VFD_CORE)) {
+		H5_LEAVE (0);
+	}
+	haddr_t offset;
+	h5_ssize_t size;
+	h5_err_t is_contiguous;
+	TRY (is_contiguous = h5priv_get_contiguous_storage (
+		     dataset, &offset, &size));
+	hid_t dtype;
+	TRY (dtype = h5priv_get_normalized_dataset_type (dataset));
+	if (!is_contiguous || dtype != type) {
+		H5_LEAVE (0);
+	}
+	h5_ssize_t type_size;
+	TRY (type_size = hdf5_get_sizeof_type (type));
+
+	hid_t space = diskspace;
+	if (space == H5S_ALL) {
+		TRY (space = hdf5_get_dataset_space (dataset));
+	}
+	hsize_t dims[H5S_MAX_RANK];
+	hsize_t start[H5S_MAX_RANK] = {0};
+	hsize_t end[H5S_MAX_RANK] = {0};
+	int rank;
+	h5_ssize_t npoints;
+	TRY (rank = hdf5_get_dims_of_dataspace (space, dims, NULL));
+	TRY (npoints = hdf5_get_selected_npoints_of_dataspace (space));
+	if (rank == 1 && npoints > 0) {
+		TRY (hdf5_get_selection_bounds (space, start, end));
+	}
+	if (space != diskspace) {
+		TRY (hdf5_close_dataspace (space));
+	}
+	if (rank != 1 || npoints == 0 ||
+	    end[0] - start[0] + 1 != (hsize_t)npoints) {
+		H5_LEAVE (0);
+	}
+	offset += start[0] * (hsize_t)type_size;
+	if (offset % (haddr_t)type_size != 0) {
+		// unaligned
+		H5_LEAVE (0);
+	}
+	TRY (get_mmap (f));
+	if (f->mmap->base == NULL) {
+		TRY (map_file (f));
+	}
+	if (offset + (haddr_t)(npoints * type_size) > f->mmap->size) {
+		H5_LEAVE (0);
+	}
+	*ptr = f->mmap->base + offset;
+	h5_debug ("Mapped dataset '%s' at offset %llu.",
+		  hdf5_get_objname (dataset), (unsigned long long)offset);
+	H5_RETURN (1);
+}
+
+/*
+  Track buffer of a dataset which couldn't be mapped.
+ */
+h5_err_t
+h5priv_add_mapped_copy (
+	const h5_file_p f,
+	void* const data
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "f=%p, data=%p", f, data);
+	TRY (get_mmap (f));
+	struct h5_mmap_copy* copy;
+	TRY (copy = h5_calloc (1, sizeof (*copy)));
+	copy->data = data;
+	copy->next = f->mmap->copies;
+	f->mmap->copies = copy;
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Release a pointer returned by h5priv_map_dataset() or a buffer added
+  with h5priv_add_mapped_copy(). The file itself stays mapped until it
+  is closed.
+ */
+h5_err_t
+h5priv_unmap_dataset (
+	const h5_file_p f,
+	const void* const data
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "f=%p, data=%p", f, data);
+	struct h5_mmap* m = f->mmap;
+	if (data == NULL) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	if (m != NULL && m->base != NULL &&
+	    (const char*)data >= m->base &&
+	    (const char*)data < m->base + m->size) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	struct h5_mmap_copy** pc = m ? &m->copies : NULL;
+	while (pc && *pc && (*pc)->data != data)
+		pc = &(*pc)->next;
+	if (pc == NULL || *pc == NULL) {
+		H5_RETURN_ERROR (
+			H5_ERR_INVAL,
+			"%p has not been returned by mapping a dataset.",
+			data);
+	}
+	struct h5_mmap_copy* copy = *pc;
+	*pc = copy->next;
+	TRY (h5_free (copy->data));
+	TRY (h5_free (copy));
+	H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5priv_close_mmap (
+	const h5_file_p f
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "f=%p", f);
+	struct h5_mmap* m = f->mmap;
+	if (m == NULL) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	while (m->copies) {
+		struct h5_mmap_copy* copy = m->copies;
+		m->copies = copy->next;
+		TRY (h5_free (copy->data));
+		TRY (h5_free (copy));
+	}
+	if (m->base != NULL && munmap (m->base, m->size) < 0) {
+		H5_RETURN_ERROR (
+			H5_ERR_INTERNAL,
+			"Cannot unmap file: %s",
+			strerror (errno));
+	}
+	f->mmap = NULL;
+	TRY (h5_free (m));
+	H5_RETURN (H5_SUCCESS);
+}
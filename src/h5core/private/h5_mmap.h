@@ -0,0 +1,32 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+#ifndef __PRIVATE_H5_MMAP_H
+#define __PRIVATE_H5_MMAP_H
+
+#include "private/h5_types.h"
+
+h5_err_t
+h5priv_map_dataset (
+	const h5_file_p, const hid_t, const hid_t, const hid_t,
+	const void** const);
+
+h5_err_t
+h5priv_add_mapped_copy (
+	const h5_file_p, void* const);
+
+h5_err_t
+h5priv_unmap_dataset (
+	const h5_file_p, const void* const);
+
+h5_err_t
+h5priv_close_mmap (
+	const h5_file_p);
+
+#endif
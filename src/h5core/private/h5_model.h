@@ -30,6 +30,7 @@
 #include "private/h5_file.h"
 #include "private/h5_mpi.h"
 #include "private/h5_hdf5.h"
+#include "private/h5_trace.h"
 
 #ifdef H5_HAVE_PARALLEL
 static inline h5_err_t
@@ -52,6 +53,7 @@ h5priv_start_throttle (
 		}
 
 		int token = 1;
+		double start = f->trace ? MPI_Wtime () : 0.0;
 		h5_info (
 			"Throttling with factor = %lld",
 			(long long int)f->props->throttle);
@@ -70,6 +72,9 @@ h5priv_start_throttle (
 				     ) );
 		}
 		h5_debug ("throttle: received token");
+		if (f->trace) {
+			TRY (h5priv_trace_throttle (f, MPI_Wtime () - start));
+		}
 	}
 	H5_RETURN (H5_SUCCESS);
 }
@@ -14,6 +14,7 @@
 
 #include "h5core/h5_types.h"
 #include "h5core/h5_err.h"
+#include "h5core/h5_syscall.h"
 #include "private/h5_log.h"
 
 #define MPI_WRAPPER_ENTER(type, fmt, ...)				\
@@ -85,6 +86,174 @@ h5priv_mpi_alltoallv (
 	H5_RETURN (H5_SUCCESS);
 }
 
+static inline h5_err_t
+h5priv_mpi_ialltoall (
+        void* sendbuf,
+        const int sendcount,
+        const MPI_Datatype sendtype,
+        void* recvbuf,
+        const int recvcount,
+        const MPI_Datatype recvtype,
+        const MPI_Comm comm,
+        MPI_Request* request
+        ) {
+	MPI_WRAPPER_ENTER (h5_err_t,
+	                   "sendbuf=%p, sendcount=%d, sendtype=?, recvbuf=%p, "
+	                   "recvcount=%d, recvtype=?, comm=?, request=%p",
+	                   sendbuf, sendcount, recvbuf, recvcount, request);
+	int err = MPI_Ialltoall (
+	        sendbuf,
+	        sendcount,
+	        sendtype,
+	        recvbuf,
+	        recvcount,
+	        recvtype,
+	        comm,
+	        request);
+	if (err != MPI_SUCCESS)
+		H5_RETURN_ERROR (
+			H5_ERR_MPI,
+			"%s",
+			"Cannot start all to all communication");
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline h5_err_t
+h5priv_mpi_ialltoallv (
+        void* sendbuf,
+        int* sendcounts,
+        int* senddispls,
+        const MPI_Datatype sendtype,
+        void* recvbuf,
+        int* recvcounts,
+        int* recvdispls,
+        const MPI_Datatype recvtype,
+        const MPI_Comm comm,
+        MPI_Request* request
+        ) {
+	MPI_WRAPPER_ENTER (h5_err_t,
+	                   "sendbuf=%p, sendcounts=%p, senddispls=%p, sendtype=?, "
+	                   "recvbuf=%p, recvcounts=%p, recvdispls=%p, recvtype=?, "
+	                   "comm=?, request=%p",
+	                   sendbuf, sendcounts, senddispls,
+	                   recvbuf, recvcounts, recvdispls, request);
+	int err = MPI_Ialltoallv (
+	        sendbuf,
+	        sendcounts,
+	        senddispls,
+	        sendtype,
+	        recvbuf,
+	        recvcounts,
+	        recvdispls,
+	        recvtype,
+	        comm,
+	        request);
+	if (err != MPI_SUCCESS)
+		H5_RETURN_ERROR (
+			H5_ERR_MPI,
+			"%s",
+			"Cannot start all to all communication");
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline h5_err_t
+h5priv_mpi_test (
+        MPI_Request* request,
+        int* flag
+        ) {
+	MPI_WRAPPER_ENTER (h5_err_t, "request=%p, flag=%p", request, flag);
+	int err = MPI_Test (request, flag, MPI_STATUS_IGNORE);
+	if (err != MPI_SUCCESS)
+		H5_RETURN_ERROR (
+			H5_ERR_MPI,
+			"%s",
+			"Cannot test for completion of request");
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline h5_err_t
+h5priv_mpi_wait (
+        MPI_Request* request
+        ) {
+	MPI_WRAPPER_ENTER (h5_err_t, "request=%p", request);
+	int err = MPI_Wait (request, MPI_STATUS_IGNORE);
+	if (err != MPI_SUCCESS)
+		H5_RETURN_ERROR (
+			H5_ERR_MPI,
+			"%s",
+			"Cannot wait for completion of request");
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline h5_err_t
+h5priv_mpi_gather (
+        void* sendbuf,
+        const int sendcount,
+        const MPI_Datatype sendtype,
+        void* recvbuf,
+        const int recvcount,
+        const MPI_Datatype recvtype,
+        const int root,
+        const MPI_Comm comm
+        ) {
+	MPI_WRAPPER_ENTER (h5_err_t,
+	                   "sendbuf=%p, sendcount=%d, sendtype=?, "
+	                   "recvbuf=%p, recvcount=%d, recvtype=?, "
+	                   "root=%d, comm=?",
+	                   sendbuf, sendcount, recvbuf, recvcount, root);
+	int err = MPI_Gather (
+	        sendbuf,
+	        sendcount,
+	        sendtype,
+	        recvbuf,
+	        recvcount,
+	        recvtype,
+	        root,
+	        comm);
+	if (err != MPI_SUCCESS)
+		H5_RETURN_ERROR (
+			H5_ERR_MPI,
+			"%s",
+			"Cannot perform gather");
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline h5_err_t
+h5priv_mpi_gatherv (
+        void* sendbuf,
+        const int sendcount,
+        const MPI_Datatype sendtype,
+        void* recvbuf,
+        int* recvcounts,
+        int* recvdispls,
+        const MPI_Datatype recvtype,
+        const int root,
+        const MPI_Comm comm
+        ) {
+	MPI_WRAPPER_ENTER (h5_err_t,
+	                   "sendbuf=%p, sendcount=%d, sendtype=?, "
+	                   "recvbuf=%p, recvcounts=%p, recvdispls=%p, recvtype=?, "
+	                   "root=%d, comm=?",
+	                   sendbuf, sendcount,
+	                   recvbuf, recvcounts, recvdispls, root);
+	int err = MPI_Gatherv (
+	        sendbuf,
+	        sendcount,
+	        sendtype,
+	        recvbuf,
+	        recvcounts,
+	        recvdispls,
+	        recvtype,
+	        root,
+	        comm);
+	if (err != MPI_SUCCESS)
+		H5_RETURN_ERROR (
+			H5_ERR_MPI,
+			"%s",
+			"Cannot perform gather");
+	H5_RETURN (H5_SUCCESS);
+}
+
 // barrier
 static inline h5_err_t
 h5priv_mpi_barrier (
@@ -492,5 +661,58 @@ h5priv_mpi_cart_coords (
 	H5_RETURN (H5_SUCCESS);
 }
 
+/*
+  Gather arrays of records with fixed size from all procs on root. On
+  root *all is set to a new array with the records of all procs in
+  order of rank and *num_all to the number of records, the array must
+  be released with h5_free(). On the other procs *all is set to NULL
+  and *num_all to 0. Must be called by all procs.
+ */
+static inline h5_err_t
+h5priv_mpi_gather_recs (
+        const void* const recs,
+        const size_t num_recs,
+        const size_t rec_size,
+        void** const all,
+        size_t* const num_all,
+        const int root,
+        const MPI_Comm comm
+        ) {
+	MPI_WRAPPER_ENTER (h5_err_t,
+	                   "recs=%p, num_recs=%zu, rec_size=%zu, all=%p, "
+	                   "num_all=%p, root=%d, comm=?",
+	                   recs, num_recs, rec_size, all, num_all, root);
+	int nprocs;
+	int myproc;
+	TRY (h5priv_mpi_comm_size (comm, &nprocs));
+	TRY (h5priv_mpi_comm_rank (comm, &myproc));
+	int* counts = NULL;
+	int* displs = NULL;
+	int count = (int)(num_recs * rec_size);
+	*all = NULL;
+	*num_all = 0;
+	if (myproc == root) {
+		TRY (counts = h5_calloc (nprocs, sizeof (*counts)));
+		TRY (displs = h5_calloc (nprocs, sizeof (*displs)));
+	}
+	TRY (h5priv_mpi_gather (
+	             &count, 1, MPI_INT,
+	             counts, 1, MPI_INT, root, comm));
+	if (myproc == root) {
+		for (int i = 0; i < nprocs; i++) {
+			displs[i] = (int)(*num_all * rec_size);
+			*num_all += counts[i] / rec_size;
+		}
+		TRY (*all = h5_calloc (*num_all + 1, rec_size));
+	}
+	TRY (h5priv_mpi_gatherv (
+	             (void*)recs, count, MPI_BYTE,
+	             *all, counts, displs, MPI_BYTE,
+	             root, comm));
+	TRY (h5_free (counts));
+	TRY (h5_free (displs));
+	H5_RETURN (H5_SUCCESS);
+}
+
 #endif
 #endif
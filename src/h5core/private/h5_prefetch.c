@@ -0,0 +1,516 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+/*
+  Read-ahead of the next iteration.
+
+  Each time a dataset is read, the same dataset in the next iteration
+  is scheduled for prefetching. HDF5 is not thread-safe, therefore the
+  file offset and size of the raw data are determined on the main
+  thread. A background thread reads the raw bytes with pread() into a
+  library buffer. Only datasets with contiguous layout - which can't
+  be filtered - and a type which doesn't need conversion qualify.
+
+  When the prefetched dataset is read, the data is copied from the
+  buffer, selections are applied with H5Dgather()/H5Dscatter().
+
+  The background thread doesn't call HDF5 or H5hut functions.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "h5core/h5_syscall.h"
+
+#include "private/h5_file.h"
+#include "private/h5_hdf5.h"
+#include "private/h5_io.h"
+#include "private/h5_model.h"
+#include "private/h5_prefetch.h"
+
+#define PF_QUEUED	0
+#define PF_READING	1
+#define PF_DONE		2
+#define PF_FAILED	3
+
+struct h5_prefetch_buf {
+	struct h5_prefetch_buf* next;
+	char		path[256];	// dataset path relative to iteration
+	h5_int64_t	iteration_idx;
+	haddr_t		offset;		// file offset of raw data
+	size_t		size;		// size of raw data in bytes
+	void*		data;
+	int		state;
+};
+
+struct h5_prefetch {
+	int		fd;
+	h5_int64_t	mem_cap;	// max memory for buffers, 0: no limit
+	size_t		mem_used;
+	pthread_t	thread;
+	pthread_mutex_t	lock;
+	pthread_cond_t	cond;
+	struct h5_prefetch_buf* bufs;	// in order of scheduling
+	int		done;
+};
+
+static int
+read_all (
+	const int fd,
+	char* buf,
+	size_t size,
+	off_t offset
+	) {
+	while (size > 0) {
+		ssize_t n = pread (fd, buf, size, offset);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		if (n == 0)
+			return -1;
+		buf += n;
+		size -= (size_t)n;
+		offset += n;
+	}
+	return 0;
+}
+
+static void*
+reader (
+	void* arg
+	) {
+	struct h5_prefetch* p = (struct h5_prefetch*)arg;
+	pthread_mutex_lock (&p->lock);
+	while (1) {
+		struct h5_prefetch_buf* b = NULL;
+		while (!p->done) {
+			for (b = p->bufs; b && b->state != PF_QUEUED; b = b->next);
+			if (b)
+				break;
+			pthread_cond_wait (&p->cond, &p->lock);
+		}
+		if (p->done)
+			break;
+		b->state = PF_READING;
+		pthread_mutex_unlock (&p->lock);
+
+		int err = read_all (p->fd, b->data, b->size, (off_t)b->offset);
+
+		pthread_mutex_lock (&p->lock);
+		b->state = err ? PF_FAILED : PF_DONE;
+		pthread_cond_broadcast (&p->cond);
+	}
+	pthread_mutex_unlock (&p->lock);
+	return NULL;
+}
+
+static inline struct h5_prefetch_buf*
+lookup (
+	struct h5_prefetch* const p,
+	const h5_int64_t iteration_idx,
+	const char* const path
+	) {
+	pthread_mutex_lock (&p->lock);
+	struct h5_prefetch_buf* b;
+	for (b = p->bufs; b; b = b->next) {
+		if (b->iteration_idx == iteration_idx &&
+		    strcmp (b->path, path) == 0)
+			break;
+	}
+	pthread_mutex_unlock (&p->lock);
+	return b;
+}
+
+/*
+  Unlink buffer from list after the background thread is done with it.
+ */
+static inline h5_err_t
+release_buf (
+	struct h5_prefetch* const p,
+	struct h5_prefetch_buf* const b
+	) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	pthread_mutex_lock (&p->lock);
+	while (b->state == PF_READING)
+		pthread_cond_wait (&p->cond, &p->lock);
+	struct h5_prefetch_buf** pb = &p->bufs;
+	while (*pb != b)
+		pb = &(*pb)->next;
+	*pb = b->next;
+	p->mem_used -= b->size;
+	pthread_mutex_unlock (&p->lock);
+	TRY (h5_free (b->data));
+	TRY (h5_free (b));
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Get path of dataset relative to current iteration group. Returns
+  FALSE if the dataset is not in the current iteration.
+ */
+static inline h5_err_t
+get_relative_path (
+	const h5_file_p f,
+	const hid_t dataset,
+	char* const path,
+	const size_t len
+	) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	const char* name = hdf5_get_objname (dataset);
+	size_t n = strlen (f->iteration_name);
+	if (name[0] != '/' ||
+	    strncmp (name + 1, f->iteration_name, n) != 0 ||
+	    name[n+1] != '/' ||
+	    strlen (name + n + 2) >= len) {
+		H5_LEAVE (0);
+	}
+	strcpy (path, name + n + 2);
+	H5_RETURN (1);
+}
+
+/*
+  Check whether all groups in path and the object itself exist.
+ */
+static inline h5_err_t
+path_exists (
+	const hid_t loc_id,
+	char* const path
+	) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	h5_err_t exists = 1;
+	for (char* s = strchr (path + 1, '/'); s && exists > 0; s = strchr (s + 1, '/')) {
+		*s = '\0';
+		exists = hdf5_link_exists (loc_id, path);
+		*s = '/';
+	}
+	TRY (exists);
+	if (exists) {
+		TRY (exists = hdf5_link_exists (loc_id, path));
+	}
+	H5_RETURN (exists);
+}
+
+/*
+  Schedule prefetching of dataset 'path' in the next iteration.
+ */
+static h5_err_t
+schedule_next (
+	const h5_file_p f,
+	const char* const path
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "f=%p, path='%s'", f, path);
+	struct h5_prefetch* p = f->prefetch;
+	h5_int64_t iteration_idx = f->iteration_idx + 1;
+	if (lookup (p, iteration_idx, path)) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	char name[H5_ITERATION_NAME_LEN + 256];
+	snprintf (name, sizeof (name), "/%s#%0*lld/%s",
+		  f->props->prefix_iteration_name,
+		  f->props->width_iteration_idx,
+		  (long long)iteration_idx, path);
+	h5_err_t exists;
+	TRY (exists = path_exists (f->file, name));
+	if (!exists) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	hid_t dataset;
+	TRY (dataset = hdf5_open_dataset_by_name (f->file, name));
+	haddr_t offset;
+	h5_ssize_t size;
+	h5_err_t is_contiguous;
+	TRY (is_contiguous = h5priv_get_contiguous_storage (
+		     dataset, &offset, &size));
+	TRY (hdf5_close_dataset (dataset));
+	if (!is_contiguous) {
+		h5_debug ("Dataset '%s' doesn't qualify for prefetching.", name);
+		H5_LEAVE (H5_SUCCESS);
+	}
+	pthread_mutex_lock (&p->lock);
+	int exceeds = p->mem_cap > 0 &&
+		p->mem_used + (size_t)size > (size_t)p->mem_cap;
+	pthread_mutex_unlock (&p->lock);
+	if (exceeds) {
+		h5_debug ("Prefetching dataset '%s' would exceed memory cap.",
+			  name);
+		H5_LEAVE (H5_SUCCESS);
+	}
+	h5_debug ("Prefetching %lld bytes of dataset '%s'.",
+		  (long long)size, name);
+	struct h5_prefetch_buf* b;
+	TRY (b = h5_calloc (1, sizeof (*b)));
+	TRY (b->data = h5_alloc (NULL, size));
+	strcpy (b->path, path);
+	b->iteration_idx = iteration_idx;
+	b->offset = offset;
+	b->size = (size_t)size;
+	b->state = PF_QUEUED;
+
+	pthread_mutex_lock (&p->lock);
+	struct h5_prefetch_buf** pb = &p->bufs;
+	while (*pb)
+		pb = &(*pb)->next;
+	*pb = b;
+	p->mem_used += b->size;
+	pthread_cond_broadcast (&p->cond);
+	pthread_mutex_unlock (&p->lock);
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Copy the selected elements from the raw data of a dataset to the
+  selected elements in memory, like H5Dread() does. Returns FALSE if
+  the selection cannot be handled.
+ */
+static h5_err_t
+copy_selection (
+	const hid_t dataset,
+	const hid_t type,
+	const hid_t memspace,
+	const hid_t diskspace,
+	const void* const src,
+	void* const data
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t,
+			    "dataset=%lld, type=%lld, memspace=%lld, "
+			    "diskspace=%lld, src=%p, data=%p",
+			    (long long)dataset, (long long)type,
+			    (long long)memspace, (long long)diskspace,
+			    src, data);
+	hid_t fspace = diskspace;
+	if (fspace == H5S_ALL) {
+		TRY (fspace = hdf5_get_dataset_space (dataset));
+	}
+	hid_t mspace = (memspace == H5S_ALL) ? fspace : memspace;
+	h5_ssize_t nfile, nfile_sel, nmem, nmem_sel, type_size;
+	TRY (nfile = hdf5_get_npoints_of_dataspace (fspace));
+	TRY (nfile_sel = hdf5_get_selected_npoints_of_dataspace (fspace));
+	TRY (nmem = hdf5_get_npoints_of_dataspace (mspace));
+	TRY (nmem_sel = hdf5_get_selected_npoints_of_dataspace (mspace));
+	TRY (type_size = hdf5_get_sizeof_type (type));
+	size_t nbytes = (size_t)(nfile_sel * type_size);
+
+	h5_err_t copied = 0;
+	if (nfile_sel != nmem_sel) {
+		// let H5Dread() report the error
+	} else if (nfile_sel == nfile && nmem_sel == nmem) {
+		memcpy (data, src, nbytes);
+		copied = 1;
+	} else {
+#if H5_VERSION_GE(1,8,11)
+		if (nmem_sel == nmem) {
+			TRY (hdf5_gather_selection (fspace, src, type, nbytes, data));
+		} else {
+			void* buf;
+			TRY (buf = h5_alloc (NULL, nbytes));
+			TRY (hdf5_gather_selection (fspace, src, type, nbytes, buf));
+			TRY (hdf5_scatter_selection (buf, nbytes, type, mspace, data));
+			TRY (h5_free (buf));
+		}
+		copied = 1;
+#endif
+	}
+	if (fspace != diskspace) {
+		TRY (hdf5_close_dataspace (fspace));
+	}
+	H5_RETURN (copied);
+}
+
+/*
+  Start background reader if prefetching has been enabled via file
+  property. Prefetching is restricted to read-only files opened by a
+  single process.
+ */
+h5_err_t
+h5priv_start_prefetch (
+	const h5_file_p f,
+	const char* const filename
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "f=%p, filename='%s'", f, filename);
+	if (!(f->props->flags & H5_PREFETCH) || (f->props->flags & H5_VFD_CORE)) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	if (is_writable (f) || f->nprocs > 1) {
+		h5_info ("Prefetching is only done for files opened "
+			 "read-only by a single process.");
+		H5_LEAVE (H5_SUCCESS);
+	}
+	struct h5_prefetch* p;
+	TRY (p = h5_calloc (1, sizeof (*p)));
+	if ((p->fd = open (filename, O_RDONLY)) < 0) {
+		int err = errno;
+		TRY (h5_free (p));
+		H5_RETURN_ERROR (
+			H5_ERR_INTERNAL,
+			"Cannot open file '%s' for prefetching: %s",
+			filename, strerror (err));
+	}
+	p->mem_cap = f->props->prefetch_mem_cap;
+	pthread_mutex_init (&p->lock, NULL);
+	pthread_cond_init (&p->cond, NULL);
+	if (pthread_create (&p->thread, NULL, reader, p) != 0) {
+		H5_RETURN_ERROR (
+			H5_ERR_INTERNAL,
+			"%s",
+			"Cannot start prefetch thread");
+	}
+	h5_info ("Prefetching next iteration of file '%s', memory cap "
+		 "%lld bytes.", filename, (long long)p->mem_cap);
+	f->prefetch = p;
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Read dataset from prefetch buffer and schedule prefetching of the
+  same dataset in the next iteration.
+
+  Result:
+  1		if data has been copied from prefetch buffer
+  0		if the dataset must be read with H5Dread()
+  H5_FAILURE	on error
+ */
+h5_err_t
+h5priv_read_prefetched (
+	const h5_file_p f,
+	const hid_t dataset,
+	const hid_t type,
+	const hid_t memspace,
+	const hid_t diskspace,
+	void* const data
+	) {
+	H5_PRIV_API_ENTER (h5_err_t,
+			   "f=%p, dataset=%lld, type=%lld, memspace=%lld, "
+			   "diskspace=%lld, data=%p",
+			   f, (long long)dataset, (long long)type,
+			   (long long)memspace, (long long)diskspace, data);
+	struct h5_prefetch* p = f->prefetch;
+	char path[256];
+	h5_err_t in_iteration;
+	if (p == NULL) {
+		H5_LEAVE (0);
+	}
+	TRY (in_iteration = get_relative_path (f, dataset, path, sizeof (path)));
+	if (!in_iteration) {
+		H5_LEAVE (0);
+	}
+	TRY (schedule_next (f, path));
+
+	struct h5_prefetch_buf* b = lookup (p, f->iteration_idx, path);
+	if (b == NULL) {
+		H5_LEAVE (0);
+	}
+	pthread_mutex_lock (&p->lock);
+	while (b->state == PF_QUEUED || b->state == PF_READING)
+		pthread_cond_wait (&p->cond, &p->lock);
+	int state = b->state;
+	pthread_mutex_unlock (&p->lock);
+
+	h5_err_t copied = 0;
+	if (state == PF_DONE) {
+		// make sure the dataset hasn't been replaced in the meantime
+		haddr_t offset;
+		h5_ssize_t size;
+		h5_err_t is_contiguous;
+		TRY (is_contiguous = h5priv_get_contiguous_storage (
+			     dataset, &offset, &size));
+		hid_t dtype;
+		TRY (dtype = h5priv_get_normalized_dataset_type (dataset));
+		if (is_contiguous && offset == b->offset &&
+		    (size_t)size == b->size && dtype == type) {
+			TRY (copied = copy_selection (
+				     dataset, type, memspace, diskspace,
+				     b->data, data));
+		}
+		if (copied) {
+			h5_debug ("Read dataset '%s' from prefetch buffer.",
+				  hdf5_get_objname (dataset));
+		}
+	} else {
+		h5_warn ("Prefetching dataset '%s' failed.",
+			 hdf5_get_objname (dataset));
+	}
+	TRY (release_buf (p, b));
+	H5_RETURN (copied);
+}
+
+/*
+  Drop prefetched datasets not belonging to the current iteration.
+ */
+h5_err_t
+h5priv_prefetch_set_iteration (
+	const h5_file_p f
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "f=%p", f);
+	struct h5_prefetch* p = f->prefetch;
+	if (p == NULL) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	struct h5_prefetch_buf* stale = NULL;
+	pthread_mutex_lock (&p->lock);
+	struct h5_prefetch_buf** pb = &p->bufs;
+	while (*pb) {
+		struct h5_prefetch_buf* b = *pb;
+		if (b->iteration_idx == f->iteration_idx) {
+			pb = &b->next;
+			continue;
+		}
+		while (b->state == PF_READING)
+			pthread_cond_wait (&p->cond, &p->lock);
+		*pb = b->next;
+		p->mem_used -= b->size;
+		b->next = stale;
+		stale = b;
+	}
+	pthread_mutex_unlock (&p->lock);
+	while (stale) {
+		struct h5_prefetch_buf* b = stale;
+		stale = b->next;
+		TRY (h5_free (b->data));
+		TRY (h5_free (b));
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Stop background reader and release all buffers.
+ */
+h5_err_t
+h5priv_stop_prefetch (
+	const h5_file_p f
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "f=%p", f);
+	struct h5_prefetch* p = f->prefetch;
+	if (p == NULL) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	pthread_mutex_lock (&p->lock);
+	p->done = 1;
+	pthread_cond_broadcast (&p->cond);
+	pthread_mutex_unlock (&p->lock);
+	pthread_join (p->thread, NULL);
+	f->prefetch = NULL;
+
+	while (p->bufs) {
+		struct h5_prefetch_buf* b = p->bufs;
+		p->bufs = b->next;
+		TRY (h5_free (b->data));
+		TRY (h5_free (b));
+	}
+	close (p->fd);
+	pthread_mutex_destroy (&p->lock);
+	pthread_cond_destroy (&p->cond);
+	TRY (h5_free (p));
+	H5_RETURN (H5_SUCCESS);
+}
@@ -0,0 +1,423 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+/*
+  Burst buffer style staging with the CORE VFD.
+
+  The file is held in memory by the CORE VFD without backing store.
+  Each time an iteration has been completed, a copy of the in-memory
+  file image is handed to a background thread, which writes it to disk
+  - optionally to a node-local path first - and atomically replaces
+  the target file. Only the latest image is of interest, so an image
+  which has not been picked up by the writer yet is replaced by a newer
+  one.
+
+  Since every image contains the whole file, each completed iteration
+  costs a copy and a write of the whole file. Without memory cap the
+  in-memory file grows with every iteration and the total amount of
+  data written grows quadratically with the number of iterations. With
+  a memory cap, staging ends with the first iteration after which the
+  in-memory file exceeds the cap: the image is written synchronously,
+  the file is reopened from disk with the SEC2 VFD and subsequent
+  iterations are written directly. Thus the memory used is bounded by
+  about twice the cap - the in-memory file and one staged copy - plus
+  the data of one iteration.
+
+  The background thread doesn't call HDF5 or H5hut functions, errors
+  are reported by the next call on the main thread.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "h5core/h5_syscall.h"
+
+#include "private/h5_file.h"
+#include "private/h5_hdf5.h"
+#include "private/h5_staging.h"
+
+#define COPY_BUF_SIZE	(4*1024*1024)
+
+struct h5_staging {
+	char*		filename;	// target file
+	char*		local_path;	// node-local intermediate file or NULL
+	h5_int64_t	mem_cap;	// max size of in-memory file, 0: no limit
+	pthread_t	thread;
+	pthread_mutex_t	lock;
+	pthread_cond_t	cond;
+	void*		pending;	// image waiting to be written
+	size_t		pending_size;
+	size_t		inflight_size;	// size of image being written
+	int		done;		// no more images will be staged
+	int		err;		// errno of background writer, 0 if ok
+};
+
+static int
+write_all (
+	const int fd,
+	const char* buf,
+	size_t size
+	) {
+	while (size > 0) {
+		ssize_t n = write (fd, buf, size);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		buf += n;
+		size -= (size_t)n;
+	}
+	return 0;
+}
+
+static int
+write_image_file (
+	const char* const path,
+	const void* const buf,
+	const size_t size
+	) {
+	int fd = open (path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0)
+		return errno;
+	if (write_all (fd, buf, size) < 0 || fsync (fd) < 0) {
+		int err = errno;
+		close (fd);
+		return err;
+	}
+	return close (fd) < 0 ? errno : 0;
+}
+
+static int
+copy_file (
+	const char* const src,
+	const char* const dst
+	) {
+	int err = 0;
+	char* buf = malloc (COPY_BUF_SIZE);
+	if (buf == NULL)
+		return ENOMEM;
+	int in = open (src, O_RDONLY);
+	int out = open (dst, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (in < 0 || out < 0) {
+		err = errno;
+		goto cleanup;
+	}
+	ssize_t n;
+	while ((n = read (in, buf, COPY_BUF_SIZE)) != 0) {
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			err = errno;
+			goto cleanup;
+		}
+		if (write_all (out, buf, (size_t)n) < 0) {
+			err = errno;
+			goto cleanup;
+		}
+	}
+	if (fsync (out) < 0)
+		err = errno;
+cleanup:
+	if (in >= 0)
+		close (in);
+	if (out >= 0 && close (out) < 0 && err == 0)
+		err = errno;
+	free (buf);
+	return err;
+}
+
+/*
+  Write image to a temporary file next to the target file and rename
+  it, so the target file always contains a complete image.
+ */
+static int
+persist_image (
+	struct h5_staging* const s,
+	const void* const buf,
+	const size_t size
+	) {
+	int err;
+	size_t len = strlen (s->filename) + 16;
+	char tmp[len];
+	snprintf (tmp, len, "%s.staging", s->filename);
+	if (s->local_path) {
+		if ((err = write_image_file (s->local_path, buf, size)) != 0)
+			return err;
+		if ((err = copy_file (s->local_path, tmp)) != 0)
+			return err;
+	} else {
+		if ((err = write_image_file (tmp, buf, size)) != 0)
+			return err;
+	}
+	return rename (tmp, s->filename) < 0 ? errno : 0;
+}
+
+static void*
+writer (
+	void* arg
+	) {
+	struct h5_staging* s = (struct h5_staging*)arg;
+	pthread_mutex_lock (&s->lock);
+	while (1) {
+		while (s->pending == NULL && !s->done)
+			pthread_cond_wait (&s->cond, &s->lock);
+		if (s->pending == NULL)
+			break;
+		void* buf = s->pending;
+		size_t size = s->pending_size;
+		s->pending = NULL;
+		s->pending_size = 0;
+		s->inflight_size = size;
+		pthread_mutex_unlock (&s->lock);
+
+		int err = persist_image (s, buf, size);
+		free (buf);
+
+		pthread_mutex_lock (&s->lock);
+		s->inflight_size = 0;
+		if (err != 0 && s->err == 0)
+			s->err = err;
+		pthread_cond_broadcast (&s->cond);
+	}
+	pthread_mutex_unlock (&s->lock);
+	return NULL;
+}
+
+static inline h5_err_t
+check_writer_status (
+	struct h5_staging* const s
+	) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	pthread_mutex_lock (&s->lock);
+	int err = s->err;
+	s->err = 0;
+	pthread_mutex_unlock (&s->lock);
+	if (err != 0)
+		H5_RETURN_ERROR (
+			H5_ERR_INTERNAL,
+			"Cannot persist staged file '%s': %s",
+			s->filename, strerror (err));
+	H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5priv_start_staging (
+	const h5_file_p f,
+	const char* const filename
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "f=%p, filename='%s'", f, filename);
+	if (!(f->props->flags & H5_STAGE_ASYNC) || !is_writable (f)) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	struct h5_staging* s;
+	TRY (s = h5_calloc (1, sizeof (*s)));
+	TRY (s->filename = h5_strdup (filename));
+	if (f->props->stage_path) {
+		TRY (s->local_path = h5_strdup (f->props->stage_path));
+	}
+	s->mem_cap = f->props->stage_mem_cap;
+	pthread_mutex_init (&s->lock, NULL);
+	pthread_cond_init (&s->cond, NULL);
+	if (pthread_create (&s->thread, NULL, writer, s) != 0) {
+		H5_RETURN_ERROR (
+			H5_ERR_INTERNAL,
+			"%s",
+			"Cannot start staging thread");
+	}
+	h5_info ("Staging file '%s' in memory, memory cap %lld bytes.",
+		 filename, (long long)s->mem_cap);
+	f->staging = s;
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Stop staging after the in-memory file exceeded the memory cap: write
+  the image synchronously and reopen the file from disk, so subsequent
+  iterations are written directly. All objects in the file except the
+  root group must be closed.
+ */
+static h5_err_t
+continue_on_disk (
+	const h5_file_p f,
+	const ssize_t size
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "f=%p, size=%lld", f, (long long)size);
+	struct h5_staging* s = f->staging;
+	size_t len = strlen (s->filename) + 1;
+	char filename[len];
+	memcpy (filename, s->filename, len);
+
+	// a pending image would be superseded anyway, an image in flight
+	// must not overwrite the image written now
+	pthread_mutex_lock (&s->lock);
+	free (s->pending);
+	s->pending = NULL;
+	s->pending_size = 0;
+	while (s->inflight_size > 0)
+		pthread_cond_wait (&s->cond, &s->lock);
+	pthread_mutex_unlock (&s->lock);
+
+	h5_info ("File image of %lld bytes exceeds memory cap, "
+		 "continuing file '%s' on disk.", (long long)size, filename);
+	void* buf = malloc (size > 0 ? (size_t)size : 1);
+	if (buf == NULL)
+		H5_RETURN_ERROR (
+			H5_ERR_NOMEM,
+			"Cannot allocate %lld bytes for file image",
+			(long long)size);
+	if (hdf5_get_file_image (f->file, buf, size) < 0) {
+		free (buf);
+		H5_LEAVE (H5_ERR);
+	}
+	int err = persist_image (s, buf, size);
+	free (buf);
+	if (err != 0)
+		H5_RETURN_ERROR (
+			H5_ERR_INTERNAL,
+			"Cannot persist staged file '%s': %s",
+			filename, strerror (err));
+	TRY (h5priv_stop_staging (f));
+
+	TRY (hdf5_close_group (f->root_gid));
+	TRY (hdf5_close_file (f->file));
+	f->props->flags &= ~(H5_VFD_CORE | H5_STAGE_ASYNC);
+	TRY (hdf5_set_fapl_sec2 (f->props->access_prop));
+	if ((f->file = H5Fopen (
+		     filename, H5F_ACC_RDWR, f->props->access_prop)) < 0)
+		H5_RETURN_ERROR (
+			H5_ERR_HDF5,
+			"Cannot reopen file '%s'",
+			filename);
+	TRY (f->root_gid = hdf5_open_group (f->file, "/"));
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Hand a copy of the current in-memory file image to the background
+  writer. If the memory cap would be exceeded by the staged copies,
+  wait for the writer to finish.
+
+  If the in-memory file exceeds the memory cap, staging is stopped and
+  the file continues on disk, see continue_on_disk(). This is not
+  possible for the last image of the file or with objects other than
+  the root group open; the image is written synchronously then.
+ */
+h5_err_t
+h5priv_stage_file (
+	const h5_file_p f,
+	const int last
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "f=%p, last=%d", f, last);
+	struct h5_staging* s = f->staging;
+	if (s == NULL) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	TRY (check_writer_status (s));
+	TRY (hdf5_flush (f->file, H5F_SCOPE_GLOBAL));
+	ssize_t size;
+	TRY (size = hdf5_get_file_image (f->file, NULL, 0));
+
+	size_t cap = (size_t)s->mem_cap;
+	if (cap > 0 && (size_t)size > cap && !last) {
+		ssize_t num_objs;
+		TRY (num_objs = hdf5_get_object_count (
+			     f->file, H5F_OBJ_ALL | H5F_OBJ_LOCAL));
+		// file and root group
+		if (num_objs <= 2) {
+			H5_LEAVE (continue_on_disk (f, size));
+		}
+		h5_debug ("%lld objects open in file '%s', "
+			  "cannot continue on disk.",
+			  (long long)num_objs, s->filename);
+	}
+	int sync = 0;
+	pthread_mutex_lock (&s->lock);
+	if (cap > 0) {
+		// drop pending image, it will be superseded anyway
+		free (s->pending);
+		s->pending = NULL;
+		s->pending_size = 0;
+		while (s->inflight_size > 0 &&
+		       s->inflight_size + (size_t)size > cap)
+			pthread_cond_wait (&s->cond, &s->lock);
+		sync = (size_t)size > cap;
+	}
+	pthread_mutex_unlock (&s->lock);
+
+	// images are released by the writer thread, which must not call
+	// H5hut functions: allocate them with the C library, not h5_alloc()
+	void* buf = malloc (size > 0 ? (size_t)size : 1);
+	if (buf == NULL)
+		H5_RETURN_ERROR (
+			H5_ERR_NOMEM,
+			"Cannot allocate %lld bytes for file image",
+			(long long)size);
+	if (hdf5_get_file_image (f->file, buf, size) < 0) {
+		free (buf);
+		H5_LEAVE (H5_ERR);
+	}
+	if (sync) {
+		h5_info ("File image of %lld bytes exceeds memory cap, "
+			 "writing synchronously.", (long long)size);
+		int err = persist_image (s, buf, size);
+		free (buf);
+		if (err != 0)
+			H5_RETURN_ERROR (
+				H5_ERR_INTERNAL,
+				"Cannot persist staged file '%s': %s",
+				s->filename, strerror (err));
+		H5_LEAVE (H5_SUCCESS);
+	}
+	pthread_mutex_lock (&s->lock);
+	if (s->pending) {
+		h5_debug ("Replacing pending image of %lld bytes.",
+			  (long long)s->pending_size);
+		free (s->pending);
+	}
+	s->pending = buf;
+	s->pending_size = size;
+	pthread_cond_broadcast (&s->cond);
+	pthread_mutex_unlock (&s->lock);
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Wait until the last staged image has been written and stop the
+  background writer.
+ */
+h5_err_t
+h5priv_stop_staging (
+	const h5_file_p f
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "f=%p", f);
+	struct h5_staging* s = f->staging;
+	if (s == NULL) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	pthread_mutex_lock (&s->lock);
+	s->done = 1;
+	pthread_cond_broadcast (&s->cond);
+	pthread_mutex_unlock (&s->lock);
+	pthread_join (s->thread, NULL);
+	f->staging = NULL;
+
+	h5_err_t status = check_writer_status (s);
+	pthread_mutex_destroy (&s->lock);
+	pthread_cond_destroy (&s->cond);
+	TRY (h5_free (s->local_path));
+	TRY (h5_free (s->filename));
+	TRY (h5_free (s));
+	H5_RETURN (status);
+}
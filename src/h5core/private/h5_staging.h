@@ -0,0 +1,27 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+#ifndef __PRIVATE_H5_STAGING_H
+#define __PRIVATE_H5_STAGING_H
+
+#include "private/h5_types.h"
+
+h5_err_t
+h5priv_start_staging (
+	const h5_file_p, const char* const);
+
+h5_err_t
+h5priv_stage_file (
+	const h5_file_p, const int);
+
+h5_err_t
+h5priv_stop_staging (
+	const h5_file_p);
+
+#endif
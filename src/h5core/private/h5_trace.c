@@ -0,0 +1,532 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+/*
+  Per-operation I/O tracing.
+
+  Tracing is enabled with the file property set by
+  h5_set_prop_file_io_trace() or with the environment variable
+  H5HUT_IO_TRACE, which names the trace file and takes precedence over
+  the property. Each dataset read or write records the number of bytes
+  transferred, the time spent in HDF5, the time spent waiting for the
+  throttle token and - for collective transfers - the time spent
+  waiting for the other processes. The latter is measured with a
+  barrier before the transfer, thus load imbalance doesn't show up as
+  I/O time.
+
+  The trace is written when the file is closed. If the name of the
+  trace file contains "%d", each process writes all its records to
+  its own file, "%d" is replaced by the rank. Otherwise the records are
+  summarised per operation and dataset, gathered and written by the
+  first process with minimum, maximum and mean over all processes. The
+  format is CSV if the name ends with ".csv", JSON otherwise. The JSON
+  trace also contains the time the file has been open, the difference
+  to the time spent in dataset I/O is mostly metadata handling.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "h5core/h5_syscall.h"
+
+#include "private/h5_file.h"
+#include "private/h5_hdf5.h"
+#include "private/h5_mpi.h"
+#include "private/h5_qsort.h"
+#include "private/h5_trace.h"
+
+#define TRACE_ENV	"H5HUT_IO_TRACE"
+
+struct h5_trace_rec {
+	char		op[32];		// H5hut function doing the transfer
+	char		dataset[224];	// HDF5 path of dataset
+	h5_int64_t	write;		// 1: write, 0: read
+	h5_int64_t	calls;		// number of calls (summaries only)
+	h5_int64_t	bytes;		// bytes transferred
+	double		start;		// seconds since file has been opened
+	double		io;		// time in HDF5 read/write
+	double		throttle;	// time waiting for throttle token
+	double		sync;		// time waiting for other processes
+};
+
+struct h5_trace {
+	char*		path;		// trace file
+	double		t0;		// time file has been opened
+	double		throttle;	// not yet assigned throttle time
+	struct h5_trace_rec* recs;
+	size_t		num_recs;
+	size_t		size;
+};
+
+static inline double
+now (
+	void
+	) {
+#ifdef H5_HAVE_PARALLEL
+	return MPI_Wtime ();
+#else
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+#endif
+}
+
+h5_err_t
+h5priv_start_trace (
+	const h5_file_p f
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "f=%p", f);
+	const char* path = getenv (TRACE_ENV);
+	if (path == NULL || path[0] == '\0') {
+		if (!(f->props->flags & H5_IO_TRACE)) {
+			H5_LEAVE (H5_SUCCESS);
+		}
+		path = f->props->trace_path;
+	}
+	struct h5_trace* t;
+	TRY (t = h5_calloc (1, sizeof (*t)));
+	TRY (t->path = h5_strdup (path));
+	t->t0 = now ();
+	f->trace = t;
+	h5_info ("Tracing I/O to '%s'.", path);
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Account time spent waiting for the throttle token to the next
+  transfer.
+ */
+h5_err_t
+h5priv_trace_throttle (
+	const h5_file_p f,
+	const double seconds
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "f=%p, seconds=%f", f, seconds);
+	if (f->trace) {
+		f->trace->throttle += seconds;
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline h5_int64_t
+get_num_bytes (
+	const hid_t dset_id,
+	const hid_t type_id,
+	const hid_t memspace_id,
+	const hid_t diskspace_id
+	) {
+	H5_INLINE_FUNC_ENTER (h5_int64_t);
+	h5_ssize_t npoints;
+	if (memspace_id != H5S_ALL) {
+		TRY (npoints = hdf5_get_selected_npoints_of_dataspace (
+			     memspace_id));
+	} else if (diskspace_id != H5S_ALL) {
+		TRY (npoints = hdf5_get_selected_npoints_of_dataspace (
+			     diskspace_id));
+	} else {
+		hid_t space_id;
+		TRY (space_id = hdf5_get_dataset_space (dset_id));
+		TRY (npoints = hdf5_get_npoints_of_dataspace (space_id));
+		TRY (hdf5_close_dataspace (space_id));
+	}
+	h5_ssize_t type_size;
+	TRY (type_size = hdf5_get_sizeof_type (type_id));
+	H5_RETURN (npoints * type_size);
+}
+
+static h5_err_t
+begin_rec (
+	const h5_file_p f,
+	const char* const op,
+	const int write,
+	const hid_t dset_id,
+	const hid_t type_id,
+	const hid_t memspace_id,
+	const hid_t diskspace_id
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t,
+			    "f=%p, op='%s', write=%d, dset_id=%lld",
+			    f, op, write, (long long int)dset_id);
+	struct h5_trace* t = f->trace;
+	if (t->num_recs == t->size) {
+		size_t size = t->size ? 2 * t->size : 256;
+		TRY (t->recs = h5_alloc (t->recs, size * sizeof (t->recs[0])));
+		t->size = size;
+	}
+	struct h5_trace_rec* r = &t->recs[t->num_recs];
+	memset (r, 0, sizeof (*r));
+	strncpy (r->op, op, sizeof (r->op) - 1);
+	strncpy (r->dataset, hdf5_get_objname (dset_id), sizeof (r->dataset) - 1);
+	r->write = write;
+	r->calls = 1;
+	TRY (r->bytes = get_num_bytes (
+		     dset_id, type_id, memspace_id, diskspace_id));
+	r->throttle = t->throttle;
+	t->throttle = 0;
+	r->start = now () - t->t0;
+#ifdef H5_HAVE_PARALLEL
+	if (f->nprocs > 1 && (f->props->flags & H5_VFD_MPIO_COLLECTIVE)) {
+		TRY (h5priv_mpi_barrier (f->props->comm));
+		r->sync = now () - t->t0 - r->start;
+	}
+#endif
+	H5_RETURN (H5_SUCCESS);
+}
+
+static inline void
+end_rec (
+	const h5_file_p f,
+	const double start
+	) {
+	struct h5_trace* t = f->trace;
+	t->recs[t->num_recs].io = now () - start;
+	t->num_recs++;
+}
+
+/*
+  Read dataset with the transfer properties of the file and record
+  the operation if tracing is enabled.
+ */
+h5_err_t
+h5priv_trace_read (
+	const h5_file_p f,
+	const char* const op,		// name of calling function
+	const hid_t dset_id,
+	const hid_t type_id,
+	const hid_t memspace_id,
+	const hid_t diskspace_id,
+	void* const data
+	) {
+	H5_PRIV_API_ENTER (h5_err_t,
+			   "f=%p, op='%s', dset_id=%lld, type_id=%lld, "
+			   "memspace_id=%lld, diskspace_id=%lld, data=%p",
+			   f, op, (long long int)dset_id, (long long int)type_id,
+			   (long long int)memspace_id,
+			   (long long int)diskspace_id, data);
+	if (f->trace == NULL) {
+		H5_LEAVE (hdf5_read_dataset (
+				  dset_id, type_id, memspace_id, diskspace_id,
+				  f->props->xfer_prop, data));
+	}
+	TRY (begin_rec (
+		     f, op, 0, dset_id, type_id, memspace_id, diskspace_id));
+	double start = now ();
+	TRY (hdf5_read_dataset (
+		     dset_id, type_id, memspace_id, diskspace_id,
+		     f->props->xfer_prop, data));
+	end_rec (f, start);
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Write dataset with the transfer properties of the file and record
+  the operation if tracing is enabled.
+ */
+h5_err_t
+h5priv_trace_write (
+	const h5_file_p f,
+	const char* const op,		// name of calling function
+	const hid_t dset_id,
+	const hid_t type_id,
+	const hid_t memspace_id,
+	const hid_t diskspace_id,
+	const void* const data
+	) {
+	H5_PRIV_API_ENTER (h5_err_t,
+			   "f=%p, op='%s', dset_id=%lld, type_id=%lld, "
+			   "memspace_id=%lld, diskspace_id=%lld, data=%p",
+			   f, op, (long long int)dset_id, (long long int)type_id,
+			   (long long int)memspace_id,
+			   (long long int)diskspace_id, data);
+	if (f->trace == NULL) {
+		H5_LEAVE (hdf5_write_dataset (
+				  dset_id, type_id, memspace_id, diskspace_id,
+				  f->props->xfer_prop, data));
+	}
+	TRY (begin_rec (
+		     f, op, 1, dset_id, type_id, memspace_id, diskspace_id));
+	double start = now ();
+	TRY (hdf5_write_dataset (
+		     dset_id, type_id, memspace_id, diskspace_id,
+		     f->props->xfer_prop, data));
+	end_rec (f, start);
+	H5_RETURN (H5_SUCCESS);
+}
+
+static int
+cmp_recs (
+	const void* _a,
+	const void* _b
+	) {
+	const struct h5_trace_rec* a = (const struct h5_trace_rec*)_a;
+	const struct h5_trace_rec* b = (const struct h5_trace_rec*)_b;
+	int cmp = strcmp (a->dataset, b->dataset);
+	if (cmp == 0)
+		cmp = strcmp (a->op, b->op);
+	if (cmp == 0)
+		cmp = (int)(a->write - b->write);
+	return cmp;
+}
+
+static inline int
+same_key (
+	const struct h5_trace_rec* a,
+	const struct h5_trace_rec* b
+	) {
+	return cmp_recs (a, b) == 0;
+}
+
+/*
+  Sum up records with same operation and dataset. The records are
+  sorted in place, the number of summaries is returned.
+ */
+static size_t
+summarise (
+	struct h5_trace_rec* recs,
+	const size_t num_recs
+	) {
+	if (num_recs == 0)
+		return 0;
+	h5priv_qsort (recs, num_recs, sizeof (recs[0]), cmp_recs);
+	size_t n = 0;
+	for (size_t i = 1; i < num_recs; i++) {
+		struct h5_trace_rec* s = &recs[n];
+		if (same_key (s, &recs[i])) {
+			s->calls += recs[i].calls;
+			s->bytes += recs[i].bytes;
+			s->io += recs[i].io;
+			s->throttle += recs[i].throttle;
+			s->sync += recs[i].sync;
+		} else {
+			recs[++n] = recs[i];
+		}
+	}
+	return n + 1;
+}
+
+static void
+print_json_string (
+	FILE* file,
+	const char* s
+	) {
+	fputc ('"', file);
+	for (; *s; s++) {
+		if (*s == '"' || *s == '\\')
+			fputc ('\\', file);
+		fputc (*s, file);
+	}
+	fputc ('"', file);
+}
+
+static inline int
+is_csv (
+	const char* const path
+	) {
+	size_t len = strlen (path);
+	return len >= 4 && strcmp (path + len - 4, ".csv") == 0;
+}
+
+static h5_err_t
+write_recs (
+	const h5_file_p f,
+	const char* const path
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "f=%p, path='%s'", f, path);
+	FILE* file = fopen (path, "w");
+	if (file == NULL) {
+		H5_LEAVE (h5_warn ("Cannot open trace file '%s'.", path));
+	}
+	struct h5_trace* t = f->trace;
+	int csv = is_csv (path);
+	if (csv) {
+		fprintf (file, "rank,op,kind,dataset,bytes,start,io,throttle,sync\n");
+	} else {
+		fprintf (file, "{\n  \"rank\": %d,\n  \"nprocs\": %d,\n"
+			 "  \"elapsed\": %.9f,\n  \"records\": [",
+			 f->myproc, f->nprocs, now () - t->t0);
+	}
+	for (size_t i = 0; i < t->num_recs; i++) {
+		struct h5_trace_rec* r = &t->recs[i];
+		const char* kind = r->write ? "write" : "read";
+		if (csv) {
+			fprintf (file, "%d,%s,%s,%s,%lld,%.9f,%.9f,%.9f,%.9f\n",
+				 f->myproc, r->op, kind, r->dataset,
+				 (long long)r->bytes,
+				 r->start, r->io, r->throttle, r->sync);
+			continue;
+		}
+		fprintf (file, "%s\n    {\"op\": \"%s\", \"kind\": \"%s\", "
+			 "\"dataset\": ",
+			 i > 0 ? "," : "", r->op, kind);
+		print_json_string (file, r->dataset);
+		fprintf (file, ", \"bytes\": %lld, \"start\": %.9f, "
+			 "\"io\": %.9f, \"throttle\": %.9f, \"sync\": %.9f}",
+			 (long long)r->bytes,
+			 r->start, r->io, r->throttle, r->sync);
+	}
+	if (!csv) {
+		fprintf (file, "\n  ]\n}\n");
+	}
+	if (fclose (file) != 0) {
+		H5_LEAVE (h5_warn ("Cannot write trace file '%s'.", path));
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Write summaries of all processes. The summaries are sorted by key,
+  so we merge runs of equal keys.
+ */
+static h5_err_t
+write_summaries (
+	const h5_file_p f,
+	struct h5_trace_rec* sums,
+	const size_t num_sums,
+	const double elapsed
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "f=%p, sums=%p, num_sums=%zu, elapsed=%f",
+			    f, sums, num_sums, elapsed);
+	const char* path = f->trace->path;
+	FILE* file = fopen (path, "w");
+	if (file == NULL) {
+		H5_LEAVE (h5_warn ("Cannot open trace file '%s'.", path));
+	}
+	int csv = is_csv (path);
+	if (csv) {
+		fprintf (file, "op,kind,dataset,ranks,calls,bytes,"
+			 "io_min,io_max,io_mean,"
+			 "throttle_max,sync_max,sync_mean\n");
+	} else {
+		fprintf (file, "{\n  \"nprocs\": %d,\n  \"elapsed_max\": %.9f,\n"
+			 "  \"operations\": [",
+			 f->nprocs, elapsed);
+	}
+	size_t i = 0;
+	int first = 1;
+	while (i < num_sums) {
+		struct h5_trace_rec* s = &sums[i];
+		h5_int64_t ranks = 0, calls = 0, bytes = 0;
+		double io_min = s->io, io_max = s->io, io_sum = 0;
+		double throttle_max = 0, sync_max = 0, sync_sum = 0;
+		for (; i < num_sums && same_key (s, &sums[i]); i++) {
+			struct h5_trace_rec* r = &sums[i];
+			ranks++;
+			calls += r->calls;
+			bytes += r->bytes;
+			if (r->io < io_min) io_min = r->io;
+			if (r->io > io_max) io_max = r->io;
+			io_sum += r->io;
+			if (r->throttle > throttle_max) throttle_max = r->throttle;
+			if (r->sync > sync_max) sync_max = r->sync;
+			sync_sum += r->sync;
+		}
+		const char* kind = s->write ? "write" : "read";
+		if (csv) {
+			fprintf (file, "%s,%s,%s,%lld,%lld,%lld,"
+				 "%.9f,%.9f,%.9f,%.9f,%.9f,%.9f\n",
+				 s->op, kind, s->dataset,
+				 (long long)ranks, (long long)calls,
+				 (long long)bytes,
+				 io_min, io_max, io_sum / ranks,
+				 throttle_max, sync_max, sync_sum / ranks);
+			continue;
+		}
+		fprintf (file, "%s\n    {\"op\": \"%s\", \"kind\": \"%s\", "
+			 "\"dataset\": ",
+			 first ? "" : ",", s->op, kind);
+		print_json_string (file, s->dataset);
+		fprintf (file, ", \"ranks\": %lld, \"calls\": %lld, "
+			 "\"bytes\": %lld, "
+			 "\"io_min\": %.9f, \"io_max\": %.9f, \"io_mean\": %.9f, "
+			 "\"throttle_max\": %.9f, "
+			 "\"sync_max\": %.9f, \"sync_mean\": %.9f}",
+			 (long long)ranks, (long long)calls, (long long)bytes,
+			 io_min, io_max, io_sum / ranks,
+			 throttle_max, sync_max, sync_sum / ranks);
+		first = 0;
+	}
+	if (!csv) {
+		fprintf (file, "\n  ]\n}\n");
+	}
+	if (fclose (file) != 0) {
+		H5_LEAVE (h5_warn ("Cannot write trace file '%s'.", path));
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Gather summaries of all processes on the first process. Must be
+  called by all processes.
+ */
+static h5_err_t
+write_reduced (
+	const h5_file_p f
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "f=%p", f);
+	struct h5_trace* t = f->trace;
+	size_t num_sums = summarise (t->recs, t->num_recs);
+	struct h5_trace_rec* all = t->recs;
+	size_t num_all = num_sums;
+	double elapsed = now () - t->t0;
+#ifdef H5_HAVE_PARALLEL
+	if (f->nprocs > 1) {
+		double local = elapsed;
+		TRY (h5priv_mpi_allreduce_max (
+			     &local, &elapsed, 1, MPI_DOUBLE, f->props->comm));
+		TRY (h5priv_mpi_gather_recs (
+			     t->recs, num_sums, sizeof (*t->recs),
+			     (void**)&all, &num_all, 0, f->props->comm));
+		if (f->myproc == 0) {
+			h5priv_qsort (all, num_all, sizeof (*all), cmp_recs);
+		}
+	}
+#endif
+	if (f->myproc == 0) {
+		TRY (write_summaries (f, all, num_all, elapsed));
+	}
+	if (all != t->recs) {
+		TRY (h5_free (all));
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Write trace and stop tracing. Must be called by all processes.
+ */
+h5_err_t
+h5priv_stop_trace (
+	const h5_file_p f
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "f=%p", f);
+	struct h5_trace* t = f->trace;
+	if (t == NULL) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	const char* rank_fmt = strstr (t->path, "%d");
+	if (rank_fmt) {
+		size_t prefix_len = (size_t)(rank_fmt - t->path);
+		size_t size = strlen (t->path) + 16;
+		char* path;
+		TRY (path = h5_calloc (1, size));
+		snprintf (path, size, "%.*s%d%s",
+			  (int)prefix_len, t->path, f->myproc, rank_fmt + 2);
+		h5_err_t herr = write_recs (f, path);
+		TRY (h5_free (path));
+		TRY (herr);
+	} else {
+		TRY (write_reduced (f));
+	}
+	TRY (h5_free (t->recs));
+	TRY (h5_free (t->path));
+	TRY (h5_free (t));
+	f->trace = NULL;
+	H5_RETURN (H5_SUCCESS);
+}
@@ -0,0 +1,37 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+#ifndef __PRIVATE_H5_TRACE_H
+#define __PRIVATE_H5_TRACE_H
+
+#include "private/h5_types.h"
+
+h5_err_t
+h5priv_start_trace (
+	const h5_file_p);
+
+h5_err_t
+h5priv_trace_throttle (
+	const h5_file_p, const double);
+
+h5_err_t
+h5priv_trace_read (
+	const h5_file_p, const char* const,
+	const hid_t, const hid_t, const hid_t, const hid_t, void* const);
+
+h5_err_t
+h5priv_trace_write (
+	const h5_file_p, const char* const,
+	const hid_t, const hid_t, const hid_t, const hid_t, const void* const);
+
+h5_err_t
+h5priv_stop_trace (
+	const h5_file_p);
+
+#endif
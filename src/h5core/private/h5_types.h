@@ -35,6 +35,15 @@ struct h5_prop_file {                   // file property
         h5_int64_t align;               // HDF5 alignment
 	h5_int64_t increment;		// increment for core vfd
         h5_int64_t throttle;
+	h5_int64_t mdc_size;		// initial size of metadata cache
+	h5_int64_t page_size;		// file space page size, 0: no paging
+	h5_int64_t page_buf_size;	// size of page buffer
+	h5_int64_t stage_mem_cap;	// memory cap for staged file images
+	char*	stage_path;		// node-local path for staged file images
+	h5_int64_t prefetch_mem_cap;	// memory cap for prefetched datasets
+	h5_int64_t attach_compression;	// deflate level of attachments, 0: none
+	char*	trace_path;		// file to write I/O trace to
+	h5_int64_t mesh_partitioner;	// partitioner for distributed meshes
 #ifdef H5_HAVE_PARALLEL
         MPI_Comm comm;
 #endif
@@ -76,6 +85,11 @@ struct h5_file {
 
 	struct h5u_fdata *u;            // pointer to unstructured data
 	struct h5b_fdata *b;            // pointer to block data
+	struct h5_staging *staging;	// asynchronous write-back of core VFD
+	struct h5_prefetch *prefetch;	// read-ahead of next iteration
+	struct h5_mmap	*mmap;		// zero-copy read access
+	struct h5_attrib_cache *attrib_cache; // attribute info and small values
+	struct h5_trace *trace;		// per-operation I/O trace
 };
 
 struct h5_idxmap_el {
@@ -87,7 +101,10 @@ typedef struct h5_idxmap_el h5_idxmap_el_t;
 struct h5_idxmap {
 	h5_size_t	size;		/* allocated space in number of items */
 	h5_size_t	num_items;	/* stored items	*/
-	h5_idxmap_el_t*  items;
+	h5_idxmap_el_t*  items;		/* sorted by global index */
+	h5_size_t	hash_size;	/* number of slots in hash index */
+	h5_size_t	hash_items;	/* num_items when hash index was built */
+	h5_loc_idx_t*	hash;		/* position+1 of items, 0 if empty */
 };
 
 typedef struct {
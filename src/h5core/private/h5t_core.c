@@ -8,17 +8,37 @@
 #include "private/h5t_access.h"
 #include "private/h5t_err.h"
 
-h5_err_t
-h5tpriv_grow_te_htab (
-        h5t_mesh_t* const m,
-        size_t nel
-        );
-
-h5_err_t
-h5tpriv_grow_td_htab (
-        h5t_mesh_t* const m,
-        size_t nel
-        ) ;
+/*
+  Add ID to sorted list if not already in list. Adjacency lists are
+  allocated from the adjacency arena and released with it.
+ */
+static inline h5_err_t
+add_to_idlist (
+        h5_arena_t* const arena,
+        h5_loc_idlist_t** list,
+        const h5_loc_id_t id
+        ) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	h5_loc_idx_t idx = h5priv_find_in_loc_idlist (*list, id);
+	if (idx >= 0) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	idx = -(idx+1);
+	h5_loc_idlist_t* l = *list;
+	if (l == NULL || l->num_items == l->size) {
+		int32_t size = l ? 2*l->size : 2;
+		size_t old_bytes = l ? sizeof (*l) + (l->size-1)*sizeof (l->items[0]) : 0;
+		size_t num_bytes = sizeof (*l) + (size-1)*sizeof (l->items[0]);
+		TRY (l = h5priv_arena_realloc (arena, l, old_bytes, num_bytes));
+		l->size = size;
+		*list = l;
+	}
+	memmove (&l->items[idx+1], &l->items[idx],
+	         (l->num_items - idx) * sizeof (l->items[0]));
+	l->items[idx] = id;
+	l->num_items++;
+	H5_RETURN (H5_SUCCESS);
+}
 
 h5_err_t
 h5tpriv_enter_tv2 (
@@ -37,7 +57,8 @@ h5tpriv_enter_tv2 (
 	             face_idx, elem_idx,
 	             &vertex_idx));
 
-	TRY (h5priv_search_in_loc_idlist (
+	TRY (add_to_idlist (
+	             &m->adjacencies.arena,
 	             &m->adjacencies.tv.v[vertex_idx],
 	             h5tpriv_build_vertex_id (face_idx, elem_idx)));
 
@@ -61,31 +82,21 @@ h5tpriv_enter_te2 (
 	                   m, (long long)face_idx, (long long)elem_idx, idlist);
 	h5t_adjacencies_t* a = &m->adjacencies;
 	void* __retval;
-	static h5t_te_entry_t* entry = NULL;
-
-	if (entry == NULL) {
-		TRY (entry = h5_calloc (1, sizeof (*entry)));
-	}
+	h5t_te_entry_t* entry;
+	TRY (entry = h5priv_arena_alloc (&a->arena, sizeof (*entry)));
 	TRY (h5t_get_loc_vertex_indices_of_edge2 (
 	             m, face_idx, elem_idx, entry->key.vids));
-	/*
-	   resize hash table if more than 4/5 filled
-	 */
-	if ((a->te_hash.size*4) <= (a->te_hash.filled*5)) {
-		h5_debug ("Resize te-structure");
-		h5_loc_idx_t num_interior_elems = m->num_interior_elems[m->num_leaf_levels-1];
-		TRY (h5tpriv_grow_te_htab (m, 2*(num_interior_elems - elem_idx)+8192));
-	}
 	TRY (h5priv_hsearch (
 	             entry,
 	             H5_ENTER,
 	             &__retval,
 	             &a->te_hash));
 	h5t_te_entry_t* te_entry = (h5t_te_entry_t *)__retval;
-	if (entry == te_entry) {        // if used,
-		entry = NULL;           // force allocation of new entry
+	if (entry != te_entry) {        // key already in table
+		h5priv_arena_free (&a->arena, entry);
 	}
-	TRY (h5priv_search_in_loc_idlist (
+	TRY (add_to_idlist (
+	             &a->arena,
 	             &te_entry->value,
 	             h5tpriv_build_edge_id (face_idx, elem_idx)));
 
@@ -107,19 +118,10 @@ h5tpriv_enter_td2 (
 	                   m, (long long)face_idx, (long long)elem_idx, idlist);
 	h5t_adjacencies_t* a = &m->adjacencies;
 	void* __retval;
-	static h5t_td_entry_t* entry = NULL;
-
-	if (entry == NULL) {
-		TRY (entry = h5_calloc (1, sizeof(*entry)) );
-	}
+	h5t_td_entry_t* entry;
+	TRY (entry = h5priv_arena_alloc (&a->arena, sizeof (*entry)));
 	TRY (h5t_get_loc_vertex_indices_of_triangle2 (
 	             m, face_idx, elem_idx, entry->key.vids) );
-	/* resize hash table if more than 80% filled */
-	if ((a->td_hash.size*4) <= (a->td_hash.filled*5)) {
-		h5_debug ("Resize td-structure");
-		h5_loc_idx_t num_interior_elems = m->num_interior_elems[m->num_leaf_levels-1];
-		TRY (h5tpriv_grow_td_htab (m, 3*(num_interior_elems-elem_idx)));
-	}
 	/* search in hash, add if entry doesn't already exists */
 	TRY (h5priv_hsearch (
 	             entry,
@@ -127,12 +129,13 @@ h5tpriv_enter_td2 (
 	             &__retval,
 	             &a->td_hash));
 	h5t_td_entry_t *td_entry = (h5t_td_entry_t *)__retval;
-	if (entry == td_entry) { // if used:
-		entry = NULL;    // force allocation of new
+	if (entry != td_entry) {        // key already in table
+		h5priv_arena_free (&a->arena, entry);
 	}
 
 	/* search ID in list of IDs for given triangle */
-	TRY (h5priv_search_in_loc_idlist (
+	TRY (add_to_idlist (
+	             &a->arena,
 	             &td_entry->value,
 	             h5tpriv_build_triangle_id (face_idx, elem_idx)));
 	if (idlist) {
@@ -141,6 +144,22 @@ h5tpriv_enter_td2 (
 	H5_RETURN (H5_SUCCESS);
 }
 
+/*
+  Hash value of vertex indices of an edge or triangle. The hash table
+  mixes the result, thus combining the indices is sufficient.
+ */
+static inline unsigned int
+hash_vids (
+        const h5_loc_idx_t* const vids,
+        const int n
+        ) {
+	uint64_t hval = (uint64_t)n;
+	for (int i = 0; i < n; i++) {
+		hval = (hval ^ (uint64_t)vids[i]) * 0x100000001b3ULL;
+	}
+	return (unsigned int)(hval ^ (hval >> 32));
+}
+
 static int
 cmp_te_entries (
         const void* __a,
@@ -156,29 +175,7 @@ compute_te_hashval (
         const void* __item
         ) {
 	h5t_te_entry_t* item = (h5t_te_entry_t*)__item;
-	uint16_t* key =  (uint16_t*)item->key.vids;
-	unsigned int count = 2*sizeof (item->key.vids[0]) / sizeof (uint16_t);
-	unsigned int hval = count;
-	while (count--) {
-		if (*key) {
-			hval <<= 6;
-			hval += *key;
-		}
-		key++;
-	}
-	return hval;
-}
-
-static h5_err_t
-release_te_entry (
-        const void* __entry
-        ) {
-	H5_PRIV_FUNC_ENTER (h5_err_t, "__entry=%p", __entry);
-	struct h5_te_entry* entry = *(struct h5_te_entry**)__entry;
-	h5_loc_idlist_t* list = entry->value;
-	TRY (h5priv_free_loc_idlist (&list));
-	TRY (h5_free (entry));
-	H5_RETURN (H5_SUCCESS);
+	return hash_vids (item->key.vids, 2);
 }
 
 h5_err_t
@@ -195,7 +192,7 @@ h5tpriv_grow_te_htab (
 		             &a->te_hash,
 		             cmp_te_entries,
 		             compute_te_hashval,
-		             release_te_entry));
+		             NULL));
 	} else {
 		TRY (h5priv_hgrow (nel, &a->te_hash));
 	}
@@ -290,32 +287,9 @@ compute_td_hashval (
         const void* __item
         ) {
 	h5t_td_entry_t* item = (h5t_td_entry_t*)__item;
-	uint16_t* key =  (uint16_t*)item->key.vids;
-	unsigned int count = 3 * sizeof (item->key.vids[0]) / sizeof (uint16_t);
-	unsigned int hval = count;
-	while (count--) {
-		if (*key) {
-			hval <<= 6;
-			hval += *key;
-		}
-		key++;
-	}
-	return hval;
+	return hash_vids (item->key.vids, 3);
 }
 
-static h5_err_t
-release_td_entry (
-        const void* __entry
-        ) {
-	H5_PRIV_FUNC_ENTER (h5_err_t, "__entry=%p", __entry);
-	struct h5_td_entry* entry = *(struct h5_td_entry**)__entry;
-	h5_loc_idlist_t* list = entry->value;
-	TRY (h5priv_free_loc_idlist (&list));
-	TRY (h5_free (entry));
-	H5_RETURN (H5_SUCCESS);
-}
-
-
 h5_err_t
 h5tpriv_grow_td_htab (
         h5t_mesh_t* const m,
@@ -330,7 +304,7 @@ h5tpriv_grow_td_htab (
 		             &a->td_hash,
 		             cmp_td_entries,
 		             compute_td_hashval,
-		             release_td_entry));
+		             NULL));
 	} else {
 		TRY (h5priv_hgrow (nel, &a->td_hash));
 	}
@@ -69,6 +69,18 @@ h5tpriv_enter_tv2 (
         h5_loc_idlist_t** idlist        // out
         );
 
+h5_err_t
+h5tpriv_grow_te_htab (
+        h5t_mesh_t* const m,
+        size_t nel
+        );
+
+h5_err_t
+h5tpriv_grow_td_htab (
+        h5t_mesh_t* const m,
+        size_t nel
+        );
+
 h5_err_t
 h5tpriv_enter_te2 (
         h5t_mesh_t* const m,
@@ -175,6 +175,10 @@ update_internal_structs (
 	h5_loc_idx_t elem_idx = (from_lvl <= 0) ? 0 : m->num_interior_elems[from_lvl-1];
 	h5_loc_idx_t last = m->num_interior_elems[to_lvl] + m->num_ghost_elems[to_lvl];
 
+	/* make room for new edges, a triangle mesh has about 1.5 edges per
+	   element */
+	TRY (h5tpriv_grow_te_htab (m, 2 * (last - elem_idx)));
+
 	for (; elem_idx < last; elem_idx++) {
 		int face_idx;
 		// Compute upward adjacent elements for each vertex.
@@ -246,14 +250,7 @@ release_tv (
         ) {
 	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p", m);
 	h5t_adjacencies_t* adj = &m->adjacencies;
-	if (adj->tv.v == NULL)
-		H5_LEAVE (H5_SUCCESS);
-
-	h5_loc_idx_t vertex_idx = 0;
-	h5_loc_idx_t last = m->num_loc_vertices[m->num_loaded_levels-1];
-	for (; vertex_idx < last; vertex_idx++) {
-		TRY( h5priv_free_loc_idlist (&adj->tv.v[vertex_idx]) );
-	}
+	// ID lists are released with the arena
 	TRY( h5_free (adj->tv.v) );
 	adj->tv.v = NULL;
 	H5_RETURN (H5_SUCCESS);
@@ -266,6 +263,7 @@ release_internal_structs (
 	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p", m);
 	TRY( release_tv (m) );
 	TRY( h5priv_hdestroy (&m->adjacencies.te_hash) );
+	TRY( h5priv_release_arena (&m->adjacencies.arena, "adjacencies") );
 	memset (&m->adjacencies, 0, sizeof (m->adjacencies));
 	H5_RETURN (H5_SUCCESS);
 }
@@ -76,6 +76,7 @@ init_loc_elems_struct (
 		        num_facets,
 		        loc_elem->neighbor_indices);
 	}
+	m->last_stored_eid = from_idx + count -1;
 	H5_RETURN (H5_SUCCESS);
 }
 
@@ -154,7 +155,7 @@ init_map_elem_g2l (
 		item->loc_idx = i + offs;
 		map->num_items++;
 	}
-	h5priv_sort_idxmap (map);
+	TRY (h5priv_sort_idxmap (map));
 
 	H5_RETURN (H5_SUCCESS);
 }
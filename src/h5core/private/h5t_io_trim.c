@@ -149,7 +149,7 @@ init_map_elem_g2l (
 		item->loc_idx = i + offs;
 		map->num_items++;
 	}
-	h5priv_sort_idxmap (map);
+	TRY (h5priv_sort_idxmap (map));
 
 	H5_RETURN (H5_SUCCESS);
 }
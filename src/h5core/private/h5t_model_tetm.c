@@ -17,6 +17,7 @@
 #include "private/h5t_access.h"
 #include "private/h5t_adjacencies.h"
 #include "private/h5t_io.h"
+#include "private/h5t_profile.h"
 #include "private/h5t_retrieve.h"
 #include "private/h5t_store.h"
 
@@ -73,6 +74,8 @@ h5t_open_tetrahedral_mesh (
 
 	TRY (*mesh = h5_calloc (1, sizeof(**mesh)));
 	h5t_mesh_t* m = *mesh;
+	TRY (h5tpriv_profile_begin (m, "open_mesh"));
+	TRY (h5tpriv_profile_begin (m, "init_mesh"));
 	TRY (h5tpriv_init_mesh (
 	             m,
 	             f,
@@ -82,12 +85,16 @@ h5t_open_tetrahedral_mesh (
 	             &h5t_tet_ref_elem,
 	             &tet_funcs,
 	             0));
+	TRY (h5tpriv_profile_end (m, "init_mesh"));
+	TRY (h5tpriv_profile_begin (m, "read_mesh"));
 #ifdef WITH_PARALLEL_H5GRID  // reason: even if we have a chunked mesh, if h5hut is not parallel
 	// it does not support reading chunked meshes
 	TRY (m->is_chunked ? h5tpriv_read_chunked_mesh (m) :h5tpriv_read_mesh (m));
 #else
 	TRY (h5tpriv_read_mesh (m));
 #endif
+	TRY (h5tpriv_profile_end (m, "read_mesh"));
+	TRY (h5tpriv_profile_end (m, "open_mesh"));
 	H5_RETURN (H5_SUCCESS);
 }
 
@@ -110,6 +117,8 @@ h5t_open_tetrahedral_mesh_part (
 
 	TRY (*mesh = h5_calloc (1, sizeof(**mesh)));
 	h5t_mesh_t* m = *mesh;
+	TRY (h5tpriv_profile_begin (m, "open_mesh"));
+	TRY (h5tpriv_profile_begin (m, "init_mesh"));
 	TRY (h5tpriv_init_mesh (
 	             m,
 	             f,
@@ -119,7 +128,11 @@ h5t_open_tetrahedral_mesh_part (
 	             &h5t_tet_ref_elem,
 	             &tet_funcs,
 	             0));
+	TRY (h5tpriv_profile_end (m, "init_mesh"));
+	TRY (h5tpriv_profile_begin (m, "read_mesh"));
 	TRY (h5tpriv_read_mesh_part (m, elem_indices, dim));
+	TRY (h5tpriv_profile_end (m, "read_mesh"));
+	TRY (h5tpriv_profile_end (m, "open_mesh"));
 
 	H5_RETURN (H5_SUCCESS);
 }
@@ -17,6 +17,7 @@
 #include "private/h5t_access.h"
 #include "private/h5t_adjacencies.h"
 #include "private/h5t_io.h"
+#include "private/h5t_profile.h"
 #include "private/h5t_retrieve.h"
 #include "private/h5t_store.h"
 
@@ -66,10 +67,6 @@ h5t_open_triangle_mesh (
                 h5_err_t,
                 "f=%p, name=%s, mesh=%p",
                 f, name, mesh);
-#ifdef WITH_PARALLEL_H5GRID
-	MPI_Barrier (f->props->comm);
-	double start = MPI_Wtime();
-#endif
 	hid_t mesh_hid;
 	TRY (mesh_hid = h5priv_open_group_with_intermediates (
 	             f->root_gid,
@@ -79,6 +76,8 @@ h5t_open_triangle_mesh (
 
 	TRY (*mesh = h5_calloc (1, sizeof(**mesh)));
 	h5t_mesh_t* m = *mesh;
+	TRY (h5tpriv_profile_begin (m, "open_mesh"));
+	TRY (h5tpriv_profile_begin (m, "init_mesh"));
 	TRY (h5tpriv_init_mesh (
 	             m,
 	             f,
@@ -88,15 +87,14 @@ h5t_open_triangle_mesh (
 	             &h5t_tri_ref_elem,
 	             &tri_funcs,
 	             0));
-#ifdef WITH_PARALLEL_H5GRID
-	MPI_Barrier (m->f->props->comm);
-	m->timing.measure[m->timing.next_time++] = start;
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-#endif
+	TRY (h5tpriv_profile_end (m, "init_mesh"));
+	TRY (h5tpriv_profile_begin (m, "read_mesh"));
 	TRY (
                 m->is_chunked && m->f->nprocs > 1 ?
                 h5tpriv_read_chunked_mesh (m) : h5tpriv_read_mesh (m)
                 );
+	TRY (h5tpriv_profile_end (m, "read_mesh"));
+	TRY (h5tpriv_profile_end (m, "open_mesh"));
 	H5_RETURN (H5_SUCCESS);
 }
 
@@ -112,10 +110,6 @@ h5t_open_triangle_mesh_part (
         h5_file_p f = (h5_file_p)fh;
 	H5_CORE_API_ENTER (h5_err_t, "f=%p, name=%s, mesh=%p", f, name, mesh);
 	hid_t mesh_hid;
-#ifdef WITH_PARALLEL_H5GRID
-	MPI_Barrier (f->props->comm);
-	double start = MPI_Wtime();
-#endif
 	TRY (mesh_hid = h5priv_open_group_with_intermediates (
 	             f->root_gid,
 	             H5T_CONTAINER_GRPNAME,
@@ -124,6 +118,8 @@ h5t_open_triangle_mesh_part (
 
 	TRY (*mesh = h5_calloc (1, sizeof(**mesh)));
 	h5t_mesh_t* m = *mesh;
+	TRY (h5tpriv_profile_begin (m, "open_mesh"));
+	TRY (h5tpriv_profile_begin (m, "init_mesh"));
 	TRY (h5tpriv_init_mesh (
 	             m,
 	             f,
@@ -133,13 +129,11 @@ h5t_open_triangle_mesh_part (
 	             &h5t_tri_ref_elem,
 	             &tri_funcs,
 	             0));
-#ifdef WITH_PARALLEL_H5GRID  // reason: even if we have a chunked mesh, if h5hut is not parallel
-	MPI_Barrier (m->f->props->comm);
-	m->timing.measure[m->timing.next_time++] = start;
-	m->timing.measure[m->timing.next_time++] = MPI_Wtime();
-#endif
-
+	TRY (h5tpriv_profile_end (m, "init_mesh"));
+	TRY (h5tpriv_profile_begin (m, "read_mesh"));
 	TRY (h5tpriv_read_mesh_part (m, elem_indices, dim));
+	TRY (h5tpriv_profile_end (m, "read_mesh"));
+	TRY (h5tpriv_profile_end (m, "open_mesh"));
 
 	H5_RETURN (H5_SUCCESS);
 }
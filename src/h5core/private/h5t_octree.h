@@ -28,6 +28,12 @@ struct h5_oct_point {
 	h5_glb_idx_t elem;
 };
 
+// Leaf octant in point-location index
+struct h5t_oct_leaf {
+	h5_uint64_t key;	// Morton key of path from root
+	h5_oct_idx_t oct;
+};
+
 // Iterators
 struct h5t_oct_iterator {
 	h5t_octree_t* octree;
@@ -84,6 +90,11 @@ struct h5_octree {
 	/* */
 	h5_int32_t 		maxpoints;
 
+	/*** point-location index: leaves sorted by Morton key ***/
+	struct h5t_oct_leaf*	leaves;
+	h5_oct_idx_t		nbr_leaves;
+	h5_oct_level_t		leaf_depth;	// max level of leaves
+	h5_oct_idx_t		leaves_of;	// current_oct_idx + 1 when built
 };
 
 typedef struct {
@@ -163,6 +174,7 @@ h5_err_t H5t_write_octree ( h5t_mesh_t* const m);
 
 
 h5_oct_idx_t H5t_find_leafoctant_of_point (h5t_octree_t* octree, h5_oct_idx_t oct_idx, h5_float64_t* bounding_box, h5_oct_point_t* point);
+h5_err_t H5t_find_leafoctants_of_points (h5t_octree_t* const octree, const h5_int32_t nbr_points, const h5_oct_point_t* const points, h5_oct_idx_t* const leaf_octs);
 
 h5_oct_level_t H5t_oct_has_level (h5t_octree_t* octree, h5_oct_idx_t oct_idx, h5_oct_level_t level);
 
@@ -0,0 +1,351 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+/*
+  Named, hierarchical timing regions for mesh operations.
+
+  A region is opened with h5tpriv_profile_begin() and closed with
+  h5tpriv_profile_end(). Regions opened while another region is open
+  become children of the open region, the full name of a region is the
+  '/' separated list of its ancestors and its own label, like
+  "open_mesh/read_mesh/read_vertices". Calls of the same region are
+  accumulated.
+
+  Profiling is always on, regions are used at the granularity of
+  phases like reading or refining a mesh, thus the overhead can be
+  neglected. The profile is written when the mesh is closed, if a
+  profile file has been set with h5t_set_profile_file(). The regions of
+  all processes are gathered and the first process appends a table
+  with the number of processes which entered a region, the number of
+  calls and minimum, mean and maximum time over all processes to the
+  file. The difference between minimum and maximum shows the load
+  imbalance.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "h5core/h5_syscall.h"
+
+#include "private/h5_file.h"
+#include "private/h5_mpi.h"
+#include "private/h5t_profile.h"
+
+#define MAX_DEPTH	16
+
+struct h5t_region {
+	char		path[128];	// labels of ancestors and region
+	h5_int64_t	calls;		// number of calls
+	double		total;		// accumulated time
+};
+
+struct h5t_profile {
+	char*		filename;	// profile is appended to this file
+	struct h5t_region* regions;
+	size_t		num_regions;
+	size_t		size;
+	int		depth;		// number of open regions
+	size_t		stack[MAX_DEPTH]; // indices of open regions
+	double		start[MAX_DEPTH]; // start time of open regions
+};
+
+static inline double
+now (
+	void
+	) {
+#ifdef H5_HAVE_PARALLEL
+	return MPI_Wtime ();
+#else
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+#endif
+}
+
+static inline const char*
+label_of (
+	const char* const path
+	) {
+	const char* label = strrchr (path, '/');
+	return label ? label + 1 : path;
+}
+
+static inline int
+depth_of (
+	const char* path
+	) {
+	int depth = 0;
+	while ((path = strchr (path, '/')) != NULL) {
+		depth++;
+		path++;
+	}
+	return depth;
+}
+
+static h5_err_t
+get_profile (
+	h5t_mesh_t* const m
+	) {
+	H5_INLINE_FUNC_ENTER (h5_err_t);
+	if (m->profile == NULL) {
+		TRY (m->profile = h5_calloc (1, sizeof (*m->profile)));
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Return index of region with given path, add region if it doesn't
+  exist.
+ */
+static h5_ssize_t
+find_region (
+	struct h5t_profile* const p,
+	const char* const path
+	) {
+	H5_INLINE_FUNC_ENTER (h5_ssize_t);
+	for (size_t i = 0; i < p->num_regions; i++) {
+		if (strcmp (p->regions[i].path, path) == 0) {
+			H5_LEAVE ((h5_ssize_t)i);
+		}
+	}
+	if (p->num_regions == p->size) {
+		size_t size = p->size ? 2 * p->size : 32;
+		TRY (p->regions = h5_alloc (
+			     p->regions, size * sizeof (p->regions[0])));
+		p->size = size;
+	}
+	struct h5t_region* r = &p->regions[p->num_regions];
+	memset (r, 0, sizeof (*r));
+	strncpy (r->path, path, sizeof (r->path) - 1);
+	H5_RETURN ((h5_ssize_t)p->num_regions++);
+}
+
+h5_err_t
+h5tpriv_profile_begin (
+	h5t_mesh_t* const m,
+	const char* const label
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "m=%p, label=%s", m, label);
+	TRY (get_profile (m));
+	struct h5t_profile* p = m->profile;
+	if (p->depth == MAX_DEPTH) {
+		H5_LEAVE (
+			h5_error (
+				H5_ERR_INVAL,
+				"Cannot begin profile region '%s': "
+				"too many nested regions.",
+				label));
+	}
+	char path[sizeof (p->regions[0].path)];
+	int len = p->depth > 0 ?
+		snprintf (path, sizeof (path), "%s/%s",
+			  p->regions[p->stack[p->depth-1]].path, label) :
+		snprintf (path, sizeof (path), "%s", label);
+	if (len < 0 || (size_t)len >= sizeof (path)) {
+		H5_LEAVE (
+			h5_error (
+				H5_ERR_INVAL,
+				"Cannot begin profile region '%s': "
+				"name too long.",
+				label));
+	}
+	h5_ssize_t idx;
+	TRY (idx = find_region (p, path));
+	p->stack[p->depth] = (size_t)idx;
+	p->start[p->depth] = now ();
+	p->depth++;
+	H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5tpriv_profile_end (
+	h5t_mesh_t* const m,
+	const char* const label
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "m=%p, label=%s", m, label);
+	double end = now ();
+	struct h5t_profile* p = m->profile;
+	if (p == NULL || p->depth == 0 ||
+	    strcmp (label_of (p->regions[p->stack[p->depth-1]].path), label) != 0) {
+		H5_LEAVE (
+			h5_error (
+				H5_ERR_INVAL,
+				"Cannot end profile region '%s': "
+				"region is not the innermost open region.",
+				label));
+	}
+	p->depth--;
+	struct h5t_region* r = &p->regions[p->stack[p->depth]];
+	r->calls++;
+	r->total += end - p->start[p->depth];
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Return number of open regions.
+ */
+int
+h5tpriv_profile_depth (
+	h5t_mesh_t* const m
+	) {
+	return m->profile ? m->profile->depth : 0;
+}
+
+/*
+  Drop all regions opened above the given depth. This is used to clean
+  up after an error between h5tpriv_profile_begin() and
+  h5tpriv_profile_end(), the time spent in dropped regions is not
+  accounted.
+ */
+h5_err_t
+h5tpriv_profile_unwind (
+	h5t_mesh_t* const m,
+	const int depth
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "m=%p, depth=%d", m, depth);
+	struct h5t_profile* p = m->profile;
+	while (p != NULL && p->depth > depth) {
+		p->depth--;
+		h5_debug ("Dropping open profile region '%s'.",
+			  p->regions[p->stack[p->depth]].path);
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5tpriv_set_profile_file (
+	h5t_mesh_t* const m,
+	const char* const filename
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "m=%p, filename=%s", m, filename);
+	TRY (get_profile (m));
+	TRY (h5_free (m->profile->filename));
+	m->profile->filename = NULL;
+	if (filename != NULL) {
+		TRY (m->profile->filename = h5_strdup (filename));
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
+struct merged_region {
+	const char*	path;
+	int		ranks;
+	h5_int64_t	calls;
+	double		min;
+	double		max;
+	double		sum;
+};
+
+static h5_err_t
+write_table (
+	h5t_mesh_t* const m,
+	const struct h5t_region* const regions,
+	const size_t num_regions
+	) {
+	H5_PRIV_FUNC_ENTER (h5_err_t, "m=%p, regions=%p, num_regions=%zu",
+			    m, regions, num_regions);
+	struct merged_region* merged;
+	size_t num_merged = 0;
+	TRY (merged = h5_calloc (num_regions + 1, sizeof (*merged)));
+	for (size_t i = 0; i < num_regions; i++) {
+		const struct h5t_region* r = &regions[i];
+		size_t j = 0;
+		while (j < num_merged && strcmp (merged[j].path, r->path) != 0)
+			j++;
+		if (j == num_merged) {
+			merged[j].path = r->path;
+			merged[j].min = r->total;
+			merged[j].max = r->total;
+			num_merged++;
+		}
+		merged[j].ranks++;
+		merged[j].calls += r->calls;
+		merged[j].sum += r->total;
+		if (r->total < merged[j].min)
+			merged[j].min = r->total;
+		if (r->total > merged[j].max)
+			merged[j].max = r->total;
+	}
+	FILE* file = fopen (m->profile->filename, "a");
+	if (file == NULL) {
+		TRY (h5_free (merged));
+		H5_LEAVE (
+			h5_warn ("Cannot write profile file '%s'.",
+				 m->profile->filename));
+	}
+	long long num_elems = 0;
+	if (m->num_glb_elems != NULL && m->num_leaf_levels > 0)
+		num_elems = (long long)m->num_glb_elems[m->num_leaf_levels-1];
+	fprintf (file, "# mesh '%s': %d procs, %lld elems\n",
+		 m->mesh_name, m->f->nprocs, num_elems);
+	fprintf (file, "# %-38s %6s %8s %12s %12s %12s\n",
+		 "region", "ranks", "calls", "min", "mean", "max");
+	for (size_t j = 0; j < num_merged; j++) {
+		const struct merged_region* r = &merged[j];
+		int indent = 2 * depth_of (r->path);
+		fprintf (file, "  %*s%-*s %6d %8lld %12.6f %12.6f %12.6f\n",
+			 indent, "", 38 - indent, label_of (r->path),
+			 r->ranks, (long long)r->calls,
+			 r->min, r->sum / r->ranks, r->max);
+	}
+	fprintf (file, "\n");
+	fclose (file);
+	TRY (h5_free (merged));
+	H5_RETURN (H5_SUCCESS);
+}
+
+/*
+  Gather regions of all processes and append table to profile file.
+  Must be called by all processes.
+ */
+h5_err_t
+h5tpriv_write_profile (
+	h5t_mesh_t* const m
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "m=%p", m);
+	struct h5t_profile* p = m->profile;
+	// regions left open by a failed operation must not leak into the
+	// regions of the next mesh operations
+	TRY (h5tpriv_profile_unwind (m, 0));
+	if (p == NULL || p->filename == NULL) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	struct h5t_region* all = p->regions;
+	size_t num_all = p->num_regions;
+#ifdef H5_HAVE_PARALLEL
+	if (m->f->nprocs > 1) {
+		TRY (h5priv_mpi_gather_recs (
+			     p->regions, p->num_regions, sizeof (*p->regions),
+			     (void**)&all, &num_all, 0, m->f->props->comm));
+	}
+#endif
+	if (m->f->myproc == 0) {
+		TRY (write_table (m, all, num_all));
+	}
+	if (all != p->regions) {
+		TRY (h5_free (all));
+	}
+	H5_RETURN (H5_SUCCESS);
+}
+
+h5_err_t
+h5tpriv_free_profile (
+	h5t_mesh_t* const m
+	) {
+	H5_PRIV_API_ENTER (h5_err_t, "m=%p", m);
+	if (m->profile == NULL) {
+		H5_LEAVE (H5_SUCCESS);
+	}
+	TRY (h5_free (m->profile->regions));
+	TRY (h5_free (m->profile->filename));
+	TRY (h5_free (m->profile));
+	m->profile = NULL;
+	H5_RETURN (H5_SUCCESS);
+}
@@ -0,0 +1,44 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+#ifndef __PRIVATE_H5T_PROFILE_H
+#define __PRIVATE_H5T_PROFILE_H
+
+#include "h5core/h5_types.h"
+#include "private/h5t_types.h"
+
+h5_err_t
+h5tpriv_profile_begin (
+	h5t_mesh_t* const, const char* const);
+
+h5_err_t
+h5tpriv_profile_end (
+	h5t_mesh_t* const, const char* const);
+
+int
+h5tpriv_profile_depth (
+	h5t_mesh_t* const);
+
+h5_err_t
+h5tpriv_profile_unwind (
+	h5t_mesh_t* const, const int);
+
+h5_err_t
+h5tpriv_set_profile_file (
+	h5t_mesh_t* const, const char* const);
+
+h5_err_t
+h5tpriv_write_profile (
+	h5t_mesh_t* const);
+
+h5_err_t
+h5tpriv_free_profile (
+	h5t_mesh_t* const);
+
+#endif
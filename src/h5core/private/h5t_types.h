@@ -13,6 +13,7 @@
 #include "h5core/h5_types.h"
 #include "private/h5_types.h"
 #include "private/h5_hsearch.h"
+#include "private/h5_arena.h"
 //#include "private/h5_maps.h"
 
 #include "private/h5t_ref_elements.h"
@@ -141,6 +142,7 @@ typedef struct h5t_adjacencies {
 	} tv;
 	h5_hashtable_t te_hash;
 	h5_hashtable_t td_hash;
+	h5_arena_t arena;	/* hash table entries and ID lists */
 } h5t_adjacencies_t;
 
 #define OCT_USERDATA_SIZE 4
@@ -186,41 +188,7 @@ typedef struct h5t_vtx_chk_list {
 	h5_chk_idx_t chk;
 } h5t_vtx_chk_list_t;
 
-#define NUM_TIMING 27
-
-typedef struct h5t_timing {
-	int num_timing;
-	int next_time;
- h5_time_t measure[NUM_TIMING];
- char* f;
-// h5_time_t t1; // after init mesh
-// h5_time_t t2; // after reading octree
-// h5_time_t t3; // after reading chunks
-// h5_time_t t4; // after reading weights
-// h5_time_t t5; // after distributing chunks
-// h5_time_t t6; // after reading elems
-// h5_time_t t7; // after reading vertices
-// h5_time_t t8; // after internal updates
-// h5_time_t t9; // begin end refinement
-// h5_time_t t10; // after pre ref
-// h5_time_t t11; // after refine
-// h5_time_t t12; // after boundary edges exchange
-// h5_time_t t13; // after weights exchange
-// h5_time_t t14; // after init glb elems struct
-// h5_time_t t15; // after init glb vertices struct
-// h5_time_t t16; // after exchange glb_struct
-// h5_time_t t17; // after store glb elems struct
-// h5_time_t t18; // after post_refine
-// h5_time_t t19; // before close
-// h5_time_t t20; // after write weights
-// h5_time_t t21; // after write chunks
-// h5_time_t t22; // after write octree
-// h5_time_t t23; // after calc vtx map
-// h5_time_t t24; // after vtx hyperslap select
-// h5_time_t t25; // after write vertices
-// h5_time_t t26; // after write elems
-
-} h5t_timing_t;
+struct h5t_profile;
 
 typedef struct h5t_oct_count {
 	h5_oct_idx_t oct;
@@ -258,6 +226,7 @@ struct h5t_mesh {
 	h5_lvl_idx_t leaf_level;        /* idx of current level */
 	h5_lvl_idx_t num_leaf_levels;   /* number of levels */
 	h5_lvl_idx_t num_loaded_levels;
+	h5_lvl_idx_t num_written_levels; /* number of levels in file */
 
 	/*** chunking ***/
 	h5_lvl_idx_t is_chunked;		/* == 1 if mesh is chunked */
@@ -268,7 +237,7 @@ struct h5t_mesh {
 	h5_dsinfo_t dsinfo_octree;
 	h5_dsinfo_t dsinfo_userdata;
 #endif
-	h5t_timing_t timing;
+	struct h5t_profile* profile;	/* named timing regions */
 
 	h5_strlist_t*   mtagsets;
 
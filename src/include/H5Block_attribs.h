@@ -848,6 +848,68 @@ H5BlockReadFieldAttribInt32 (
 			H5_INT32_T,
 			(void*)buffer));
 }
+
+/**
+  Write a table of attributes to a given field in one pass.
+
+  The table is stored in one compound HDF5 attribute named \c __attribs__,
+  so writing it costs a few HDF5 calls regardless of the number of
+  entries. Entries with the name of an existing attribute replace it.
+  The entries are still accessible as attributes with
+  \ref H5BlockReadFieldAttribFloat64() etc., but other HDF5 tools see
+  the compound attribute only.
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \see H5BlockReadFieldAttribs()
+*/
+static inline h5_err_t
+H5BlockWriteFieldAttribs (
+	const h5_file_t f,			///< [in]  file handle
+	const char* field_name,			///< [in]  name of field
+	const h5_attrib_t* const attribs,	///< [in]  attribute table
+	const h5_size_t num_attribs		///< [in]  number of entries
+	) {
+        H5_API_ENTER (h5_err_t,
+                      "f=%p, field_name='%s', attribs=%p, num_attribs=%llu",
+		      (h5_file_p)f, field_name, attribs,
+		      (long long unsigned)num_attribs);
+	H5_API_RETURN (
+		h5b_write_field_attribs (
+			f,
+			field_name,
+			attribs,
+			num_attribs));
+}
+
+/**
+  Read all attributes attached to a given field in one pass.
+
+  On return \c *attribs points to a table with name, type, number of
+  elements and value of each attribute. The table must be released
+  with \ref H5FreeAttribs().
+
+  \return number of attributes on success
+  \return \c H5_FAILURE on error
+
+  \see H5BlockWriteFieldAttribs()
+*/
+static inline h5_ssize_t
+H5BlockReadFieldAttribs (
+	const h5_file_t f,			///< [in]  file handle
+	const char* field_name,			///< [in]  name of field
+	h5_attrib_t** const attribs		///< [out] attribute table
+	) {
+        H5_API_ENTER (h5_ssize_t,
+                      "f=%p, field_name='%s', attribs=%p",
+		      (h5_file_p)f, field_name, attribs);
+	H5_API_RETURN (
+		h5b_read_field_attribs (
+			f,
+			field_name,
+			attribs));
+}
 ///<   @}
 
 #ifdef __cplusplus
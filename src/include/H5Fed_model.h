@@ -243,6 +243,53 @@ H5FedSetMeshChanged (
 	H5_API_RETURN (h5t_set_mesh_changed (m));
 }
 
+/**
+  Append the profile of mesh operations to file \c filename when the
+  mesh is closed. The profile lists the time spent in named regions,
+  like reading, refining and writing the mesh, with minimum, mean and
+  maximum over all processes. Must be called by all processes.
+
+  \return \c H5_SUCCESS or \c H5_FAILURE
+ */
+static inline h5_err_t
+H5FedSetProfileFile (
+        h5t_mesh_t* const m,		///< [in] mesh object
+        const char* const filename	///< [in] name of profile file
+        ) {
+	H5_API_ENTER (h5_err_t, "m=%p, filename=%s", m, filename);
+	H5_API_RETURN (h5t_set_profile_file (m, filename));
+}
+
+/**
+  Begin a user defined profile region. Regions can be nested, a region
+  begun while another region is open is listed as child of this region.
+
+  \return \c H5_SUCCESS or \c H5_FAILURE
+ */
+static inline h5_err_t
+H5FedBeginProfile (
+        h5t_mesh_t* const m,		///< [in] mesh object
+        const char* const label		///< [in] name of region
+        ) {
+	H5_API_ENTER (h5_err_t, "m=%p, label=%s", m, label);
+	H5_API_RETURN (h5t_begin_profile (m, label));
+}
+
+/**
+  End profile region \c label. The region must be the innermost open
+  region.
+
+  \return \c H5_SUCCESS or \c H5_FAILURE
+ */
+static inline h5_err_t
+H5FedEndProfile (
+        h5t_mesh_t* const m,		///< [in] mesh object
+        const char* const label		///< [in] name of region
+        ) {
+	H5_API_ENTER (h5_err_t, "m=%p, label=%s", m, label);
+	H5_API_RETURN (h5t_end_profile (m, label));
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -122,6 +122,36 @@ H5FedStoreVertex (
 	H5_API_RETURN (h5t_store_vertex (m, vertex_id, P));
 }
 
+/*!
+   \ingroup h5fed_c_api
+
+   Stores the coordinates of \c num vertices at once. The coordinates
+   of vertex \c i are \c P[3*i], \c P[3*i+1] and \c P[3*i+2]. This is
+   equivalent to calling \c H5FedStoreVertex() for each vertex, but
+   avoids the per call overhead for large meshes.
+
+   \return local id of first vertex on success
+   \return errno on error
+ */
+static inline h5_loc_idx_t
+H5FedStoreVertices (
+        h5t_mesh_t* const m,            /*!< file handle		*/
+        const h5_size_t num,            /*!< number of vertices	*/
+        const h5_glb_id_t vertex_ids[], /*!< ids from mesher or NULL	*/
+        const h5_float64_t P[]          /*!< coordinates		*/
+        ) {
+	H5_API_ENTER (h5_loc_idx_t,
+	              "m=%p, num=%llu, vertex_ids=%p, P=%p",
+	              m, (long long unsigned)num, vertex_ids, P);
+	if (h5t_get_level (m) != 0) {
+		H5_API_LEAVE (
+		        h5_error (
+		                H5_ERR_INVAL,
+		                "Vertices can be added to level 0 only!"));
+	}
+	H5_API_RETURN (h5t_store_vertices (m, num, vertex_ids, P));
+}
+
 static inline h5_err_t
 H5FedEndStoreVertices (
         h5t_mesh_t* const m
@@ -186,6 +216,42 @@ H5FedStoreWeightedElement (
 	H5_API_RETURN (h5t_add_lvl0_cell (m, local_vids, weights));
 }
 
+/*!
+   \ingroup h5fed_c_api
+
+   Stores \c num elements at once. The local vertex indices of element
+   \c i are the \c i-th tuple in \c local_vids. This is equivalent to
+   calling \c H5FedStoreElement() for each element, but avoids the per
+   call overhead for large meshes.
+
+   \return local id of first element
+   \return \c errno on error
+ */
+static inline h5_loc_idx_t
+H5FedStoreElements (
+        h5t_mesh_t* const m,            /*!< file handle		*/
+        const h5_size_t num,            /*!< number of elements	*/
+        const h5_loc_idx_t local_vids[] /*!< tuples with vertex id's	*/
+        ) {
+	H5_API_ENTER (h5_loc_idx_t,
+	              "m=%p, num=%llu, local_vids=%p",
+	              m, (long long unsigned)num, local_vids);
+	H5_API_RETURN (h5t_add_lvl0_cells (m, num, local_vids, NULL));
+}
+
+static inline h5_loc_idx_t
+H5FedStoreWeightedElements (
+        h5t_mesh_t* const m,		///< [in] mesh object
+        const h5_size_t num,		///< [in] number of elements
+        const h5_loc_idx_t local_vids[],///< tuples with vertex id's
+        const h5_weight_t weights[]	///< tuples with weights
+        ) {
+	H5_API_ENTER (h5_loc_idx_t,
+	              "m=%p, num=%llu, local_vids=%p, weights=%p",
+	              m, (long long unsigned)num, local_vids, weights);
+	H5_API_RETURN (h5t_add_lvl0_cells (m, num, local_vids, weights));
+}
+
 static inline h5_err_t
 H5FedEndStoreElements (
         h5t_mesh_t* const m
@@ -248,6 +248,146 @@ H5PartReadDataInt32 (
 			H5_INT32_T));
 }
 
+/**
+   \fn h5_ssize_t H5PartMapDataFloat64 (
+	const h5_file_t f,
+	const char* name,
+	const h5_float64_t** data
+	)
+
+   \fn h5_ssize_t H5PartMapDataFloat32 (
+	const h5_file_t f,
+	const char* name,
+	const h5_float32_t** data
+	)
+
+   \fn h5_ssize_t H5PartMapDataInt64 (
+	const h5_file_t f,
+	const char* name,
+	const h5_int64_t** data
+	)
+
+   \fn h5_ssize_t H5PartMapDataInt32 (
+	const h5_file_t f,
+	const char* name,
+	const h5_int32_t** data
+	)
+
+  Get read-only access to a dataset without copying.
+
+  If the file has been opened read-only and the dataset is stored
+  contiguously in a type which needs no conversion, \c data is set to
+  point into a read-only memory mapping of the file. Processes on the
+  same node accessing the same file share the mapped pages. If a view
+  is set, it must select a contiguous range of elements.
+
+  All other datasets - for example chunked or compressed datasets - are
+  read into a buffer allocated by the library.
+
+  In both cases the data must be released with \ref H5PartUnmapData().
+  Mapped data stays valid until it is released or the file is closed.
+
+  \param f	[in]  file handle
+  \param name   [in]  name of dataset to be mapped
+  \param data	[out] pointer to data
+
+  \return number of elements on success
+  \return \c H5_FAILURE on error
+
+  \see H5PartUnmapData()
+  \see H5PartReadDataFloat64()
+
+  \note 
+  | Release     | Change                               |
+  | :------     | :-----			       |
+  | \c 2.0.0rc6 | Function introduced in this release. |
+*/
+static inline h5_ssize_t
+H5PartMapDataFloat64 (
+	const h5_file_t f,
+	const char* name,
+	const h5_float64_t** data
+	) {
+	H5_API_ENTER (h5_ssize_t,
+                      "f=%p, name='%s', data=%p",
+                      (h5_file_p)f, name, data);
+	H5_API_RETURN (
+		h5u_map_dataset (
+			f, name, H5_FLOAT64_T,
+			(const void**)data));
+}
+
+static inline h5_ssize_t
+H5PartMapDataFloat32 (
+	const h5_file_t f,
+	const char* name,
+	const h5_float32_t** data
+	) {
+	H5_API_ENTER (h5_ssize_t,
+                      "f=%p, name='%s', data=%p",
+                      (h5_file_p)f, name, data);
+	H5_API_RETURN (
+		h5u_map_dataset (
+			f, name, H5_FLOAT32_T,
+			(const void**)data));
+}
+
+static inline h5_ssize_t
+H5PartMapDataInt64 (
+	const h5_file_t f,
+	const char* name,
+	const h5_int64_t** data
+	) {
+	H5_API_ENTER (h5_ssize_t,
+                      "f=%p, name='%s', data=%p",
+                      (h5_file_p)f, name, data);
+	H5_API_RETURN (
+		h5u_map_dataset (
+			f, name, H5_INT64_T,
+			(const void**)data));
+}
+
+static inline h5_ssize_t
+H5PartMapDataInt32 (
+	const h5_file_t f,
+	const char* name,
+	const h5_int32_t** data
+	) {
+	H5_API_ENTER (h5_ssize_t,
+                      "f=%p, name='%s', data=%p",
+                      (h5_file_p)f, name, data);
+	H5_API_RETURN (
+		h5u_map_dataset (
+			f, name, H5_INT32_T,
+			(const void**)data));
+}
+
+/**
+  Release data returned by \ref H5PartMapDataFloat64() etc.
+
+  \param f	[in]  file handle
+  \param data	[in]  pointer returned by mapping a dataset
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \note 
+  | Release     | Change                               |
+  | :------     | :-----			       |
+  | \c 2.0.0rc6 | Function introduced in this release. |
+*/
+static inline h5_err_t
+H5PartUnmapData (
+	const h5_file_t f,
+	const void* data
+	) {
+	H5_API_ENTER (h5_err_t,
+                      "f=%p, data=%p",
+                      (h5_file_p)f, data);
+	H5_API_RETURN (
+		h5u_unmap_dataset (f, data));
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -115,7 +115,7 @@ H5AbortErrorhandler (
 }
 
 /**
-  Get last error code.
+  Get last error code of the calling thread.
 
   Error codes are:
 
@@ -12,6 +12,7 @@
 
 #include "h5core/h5_log.h"
 #include "h5core/h5_file.h"
+#include "h5core/h5_syscall.h"
 
 #include <hdf5.h>
 
@@ -46,8 +47,16 @@ extern "C" {
   \see H5SetPropFileMPIOIndependent()
   \see H5SetPropFileMPIOPosix() (HDF5 <= 1.8.12 only)
   \see H5SetPropFileCoreVFD()
+  \see H5SetPropFileCoreStaging()
   \see H5SetPropFileAlign()
   \see H5SetPropFileThrottle()
+  \see H5SetPropFileFSTuning()
+  \see H5SetPropFileCollectiveMetadata()
+  \see H5SetPropFilePageBuffer()
+  \see H5SetPropFileMetadataCache()
+  \see H5SetPropFilePrefetch()
+  \see H5SetPropFileAttachmentCompression()
+  \see H5SetPropFileAttachmentStriping()
 
   \note 
   | Release    | Change                               |
@@ -168,6 +177,62 @@ H5SetPropFileCoreVFD (
         H5_API_RETURN (h5_set_prop_file_core_vfd (prop, increment));
 }
 
+/**
+  Modifies the file property list to use the \c H5FD_CORE driver with
+  asynchronous write-back, similar to a burst buffer.
+
+  The file is held in memory. Each time an iteration has been completed
+  - i.e. on the next call of \ref H5SetStep() - and on closing the
+  file, a copy of the in-memory file image is handed to a background
+  thread, which writes it to disk. Thus writing an iteration returns
+  at memory speed. The target file is replaced atomically and always
+  contains a complete image. Since each image contains the whole file,
+  an image which has not yet been written is superseded by a newer one.
+
+  If \c local_path is not \c NULL or empty, the image is first written
+  to this - usually node-local - path and then copied to the target
+  file.
+
+  Each image contains the whole file. Thus every iteration costs a
+  copy and a write of the whole file and the in-memory file grows
+  with every iteration. Without memory cap staging is therefore only
+  suitable for files with few iterations.
+
+  \c mem_cap limits the size of the in-memory file. After the first
+  iteration which makes the in-memory file exceed \c mem_cap, the
+  image is written synchronously, the file is reopened from disk and
+  subsequent iterations are written directly without staging. The
+  memory used is bounded by about twice \c mem_cap - the in-memory
+  file and one staged copy - plus the data of one iteration. If the
+  staged copies would exceed \c mem_cap, the call waits for the
+  background writer. Set \c mem_cap to 0 for no limit; the memory
+  used then grows with the file.
+
+  As with \ref H5SetPropFileCoreVFD() each process writes its own file.
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \see H5SetPropFileCoreVFD()
+
+  \note 
+  | Release     | Change                               |
+  | :------     | :-----			       |
+  | \c 2.0.0rc6 | Function introduced in this release. |
+*/
+static inline h5_err_t
+H5SetPropFileCoreStaging (
+        h5_prop_t prop,			///< [in,out] identifier for file property list
+	const h5_int64_t increment,	///< [in] size, in bytes, of memory increments.
+	const h5_int64_t mem_cap,	///< [in] memory cap for the in-memory file in bytes
+	const char* const local_path	///< [in] node-local intermediate file or \c NULL
+        ) {
+        H5_API_ENTER (h5_err_t, "prop=%p, increment=%lld, mem_cap=%lld, local_path='%s'",
+		      (void*)prop, (long long int)increment, (long long int)mem_cap,
+		      local_path ? local_path : "");
+        H5_API_RETURN (h5_set_prop_file_core_staging (prop, increment, mem_cap, local_path));
+}
+
 /**
   Sets alignment properties of a file property list so that any file
   object greater than or equal in size to threshold bytes will be
@@ -253,6 +318,334 @@ H5SetPropFileFlush (
         H5_API_RETURN (h5_set_prop_file_flush_after_write (prop));
 }
 
+/**
+  Enable file system specific tuning.
+
+  On opening the file, the file system the file is stored on is
+  detected. For Lustre, GPFS and BeeGFS the stripe or block size is
+  queried and used to set the HDF5 alignment, the B-tree K of chunked
+  datasets and, in the parallel library, MPI-IO hints like the
+  collective buffer size. An alignment set with \ref
+  H5SetPropFileAlign() takes precedence. The chosen settings are
+  reported on verbosity level \c H5_VERBOSE_INFO.
+
+  File system detection is currently only available on Linux.
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \see H5SetPropFileAlign()
+
+  \note 
+  | Release     | Change                               |
+  | :------     | :-----			       |
+  | \c 2.0.0rc6 | Function introduced in this release. |
+*/
+static inline h5_err_t
+H5SetPropFileFSTuning (
+        h5_prop_t prop			///< [in,out] identifier for file property list
+	) {
+	H5_API_ENTER (h5_err_t, "prop=%p",
+		      (void*)prop);
+        H5_API_RETURN (h5_set_prop_file_fs_tuning (prop));
+}
+
+/**
+  Enable collective metadata reads and writes.
+
+  With this property all processes perform metadata operations like
+  opening an iteration group, dataset or attribute collectively. Only
+  one process reads the metadata from disk and broadcasts it to all
+  other processes. This avoids a metadata read storm from all
+  processes when opening a file on a large number of processes.
+
+  The property is only available in the parallel library and requires
+  HDF5 1.10.0 or later. In all other cases it is ignored.
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \see H5SetPropFilePageBuffer()
+  \see H5SetPropFileMetadataCache()
+
+  \note 
+  | Release     | Change                               |
+  | :------     | :-----			       |
+  | \c 2.0.0rc6 | Function introduced in this release. |
+*/
+static inline h5_err_t
+H5SetPropFileCollectiveMetadata (
+        h5_prop_t prop			///< [in,out] identifier for file property list
+	) {
+	H5_API_ENTER (h5_err_t, "prop=%p",
+		      (void*)prop);
+        H5_API_RETURN (h5_set_prop_file_collective_metadata (prop));
+}
+
+/**
+  Use paged file space allocation with pages of \c page_size bytes
+  for new files and a page buffer of \c buf_size bytes. With paging
+  enabled small metadata and raw data objects are aggregated into
+  pages, which are read and written as a whole.
+
+  The page buffer size must be a multiple of the page size, otherwise
+  an error is returned. Set \c buf_size to 0 to enable paging without
+  page buffer. HDF5 does not
+  support a page buffer with the MPI-IO VFD, in this case only paging
+  is enabled.
+
+  Paging requires HDF5 1.10.1 or later, otherwise the property is
+  ignored.
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \see H5SetPropFileCollectiveMetadata()
+  \see H5SetPropFileMetadataCache()
+
+  \note 
+  | Release     | Change                               |
+  | :------     | :-----			       |
+  | \c 2.0.0rc6 | Function introduced in this release. |
+*/
+static inline h5_err_t
+H5SetPropFilePageBuffer (
+        h5_prop_t prop,			///< [in,out] identifier for file property list
+	const h5_int64_t page_size,	///< [in] file space page size in bytes
+	const h5_int64_t buf_size	///< [in] page buffer size in bytes
+	) {
+	H5_API_ENTER (h5_err_t, "prop=%p, page_size=%lld, buf_size=%lld",
+		      (void*)prop,
+		      (long long int)page_size, (long long int)buf_size);
+        H5_API_RETURN (h5_set_prop_file_page_buffer (prop, page_size, buf_size));
+}
+
+/**
+  Set the initial size of the HDF5 metadata cache to \c size
+  bytes. The maximum size of the cache is increased if necessary.
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \see H5SetPropFileCollectiveMetadata()
+  \see H5SetPropFilePageBuffer()
+
+  \note 
+  | Release     | Change                               |
+  | :------     | :-----			       |
+  | \c 2.0.0rc6 | Function introduced in this release. |
+*/
+static inline h5_err_t
+H5SetPropFileMetadataCache (
+        h5_prop_t prop,			///< [in,out] identifier for file property list
+	const h5_int64_t size		///< [in] initial cache size in bytes
+	) {
+	H5_API_ENTER (h5_err_t, "prop=%p, size=%lld",
+		      (void*)prop, (long long int)size);
+        H5_API_RETURN (h5_set_prop_file_mdc_size (prop, size));
+}
+
+/**
+  Enable read-ahead of the next iteration.
+
+  Intended for analysis and visualization tools which read the same
+  datasets or fields iteration after iteration. Each time a dataset is
+  read, the same dataset in the next iteration is read by a background
+  thread into a library buffer. Reading this dataset after moving on
+  to the next iteration with \ref H5SetStep() is then a copy from
+  memory.
+
+  Only datasets with contiguous layout and a type which doesn't need
+  conversion are prefetched, all other datasets are read as usual.
+  Prefetching is only done for files opened read-only by a single
+  process.
+
+  \c mem_cap limits the memory used for prefetched datasets. Datasets
+  which would exceed the limit are not prefetched. Set \c mem_cap to 0
+  for no limit.
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \note 
+  | Release     | Change                               |
+  | :------     | :-----			       |
+  | \c 2.0.0rc6 | Function introduced in this release. |
+*/
+static inline h5_err_t
+H5SetPropFilePrefetch (
+        h5_prop_t prop,			///< [in,out] identifier for file property list
+	const h5_int64_t mem_cap	///< [in] memory cap in bytes, 0 for no limit
+	) {
+	H5_API_ENTER (h5_err_t, "prop=%p, mem_cap=%lld",
+		      (void*)prop, (long long int)mem_cap);
+        H5_API_RETURN (h5_set_prop_file_prefetch (prop, mem_cap));
+}
+
+/**
+  Compress attachments with the deflate filter.
+
+  Attachments are stored in chunks of 4 MiB. With a \c level between
+  1 and 9 each chunk is compressed with the given level, 0 disables
+  compression. If the deflate filter isn't available in the HDF5
+  library, attachments are stored uncompressed. In the parallel
+  library compression requires HDF5 1.10.2 or later.
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \see H5AddAttachment()
+
+  \note 
+  | Release     | Change                               |
+  | :------     | :-----			       |
+  | \c 2.0.0rc6 | Function introduced in this release. |
+*/
+static inline h5_err_t
+H5SetPropFileAttachmentCompression (
+        h5_prop_t prop,			///< [in,out] identifier for file property list
+	const h5_int64_t level		///< [in] compression level 0 ... 9
+	) {
+	H5_API_ENTER (h5_err_t, "prop=%p, level=%lld",
+		      (void*)prop, (long long int)level);
+        H5_API_RETURN (h5_set_prop_file_attachment_compression (prop, level));
+}
+
+/**
+  Stripe reading and writing of attachments across all processes.
+
+  Attachments are streamed between the file system and the H5hut
+  file in blocks of 4 MiB. By default all blocks are handled by the
+  first process. With striping block \c i is handled by process
+  \c i modulo the number of processes. The attached file must be
+  accessible by all processes, for example on a parallel file system.
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \see H5AddAttachment()
+  \see H5GetAttachment()
+
+  \note 
+  | Release     | Change                               |
+  | :------     | :-----			       |
+  | \c 2.0.0rc6 | Function introduced in this release. |
+*/
+static inline h5_err_t
+H5SetPropFileAttachmentStriping (
+        h5_prop_t prop			///< [in,out] identifier for file property list
+	) {
+	H5_API_ENTER (h5_err_t, "prop=%p",
+		      (void*)prop);
+        H5_API_RETURN (h5_set_prop_file_attachment_striping (prop));
+}
+
+/**
+  Cache attribute information in memory.
+
+  The names, types and sizes of the attributes of the file, of each
+  step and of each field are read once, when they are first queried.
+  Subsequent queries and reads of small attribute values are served
+  from memory. Writing an attribute to an object discards the cached
+  information of this object.
+
+  Attributes must not be modified by other means while the file is
+  open.
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \see H5GetFileAttribInfo()
+  \see H5GetStepAttribInfo()
+  \see H5BlockGetFieldAttribInfo()
+
+  \note 
+  | Release     | Change                               |
+  | :------     | :-----			       |
+  | \c 2.0.0rc6 | Function introduced in this release. |
+*/
+static inline h5_err_t
+H5SetPropFileAttribCache (
+        h5_prop_t prop			///< [in,out] identifier for file property list
+	) {
+	H5_API_ENTER (h5_err_t, "prop=%p",
+		      (void*)prop);
+        H5_API_RETURN (h5_set_prop_file_attrib_cache (prop));
+}
+
+/**
+  Trace dataset reads and writes.
+
+  For each read or write of a dataset the number of bytes, the time
+  spent in HDF5, the time spent waiting for the throttle token and -
+  for collective I/O - the time spent waiting for the other processes
+  is recorded. The trace is written when the file is closed.
+
+  If \c path contains \c %d, each process writes all records to its
+  own file, \c %d is replaced by the rank of the process. Otherwise
+  the records are summarised per operation and dataset and the first
+  process writes minimum, maximum and mean over all processes. The
+  trace is written in CSV format if \c path ends with \c .csv, in
+  JSON format otherwise.
+
+  Tracing can also be enabled for all files by setting the
+  environment variable \c H5HUT_IO_TRACE to the trace file name.
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \see H5SetPropFileThrottle()
+
+  \note 
+  | Release     | Change                               |
+  | :------     | :-----			       |
+  | \c 2.0.0rc6 | Function introduced in this release. |
+*/
+static inline h5_err_t
+H5SetPropFileIOTrace (
+        h5_prop_t prop,			///< [in,out] identifier for file property list
+	const char* path		///< [in] name of trace file
+	) {
+	H5_API_ENTER (h5_err_t, "prop=%p, path='%s'",
+		      (void*)prop, path);
+        H5_API_RETURN (h5_set_prop_file_io_trace (prop, path));
+}
+
+/**
+  Select the partitioner used to distribute meshes opened in parallel.
+
+  - \c H5_PARTITIONER_PARMETIS: partition the dual graph of the mesh
+    (or of the octree for chunked meshes) with ParMETIS. This is the
+    default.
+  - \c H5_PARTITIONER_SFC: order the elements (or the leaf octants for
+    chunked meshes) along a Morton curve and split the curve into
+    pieces of equal weight.
+
+  The space-filling curve partitioner doesn't call ParMETIS and is
+  deterministic. The partitions have larger interfaces, thus more ghost
+  cells, but the mesh is opened faster. This pays off for restarts.
+
+  The property only takes effect if H5hut has been built with parallel
+  mesh support (\c WITH_PARALLEL_H5GRID), otherwise it is ignored.
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \note
+  | Release     | Change                               |
+  | :------     | :-----			       |
+  | \c 2.0.0rc6 | Function introduced in this release. |
+*/
+static inline h5_err_t
+H5SetPropFileMeshPartitioner (
+        h5_prop_t prop,			///< [in,out] identifier for file property list
+	const h5_int64_t partitioner	///< [in] partitioner
+	) {
+	H5_API_ENTER (h5_err_t, "prop=%p, partitioner=%lld",
+		      (void*)prop, (long long int)partitioner);
+        H5_API_RETURN (h5_set_prop_file_mesh_partitioner (prop, partitioner));
+}
+
 /**
   Close file property list.
 
@@ -277,7 +670,6 @@ H5CloseProp (
   - \c H5_O_WRONLY: create new file, dataset must not exist
   - \c H5_O_APPENDONLY: allows to append new data to an existing file
   - \c H5_O_RDWR:   dataset may exist
-  - \c H5_FS_LUSTRE: enable optimizations for the Lustre file system
   - \c H5_VFD_MPIO_POSIX: use the HDF5 MPI-POSIX virtual file driver
   - \c H5_VFD_MPIO_INDEPENDENT: use MPI-IO in indepedent mode
 
@@ -317,7 +709,6 @@ H5OpenFile2 (
   - \c H5_O_WRONLY: create new file, dataset must not exist
   - \c H5_O_APPENDONLY: allows to append new data to an existing file
   - \c H5_O_RDWR:   dataset may exist
-  - \c H5_FS_LUSTRE - enable optimizations for the Lustre file system
   - \c H5_VFD_MPIO_POSIX - use the HDF5 MPI-POSIX virtual file driver
        (hdf5 <= 1.8.12 only)
   - \c H5_VFD_MPIO_INDEPENDENT - use MPI-IO in indepedent mode
@@ -408,6 +799,59 @@ H5FlushFile (
 	H5_API_RETURN (h5_flush_file (f));
 }
 
+/**
+  Set the memory allocator used by H5hut. All memory allocated by
+  H5hut is allocated via \c allocator->realloc() and released via
+  \c allocator->free(). If \c allocator->size is not \c NULL, it is
+  used to compute the number of bytes in use. Passing \c NULL
+  restores the default allocator, which uses the C library.
+
+  The allocator can only be changed while no memory is allocated by
+  H5hut, that is before the first file is opened.
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \see H5GetAllocStats()
+
+  \note
+  | Release    | Change                               |
+  | :------    | :-----			  	      |
+  | \c 2.0.0rc6 | Function introduced in this release. |
+*/
+static inline h5_err_t
+H5SetAllocator (
+	const h5_allocator_t* allocator	///< [in] allocator or \c NULL
+	) {
+	H5_API_ENTER (h5_err_t, "allocator=%p", allocator);
+	H5_API_RETURN (h5_set_allocator (allocator));
+}
+
+/**
+  Get allocation statistics: number of allocations, reallocations and
+  frees, total number of bytes requested and, if the allocator can
+  tell the size of a block, the number of bytes in use and the peak.
+  The statistics are also written with verbosity level
+  \c H5_VERBOSE_INFO by H5Finalize().
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \see H5SetAllocator()
+
+  \note
+  | Release    | Change                               |
+  | :------    | :-----			  	      |
+  | \c 2.0.0rc6 | Function introduced in this release. |
+*/
+static inline h5_err_t
+H5GetAllocStats (
+	h5_alloc_stats_t* stats		///< [out] statistics
+	) {
+	H5_API_ENTER (h5_err_t, "stats=%p", stats);
+	H5_API_RETURN (h5_get_alloc_stats (stats));
+}
+
 /**
   Close H5hut library. This function should be called before program exit.
 
@@ -470,6 +470,82 @@ H5ReadFileAttribInt32 (
 			H5_INT32_T,
 			(void*)buffer));
 }
+
+/*
+  !   _        _     _           
+  !  | |_ __ _| |__ | | ___  ___ 
+  !  | __/ _` | '_ \| |/ _ \/ __|
+  !  | || (_| | |_) | |  __/\__ \
+  !   \__\__,_|_.__/|_|\___||___/
+ */
+
+/**
+  Write a table of attributes to the file in one pass.
+
+  The table is stored in one compound HDF5 attribute named \c __attribs__,
+  so writing it costs a few HDF5 calls regardless of the number of
+  entries. Entries with the name of an existing attribute replace it.
+  The entries are still accessible as attributes with \ref H5ReadFileAttribFloat64()
+  etc. and are listed by the query functions, but other HDF5 tools see
+  the compound attribute only.
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+
+  \see H5ReadFileAttribs()
+*/
+static inline h5_err_t
+H5WriteFileAttribs (
+	const h5_file_t f,			///< [in]  file handle
+	const h5_attrib_t* const attribs,	///< [in]  attribute table
+	const h5_size_t num_attribs		///< [in]  number of entries
+	) {
+	H5_API_ENTER (h5_err_t,
+                      "f=%p, attribs=%p, num_attribs=%llu",
+                      (h5_file_p)f, attribs, (long long unsigned)num_attribs);
+	H5_API_RETURN (h5_write_file_attribs (f, attribs, num_attribs));
+}
+
+/**
+  Read all attributes attached to the file in one pass.
+
+  On return \c *attribs points to a table with name, type, number of
+  elements and value of each attribute. The table must be released
+  with \ref H5FreeAttribs().
+
+  \return number of attributes on success
+  \return \c H5_FAILURE on error
+
+  \see H5WriteFileAttribs()
+  \see H5FreeAttribs()
+*/
+static inline h5_ssize_t
+H5ReadFileAttribs (
+	const h5_file_t f,			///< [in]  file handle
+	h5_attrib_t** const attribs		///< [out] attribute table
+	) {
+	H5_API_ENTER (h5_ssize_t,
+                      "f=%p, attribs=%p",
+                      (h5_file_p)f, attribs);
+	H5_API_RETURN (h5_read_file_attribs (f, attribs));
+}
+
+/**
+  Release an attribute table returned by \ref H5ReadFileAttribs(),
+  \ref H5ReadStepAttribs() or \ref H5BlockReadFieldAttribs().
+
+  \return \c H5_SUCCESS on success
+  \return \c H5_FAILURE on error
+*/
+static inline h5_err_t
+H5FreeAttribs (
+	h5_attrib_t* const attribs		///< [in]  attribute table
+	) {
+	H5_API_ENTER (h5_err_t,
+                      "attribs=%p",
+                      attribs);
+	H5_API_RETURN (h5_free_attribs (attribs));
+}
 ///< @}
 
 #ifdef __cplusplus
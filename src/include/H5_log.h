@@ -112,6 +112,8 @@ H5GetVerbosityLevel (
   - \c H5_DEBUG_MALLOC:	    memory allocation
   - \c H5_DEBUG_ALL:	    enable all
 
+  The debug mask is set for the calling thread only.
+
   \return \c H5_SUCCESS
 
   \see H5GetDebugMask()
@@ -120,6 +122,7 @@ H5GetVerbosityLevel (
   | Release    | Change                               |
   | :------    | :-----			  	      |
   | \c 1.99.15 | Function introduced in this release. |
+  | \c 2.0.0rc6 | Debug mask is kept per thread.       |
 */
 static inline h5_err_t
 H5SetDebugMask (
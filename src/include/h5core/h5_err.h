@@ -48,7 +48,7 @@ extern "C" {
 
 /** @}*/
 
-extern h5_err_t h5_errno;
+extern H5_THREAD_LOCAL h5_err_t h5_errno;
 
 #define h5_error_not_implemented()				     \
 	h5_error(						     \
@@ -45,10 +45,54 @@ h5_err_t
 h5_set_prop_file_core_vfd (
         h5_prop_t, h5_int64_t);
 
+h5_err_t
+h5_set_prop_file_core_staging (
+        h5_prop_t, const h5_int64_t, const h5_int64_t, const char* const);
+
 h5_err_t
 h5_set_prop_file_flush_after_write (
         h5_prop_t _props);
 
+h5_err_t
+h5_set_prop_file_fs_tuning (
+        h5_prop_t);
+
+h5_err_t
+h5_set_prop_file_collective_metadata (
+        h5_prop_t);
+
+h5_err_t
+h5_set_prop_file_page_buffer (
+        h5_prop_t, const h5_int64_t, const h5_int64_t);
+
+h5_err_t
+h5_set_prop_file_mdc_size (
+        h5_prop_t, const h5_int64_t);
+
+h5_err_t
+h5_set_prop_file_prefetch (
+        h5_prop_t, const h5_int64_t);
+
+h5_err_t
+h5_set_prop_file_attachment_compression (
+        h5_prop_t, const h5_int64_t);
+
+h5_err_t
+h5_set_prop_file_attachment_striping (
+        h5_prop_t);
+
+h5_err_t
+h5_set_prop_file_attrib_cache (
+        h5_prop_t);
+
+h5_err_t
+h5_set_prop_file_io_trace (
+        h5_prop_t, const char* const);
+
+h5_err_t
+h5_set_prop_file_mesh_partitioner (
+        h5_prop_t, const h5_int64_t);
+
 h5_err_t
 h5_close_prop (
         h5_prop_t);
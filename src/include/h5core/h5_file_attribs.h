@@ -45,6 +45,18 @@ h5_write_file_attrib (
 	const h5_file_t, const char* const, const h5_types_t,
 	const void* const, const h5_size_t);
 
+h5_err_t
+h5_write_file_attribs (
+	const h5_file_t, const h5_attrib_t* const, const h5_size_t);
+
+h5_ssize_t
+h5_read_file_attribs (
+	const h5_file_t, h5_attrib_t** const);
+
+h5_err_t
+h5_free_attribs (
+	h5_attrib_t* const);
+
 #ifdef __cplusplus
 }
 #endif
@@ -79,8 +79,8 @@ struct call_stack {
 };
 
 extern h5_int64_t __h5_log_level;
-extern h5_int64_t __h5_debug_mask;
-extern struct call_stack h5_call_stack;
+extern H5_THREAD_LOCAL h5_int64_t __h5_debug_mask;
+extern H5_THREAD_LOCAL struct call_stack h5_call_stack;
 
 #ifdef __cplusplus
 extern "C" {
@@ -90,6 +90,12 @@ extern "C" {
 h5_err_t
 h5_initialize (void);
 
+void
+h5_api_lock (void);
+
+void
+h5_api_unlock (void);
+
 static inline void
 h5_call_stack_push (
         const char* fname,
@@ -211,6 +217,7 @@ h5_get_loglevel (
 #define H5_API_ENTER(type, fmt, ...)					\
 	type ret_value = (type)H5_ERR;					\
 	h5_initialize();						\
+	h5_api_lock ();							\
 	h5_call_stack_reset ();						\
 	h5_call_stack_push (__func__,e_##type);
 
@@ -219,6 +226,7 @@ h5_get_loglevel (
 #define H5_API_ENTER(type, fmt, ...)					\
 	type ret_value = (type)H5_ERR;					\
 	h5_initialize();						\
+	h5_api_lock ();							\
 	h5_call_stack_reset ();						\
 	h5_call_stack_push (__func__,e_##type);				\
 	int __log__ = __h5_debug_mask & H5_DEBUG_API;			\
@@ -269,8 +277,38 @@ done:									\
 //
 //////////////////////////////////////////////////////////////////////////////
 
+//////////////////////////////////////////////////////////////////////////////
+// API function return macro, releases the lock acquired in H5_API_ENTER
+#if defined(NDEBUG)
+
+#define H5_API_RETURN(expr)						\
+	ret_value = expr;						\
+	goto done;							\
+done:									\
+	h5_api_unlock ();						\
+	return ret_value;
+
+#else  // NDEBUG not defined
+
+#define H5_API_RETURN(expr)						\
+	ret_value = expr;						\
+	goto done;							\
+done:									\
+	h5_api_unlock ();						\
+	if (__log__ ) {							\
+		char fmt[256];						\
+		snprintf (fmt, sizeof(fmt), "return: %s",		\
+			  h5_rfmts[h5_call_stack_get_type()]);		\
+		h5_debug (fmt, ret_value);				\
+		h5_call_stack_pop();					\
+	}								\
+	return ret_value;
+
+#endif
+//
+//////////////////////////////////////////////////////////////////////////////
+
 #define H5_API_LEAVE(expr)		H5_LEAVE(expr)
-#define H5_API_RETURN(expr)		H5_RETURN(expr);
 
 
 #define TRY( func )							\
@@ -45,6 +45,14 @@ h5_write_iteration_attrib (
 	const h5_file_t, const char* const, const h5_types_t,
 	const void* const, const h5_size_t);
 
+h5_err_t
+h5_write_iteration_attribs (
+	const h5_file_t, const h5_attrib_t* const, const h5_size_t);
+
+h5_ssize_t
+h5_read_iteration_attribs (
+	const h5_file_t, h5_attrib_t** const);
+
 #ifdef __cplusplus
 }
 #endif
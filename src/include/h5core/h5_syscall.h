@@ -20,6 +20,9 @@ extern "C" {
 	void_p h5_alloc (void* ptr, const size_t size);
 	void_p h5_calloc (const size_t count, const size_t size);
 	char_p h5_strdup (const char* s1);
+	h5_err_t h5_set_allocator (const h5_allocator_t* allocator);
+	h5_err_t h5_get_alloc_stats (h5_alloc_stats_t* stats);
+	h5_err_t h5_report_alloc_stats (void);
 
 #ifdef __cplusplus
 }
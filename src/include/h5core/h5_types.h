@@ -15,6 +15,20 @@
 
 #include <hdf5.h>
 
+/*
+  Storage class for per-thread state like the call stack and the
+  error number.
+ */
+#if defined(__GNUC__)
+#define H5_THREAD_LOCAL __thread
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define H5_THREAD_LOCAL _Thread_local
+#elif defined(_MSC_VER)
+#define H5_THREAD_LOCAL __declspec(thread)
+#else
+#define H5_THREAD_LOCAL
+#endif
+
 #ifndef H5_HAVE_PARALLEL
 /*
   If someone want's to use serial H5hut with MPI, he must include 
@@ -106,6 +120,18 @@ typedef struct h5_complex {
 
 typedef h5_float64_t            h5_coord3d_t[3];
 
+/*
+  Entry of an attribute table, used to write or read a set of attributes
+  with one call. For strings nelem is the size of the string including
+  the terminating null byte.
+ */
+typedef struct h5_attrib {
+	const char* name;		// name of attribute
+	h5_int64_t type;		// H5hut type enumeration (h5_types_t)
+	h5_size_t nelem;		// number of elements
+	const void* value;		// attribute value
+} h5_attrib_t;
+
 struct h5_prop;
 typedef struct h5_prop* h5_prop_p;
 typedef uintptr_t h5_prop_t;
@@ -122,6 +148,33 @@ typedef h5_err_t (*h5_errorhandler_t)(
         const char*,
         va_list ap );
 
+/*
+  Memory allocator used for all allocations done by H5hut. realloc()
+  and free() must behave like their C library counterparts, size()
+  returns the usable size of an allocated block and may be NULL if the
+  allocator cannot tell. All functions get the context pointer ctx as
+  first argument.
+ */
+typedef struct h5_allocator {
+	void* (*realloc)(void* ctx, void* ptr, size_t size);
+	void (*free)(void* ctx, void* ptr);
+	size_t (*size)(void* ctx, void* ptr);
+	void* ctx;
+} h5_allocator_t;
+
+/*
+  Allocation statistics. Bytes in use and the peak are only available
+  if the allocator provides a size() function.
+ */
+typedef struct h5_alloc_stats {
+	h5_int64_t allocs;		// number of allocations
+	h5_int64_t reallocs;		// number of reallocations
+	h5_int64_t frees;		// number of frees
+	h5_int64_t bytes;		// total number of bytes requested
+	h5_int64_t in_use;		// bytes currently allocated
+	h5_int64_t peak;		// maximum of bytes allocated
+} h5_alloc_stats_t;
+
 typedef struct h5_loc_idlist {
 	int32_t size;                   /* allocated space in number of items */
 	int32_t num_items;              /* stored items	*/
@@ -164,4 +217,7 @@ typedef struct h5_idxmap h5_idxmap_t;
 #define H5_PROP_DEFAULT (0)
 #define H5_PROP_FILE    (1)
 
+#define H5_PARTITIONER_PARMETIS	(0)	// partition dual graph with ParMETIS
+#define H5_PARTITIONER_SFC	(1)	// split space-filling curve
+
 #endif
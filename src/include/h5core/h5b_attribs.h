@@ -58,6 +58,16 @@ h5b_read_field_attrib (
 	const h5_file_t,
 	const char*, const char*, const h5_int64_t, void* const);
 
+h5_err_t
+h5b_write_field_attribs (
+	const h5_file_t,
+	const char* const, const h5_attrib_t* const, const h5_size_t);
+
+h5_ssize_t
+h5b_read_field_attribs (
+	const h5_file_t,
+	const char* const, h5_attrib_t** const);
+
 h5_err_t
 h5b_set_3d_field_coords (
         const h5_file_t,
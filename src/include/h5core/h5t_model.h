@@ -113,6 +113,18 @@ h5_err_t
 h5t_close_mesh (
         h5t_mesh_t* const);
 
+h5_err_t
+h5t_set_profile_file (
+        h5t_mesh_t* const, const char* const);
+
+h5_err_t
+h5t_begin_profile (
+        h5t_mesh_t* const, const char* const);
+
+h5_err_t
+h5t_end_profile (
+        h5t_mesh_t* const, const char* const);
+
 #ifdef __cplusplus
 }
 #endif
@@ -24,6 +24,11 @@ h5_loc_id_t
 h5t_store_vertex (
         h5t_mesh_t* const, const h5_glb_id_t, const h5_float64_t[3]);
 
+h5_loc_idx_t
+h5t_store_vertices (
+        h5t_mesh_t* const, const h5_size_t,
+        const h5_glb_idx_t* const, const h5_float64_t* const);
+
 h5_err_t
 h5t_end_store_vertices (
         h5t_mesh_t* const);
@@ -36,6 +41,11 @@ h5_loc_idx_t
 h5t_add_lvl0_cell (
         h5t_mesh_t* const, const h5_loc_idx_t*, const h5_weight_t*);
 
+h5_loc_idx_t
+h5t_add_lvl0_cells (
+        h5t_mesh_t* const, const h5_size_t,
+        const h5_loc_idx_t*, const h5_weight_t*);
+
 h5_err_t
 h5t_end_store_elems (
         h5t_mesh_t* const);
@@ -27,6 +27,15 @@ h5u_write_dataset (
 	const h5_file_t,
 	const char* const, const void* const, const h5_types_t);
 
+h5_ssize_t
+h5u_map_dataset (
+	const h5_file_t,
+	const char* const, const h5_types_t, const void**);
+
+h5_err_t
+h5u_unmap_dataset (
+	const h5_file_t, const void* const);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,114 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+/*
+  Microbenchmark for the cost of the function entry/exit machinery.
+
+  We measure
+  - an empty function with public API entry and return,
+  - an empty function with private entry and return,
+  - h5priv_search_idxmap() on a small map, a typical hot path in the
+    mesh code.
+
+  Build once with default settings and once with NDEBUG or
+  H5_NO_PRIVATE_TRACE defined (cmake -DH5HUT_PRIVATE_TRACE=OFF) and
+  compare the reported time per call.
+
+  Usage: bench_entry [number of calls]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "h5core/h5_log.h"
+#include "private/h5_log.h"
+#include "h5core/h5_syscall.h"
+#include "private/h5_maps.h"
+
+#define NUM_ITEMS	64
+
+static volatile h5_int64_t sink;
+
+static h5_int64_t
+__attribute__ ((noinline))
+api_func (
+	const h5_int64_t i
+	) {
+	H5_API_ENTER (h5_int64_t, "i=%lld", (long long)i);
+	H5_API_RETURN (i);
+}
+
+static h5_int64_t
+__attribute__ ((noinline))
+priv_func (
+	const h5_int64_t i
+	) {
+	H5_PRIV_FUNC_ENTER (h5_int64_t, "i=%lld", (long long)i);
+	H5_RETURN (i);
+}
+
+static double
+now (
+	void
+	) {
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+static void
+report (
+	const char* name,
+	const double t,
+	const long n
+	) {
+	printf ("%-24s %8.2f ns/call\n", name, 1e9 * t / n);
+}
+
+int
+main (
+	int argc,
+	char** argv
+	) {
+	long n = 10000000;
+	if (argc > 1)
+		n = atol (argv[1]);
+
+	h5_initialize ();
+#if defined(NDEBUG)
+	printf ("mode: NDEBUG\n");
+#elif defined(H5_NO_PRIVATE_TRACE)
+	printf ("mode: H5_NO_PRIVATE_TRACE\n");
+#else
+	printf ("mode: debug\n");
+#endif
+	double t = now ();
+	for (long i = 0; i < n; i++)
+		sink = api_func (i);
+	report ("public entry/return", now () - t, n);
+
+	t = now ();
+	for (long i = 0; i < n; i++)
+		sink = priv_func (i);
+	report ("private entry/return", now () - t, n);
+
+	h5_idxmap_t map = {0};
+	if (h5priv_new_idxmap (&map, NUM_ITEMS) < 0)
+		return 1;
+	for (h5_loc_idx_t i = 0; i < NUM_ITEMS; i++)
+		h5priv_insert_idxmap (&map, 2*i, i);
+	t = now ();
+	for (long i = 0; i < n; i++)
+		sink = h5priv_search_idxmap (&map, i % (2*NUM_ITEMS));
+	report ("h5priv_search_idxmap", now () - t, n);
+	h5_free (map.items);
+
+	return 0;
+}
@@ -0,0 +1,175 @@
+/*
+  Copyright (c) 2006-2016, The Regents of the University of California,
+  through Lawrence Berkeley National Laboratory (subject to receipt of any
+  required approvals from the U.S. Dept. of Energy) and the Paul Scherrer
+  Institut (Switzerland).  All rights reserved.
+
+  License: see file COPYING in top level of source distribution.
+*/
+
+#include <stdlib.h>
+#include <H5hut.h>
+
+#include "testframe.h"
+#include "params.h"
+
+#define STAGING_FILENAME	"test_staging.h5"
+#define STAGING_NPARTICLES	1024
+#define STAGING_INCREMENT	(64*1024)
+/* exceeded by the in-memory file after a few steps */
+#define STAGING_MEM_CAP		(64*1024)
+
+static void
+test_write_staged (
+	const h5_int64_t mem_cap
+	) {
+	h5_err_t status;
+	h5_float64_t x[STAGING_NPARTICLES];
+
+	h5_prop_t props = H5CreateFileProp ();
+	status = H5SetPropFileCoreStaging (
+		props, STAGING_INCREMENT, mem_cap, NULL);
+	RETURN(status, H5_SUCCESS, "H5SetPropFileCoreStaging");
+
+	h5_file_t file = H5OpenFile (STAGING_FILENAME, H5_O_WRONLY, props);
+	status = H5CheckFile (file);
+	RETURN(status, H5_SUCCESS, "H5CheckFile");
+
+	status = H5CloseProp (props);
+	RETURN(status, H5_SUCCESS, "H5CloseProp");
+
+	for (int t = 0; t < NTIMESTEPS; t++) {
+		for (int i = 0; i < STAGING_NPARTICLES; i++) {
+			x[i] = (h5_float64_t)(i + STAGING_NPARTICLES*t);
+		}
+		status = H5SetStep (file, t);
+		RETURN(status, H5_SUCCESS, "H5SetStep");
+
+		status = H5PartSetNumParticles (file, STAGING_NPARTICLES);
+		RETURN(status, H5_SUCCESS, "H5PartSetNumParticles");
+
+		status = H5PartWriteDataFloat64 (file, "x", x);
+		RETURN(status, H5_SUCCESS, "H5PartWriteDataFloat64");
+	}
+	status = H5CloseFile (file);
+	RETURN(status, H5_SUCCESS, "H5CloseFile");
+}
+
+static void
+test_read_staged (
+	void
+	) {
+	h5_err_t status;
+	h5_float64_t x[STAGING_NPARTICLES];
+
+	h5_file_t file = H5OpenFile (
+		STAGING_FILENAME, H5_O_RDONLY, H5_PROP_DEFAULT);
+	status = H5CheckFile (file);
+	RETURN(status, H5_SUCCESS, "H5CheckFile");
+
+	h5_int64_t nsteps = H5GetNumSteps (file);
+	IVALUE(nsteps, NTIMESTEPS, "step count");
+
+	for (int t = 0; t < NTIMESTEPS; t++) {
+		status = H5SetStep (file, t);
+		RETURN(status, H5_SUCCESS, "H5SetStep");
+
+		h5_int64_t nparticles = H5PartGetNumParticles (file);
+		IVALUE(nparticles, STAGING_NPARTICLES, "particle count");
+
+		status = H5PartReadDataFloat64 (file, "x", x);
+		RETURN(status, H5_SUCCESS, "H5PartReadDataFloat64");
+
+		for (int i = 0; i < STAGING_NPARTICLES; i++) {
+			FVALUE(x[i], (h5_float64_t)(i + STAGING_NPARTICLES*t),
+			       "x data");
+		}
+	}
+	status = H5CloseFile (file);
+	RETURN(status, H5_SUCCESS, "H5CloseFile");
+}
+
+/*
+  The file images handed to the background writer must not be counted
+  by the H5hut allocator.
+ */
+static void
+test_staging_alloc (
+	void
+	) {
+	h5_err_t status;
+	h5_alloc_stats_t stats;
+
+	TEST("Allocation statistics of staging");
+
+	status = H5SetAllocator (NULL);
+	RETURN(status, H5_SUCCESS, "H5SetAllocator");
+
+	test_write_staged (0);
+
+	status = H5GetAllocStats (&stats);
+	RETURN(status, H5_SUCCESS, "H5GetAllocStats");
+	IVALUE(stats.allocs, stats.frees, "number of frees");
+
+	/* fails if blocks are still allocated */
+	status = H5SetAllocator (NULL);
+	RETURN(status, H5_SUCCESS, "H5SetAllocator");
+}
+
+static void
+test_staging_read (
+	void
+	) {
+	TEST("Reading staged file without memory cap");
+	test_write_staged (0);
+	test_read_staged ();
+}
+
+static void
+test_staging_read_cap (
+	void
+	) {
+	TEST("Reading staged file exceeding memory cap");
+	test_write_staged (STAGING_MEM_CAP);
+	test_read_staged ();
+}
+
+int
+main (
+	int argc,
+	char **argv
+	) {
+#ifdef H5_HAVE_PARALLEL
+	MPI_Init (&argc, &argv);
+#endif
+
+	/* Initialize testing framework */
+	TestInit (argv[0], NULL, NULL);
+
+	AddTest ("alloc", test_staging_alloc, NULL,
+		 "Allocation statistics of staging", NULL);
+	AddTest ("read", test_staging_read, NULL,
+		 "Read staged file", NULL);
+	AddTest ("readcap", test_staging_read_cap, NULL,
+		 "Read staged file exceeding memory cap", NULL);
+
+	/* Display testing information */
+	TestInfo (argv[0]);
+
+	/* Parse command line arguments */
+	TestParseCmdLine (argc, argv);
+
+	H5SetVerbosityLevel (GetTestVerbosity ());
+
+	/* Perform requested testing */
+	PerformTests ();
+
+	/* Display test summary, if requested */
+	if (GetTestSummary ())
+		TestSummary ();
+
+#ifdef H5_HAVE_PARALLEL
+	MPI_Finalize ();
+#endif
+	return GetTestNumErrs ();
+}